@@ -1143,6 +1143,40 @@ Description:
 //#define MULTIPLE_PROBING 2
 //#define EXTRA_PROBING    1
 
+/**
+ * Adaptive Probing
+ *
+ * Instead of a fixed number of probes, keep tapping until the taps agree.
+ * Taps too far from the median are rejected and replaced by another tap.
+ * 'G29 V3' reports the number of taps taken at each point.
+ * Use instead of MULTIPLE_PROBING.
+ */
+//#define ADAPTIVE_PROBING
+#if ENABLED(ADAPTIVE_PROBING)
+  #define ADAPTIVE_PROBING_MIN_TAPS    2     // Good taps needed to finish
+  #define ADAPTIVE_PROBING_MAX_TAPS    6     // Give up and use the good taps so far
+  #define ADAPTIVE_PROBING_STDDEV      0.005 // (mm) Finish when the good taps deviate less than this
+  #define ADAPTIVE_PROBING_OUTLIER     0.025 // (mm) Reject taps farther than this from the median
+#endif
+
+/**
+ * Probe On The Fly
+ *
+ * Speed up G29 grid probing by not stopping, raising and descending at every point.
+ * The probe hovers just above the last trigger height and dives diagonally through
+ * each point, reading the trigger from the step counters. Samples that trigger too
+ * far from the grid point (or not at all) are re-probed the usual way.
+ *
+ * Best with inductive/capacitive probes. A BLTouch needs enough hover height to deploy.
+ * Disable for a single G29 with 'G29 K0'. Multiple probing doesn't apply to flown points.
+ */
+//#define PROBE_ON_THE_FLY
+#if ENABLED(PROBE_ON_THE_FLY)
+  #define PROBE_FLY_HOVER       1.0 // (mm) Height above the last trigger to travel between points
+  #define PROBE_FLY_RUN_UP      2.0 // (mm) XY distance before each point to start the dive
+  #define PROBE_FLY_TOLERANCE   0.5 // (mm) Maximum XY distance from the point to accept a trigger
+#endif
+
 /**
  * Z probes require clearance when deploying, stowing, and moving between
  * probe points to avoid hitting the bed and other hardware.
@@ -1447,6 +1481,13 @@ Description:
     // Default is to maintain the height of the nearest edge.
     //#define EXTRAPOLATE_BEYOND_GRID
 
+    // Add 'G29 U' to update the stored grid for thermal drift. Probe the corners and
+    // center, fit the change to a plane, and re-probe only the quadrants that don't fit.
+    //#define ABL_DRIFT_UPDATE
+    #if ENABLED(ABL_DRIFT_UPDATE)
+      #define ABL_DRIFT_TOLERANCE 0.02 // (mm) Maximum deviation from the plane to skip re-probing
+    #endif
+
     //
     // Experimental Subdivision of the grid by Catmull-Rom method.
     // Synthesizes intermediate points to produce a more detailed mesh.
@@ -1179,6 +1179,50 @@
 
   #define SD_PROCEDURE_DEPTH 1              // Increase if you need more nested M32 calls
 
+  /**
+   * Read the printed file ahead into a ring of block buffers, using
+   * multi-block reads (CMD18) where the file is contiguous on the card.
+   * Commands are taken from the buffers without a call per character.
+   * Each block uses 512 bytes of SRAM. Not recommended for AVR.
+   */
+  //#define SD_READ_AHEAD
+  #if ENABLED(SD_READ_AHEAD)
+    #define SD_READ_AHEAD_BLOCKS 4          // Ring size. Half are refilled at a time. (2-8)
+    // With SDIO on STM32, read each block in the background while the printer
+    // carries on, so serial and LCD don't stall on reads. 'M27 L' reports read times.
+    //#define SD_ASYNC_READ
+  #endif
+
+  // Cache this many card blocks (512 bytes of SRAM each) so FAT, directory, and
+  // file data don't evict each other. Speeds up listing folders and seeking. (1-16)
+  //#define SD_CACHE_BLOCKS 4
+
+  // Send sequential writes (M28, binary file transfer) to the card as one
+  // multi-block write with pre-erase, so the card programs each block while
+  // the next is sent. Files grow by SD_WRITE_PREALLOCATE clusters at a time
+  // so the FAT is written less often. Unused clusters are freed on close.
+  //#define SD_WRITE_STREAM
+  #if ENABLED(SD_WRITE_STREAM)
+    #define SD_WRITE_PREALLOCATE 16         // Clusters to allocate at once (1-255)
+  #endif
+
+  // Map the clusters of the printed file when it's opened, so that resume and
+  // M26 seek without following the FAT chain. A contiguous file is one extent.
+  // Files in more pieces than SD_SEEK_EXTENTS use the normal seek.
+  //#define SD_FAST_SEEK
+  #if ENABLED(SD_FAST_SEEK)
+    #define SD_SEEK_EXTENTS 8               // 8 bytes of SRAM each (1-32)
+  #endif
+
+  // Scan the printed file in the background for the start of each layer,
+  // keeping an index in GINDEX.BIN with the E position and estimated time.
+  // Progress is then shown by estimated time, 'M26 L<layer>' seeks straight
+  // to a layer, and 'M27 I' reports the index.
+  //#define SD_GCODE_INDEX
+  #if ENABLED(SD_GCODE_INDEX)
+    #define SD_GCODE_INDEX_LAYERS 2000      // Layers kept in the index, 32 bytes each on the card (100-10000)
+  #endif
+
   #define SD_FINISHED_STEPPERRELEASE true   // Disable steppers when SD Print is finished
   #define SD_FINISHED_RELEASECOMMAND "M84"  // Use "M84XYE" to keep Z enabled so your bed stays in place
 
@@ -1219,6 +1263,22 @@
     // Without a POWER_LOSS_PIN the following option helps reduce wear on the SD card,
     // especially with "vase mode" printing. Set too high and vases cannot be continued.
     #define POWER_LOSS_MIN_Z_CHANGE 0.05 // (mm) Minimum Z change before saving power-loss data
+
+    // Append small records to a pre-allocated recovery file instead of rewriting
+    // it, so saving every layer or every few seconds costs a single block write.
+    // A full snapshot is written when the journal fills or other state changes.
+    //#define POWER_LOSS_JOURNAL
+    #if ENABLED(POWER_LOSS_JOURNAL)
+      #define POWER_LOSS_JOURNAL_RECORDS 64 // Records between snapshots (8-1024)
+    #endif
+
+    // Keep the recovery data in a ring of sectors on the board's SPI flash
+    // or I2C EEPROM instead of the SD card. Saves are quicker and don't wear
+    // the card, and recovery works when the card is swapped. Choose one:
+    //#define POWER_LOSS_RING_W25QXX    // SPI flash (HAS_SPI_FLASH). Default: the last 16 sectors.
+    //#define POWER_LOSS_RING_BL24CXX   // IIC_BL24CXX_EEPROM. 512-byte sectors, clear of the settings.
+    //#define POWER_LOSS_RING_ADDR    0 // Start address of the ring
+    //#define POWER_LOSS_RING_SECTORS 2 // Number of sectors in the ring (3 or more for W25QXX)
   #endif
 
   /**
@@ -1259,6 +1319,19 @@
                                       // Note: Only affects SCROLL_LONG_FILENAMES with SDSORT_CACHE_NAMES but not SDSORT_DYNAMIC_RAM.
   #endif
 
+  /**
+   * Keep an index of recently browsed folders on the card, in DIRINDEX.BIN,
+   * with long names and the sort order. Menus then count, sort, and list
+   * items without re-reading the folder, and without SDSORT RAM limits.
+   * A folder is checked once per mount, or after a file is written or
+   * deleted, and re-indexed when it has changed.
+   */
+  //#define SD_DIR_INDEX
+  #if ENABLED(SD_DIR_INDEX)
+    #define SD_DIR_INDEX_DIRS    8    // Folders kept in the index (1-16)
+    #define SD_DIR_INDEX_LIMIT 256    // Most items in an indexed folder (16-1024). Sorting uses 2 bytes of SRAM each.
+  #endif
+
   // This allows hosts to request long names for files and folders with M33
   //#define LONG_FILENAME_HOST_SUPPORT
 
@@ -1337,6 +1410,16 @@
 
   // Add an optimized binary file transfer mode, initiated with 'M28 B1'
   //#define BINARY_FILE_TRANSFER
+  #if ENABLED(BINARY_FILE_TRANSFER)
+    /**
+     * Let the host send up to this many packets ahead of the "ok"s (2, 4, or 8).
+     * Packets that arrive after a lost one are kept, so only the lost one is
+     * sent again. Uses MAX_CMD_SIZE bytes of RAM per packet. A larger RX_BUFFER_SIZE
+     * lets more data arrive while a packet is decoded and written.
+     * See buildroot/share/scripts/binary_transfer.py for a host-side sender.
+     */
+    //#define BINARY_STREAM_WINDOW 4
+  #endif
 
   /**
    * Set this option to one of the following (or the board's defaults apply):
@@ -1913,6 +1996,19 @@
 #define MAX_CMD_SIZE 96
 #define BUFSIZE 4
 
+/**
+ * Packed Command Queue
+ *
+ * Store queued commands end-to-end in a ring of COMMAND_QUEUE_BYTES instead
+ * of BUFSIZE fixed slots of MAX_CMD_SIZE. Most commands are 20-30 bytes long,
+ * so BUFSIZE can be raised 3-4x using the same amount of RAM.
+ * With ADVANCED_OK the reported free slots (B) assume full-length commands.
+ */
+//#define PACKED_COMMAND_QUEUE
+#if ENABLED(PACKED_COMMAND_QUEUE)
+  #define COMMAND_QUEUE_BYTES 384   // (bytes) At least 2 * MAX_CMD_SIZE
+#endif
+
 // Transmission to Host Buffer Size
 // To save 386 bytes of PROGMEM (and TX_BUFFER_SIZE+3 bytes of RAM) set to 0.
 // To buffer a simple "ok" you need 4 bytes.
@@ -1922,6 +2018,12 @@
 // :[0, 2, 4, 8, 16, 32, 64, 128, 256]
 #define TX_BUFFER_SIZE 0
 
+// Hold back periodic reports (auto-reported temperatures and SD status, "busy"
+// messages) while the TX buffer is fuller than this percentage, instead of
+// waiting in loop() for room. Each report goes out once the host catches up.
+// Requires TX_BUFFER_SIZE on AVR, or SERIAL_DMA on STM32F1.
+//#define SERIAL_TX_DEFER_PERCENT 50
+
 // Host Receive Buffer Size
 // Without XON/XOFF flow control (see SERIAL_XON_XOFF below) 32 bytes should be enough.
 // To use flow control, set this buffer size to at least 1024 bytes.
@@ -1937,6 +2039,19 @@
 // Add M575 G-code to change the baud rate
 //#define BAUD_RATE_GCODE
 
+/**
+ * Serial DMA (STM32F1)
+ *
+ * Receive into a circular RX_BUFFER_SIZE buffer by DMA instead of taking an
+ * interrupt for every byte, and send output by DMA from a 128 byte buffer.
+ * The UART only interrupts when the line goes idle. Applies to the host and
+ * LCD ports. UART5 has no DMA and keeps using interrupts.
+ *
+ * NOTE: USART1 shares DMA1 channels 4-5 with SPI2 and USART3 shares
+ *       channels 2-3 with SPI1. Don't use those pairs together.
+ */
+//#define SERIAL_DMA
+
 #if ENABLED(SDSUPPORT)
   // Enable this option to collect and display the maximum
   // RX queue usage after transferring a file to SD.
@@ -1966,6 +2081,49 @@
 // Some clients will have this feature soon. This could make the NO_TIMEOUTS unnecessary.
 //#define ADVANCED_OK
 
+/**
+ * Credit Flow Control
+ *
+ * After 'M577 S1' the host may stream lines without waiting for an "ok" per line.
+ * The firmware reports the window with 'window:<bytes>' and returns every byte it
+ * reads from the port with 'credit:<bytes>'. The host keeps (sent - credited) bytes
+ * within the window. Lines with errors still get 'Resend:'. Other "ok"s are ignored.
+ * See buildroot/share/scripts/serial_credit_sim.py for a host-side model.
+ */
+//#define CREDIT_FLOW_CONTROL
+#if ENABLED(CREDIT_FLOW_CONTROL)
+  #define CREDIT_WINDOW 127   // (bytes) Less than RX_BUFFER_SIZE on a hardware serial port
+#endif
+
+/**
+ * Serial Port Weights
+ *
+ * With two serial ports, limit how much of the command buffer each one may
+ * fill, so a port that polls often (e.g., a WiFi bridge or panel sending M105)
+ * can't crowd out the print host. Each port gets a share of BUFSIZE by weight.
+ * A port over its share isn't read until one of its commands has run.
+ */
+//#define SERIAL_PORT_WEIGHTS { 3, 1 }  // SERIAL_PORT, SERIAL_PORT_2
+
+/**
+ * Answer status queries (M105, M27, M31) as soon as they are received,
+ * without waiting behind moves. The reply may come before earlier commands
+ * have run, but the "ok" still takes a slot in the command buffer and goes
+ * out after theirs, with the ADVANCED_OK fields.
+ * Requires FASTER_GCODE_PARSER.
+ */
+//#define STATUS_QUERY_ASAP
+
+/**
+ * Binary G-code
+ *
+ * Accept compact binary frames (opcode, parameter mask, fixed-point values, CRC16)
+ * from serial and from SD files, in place of text lines. Each frame is expanded into
+ * a normal G-code line as it arrives. Typical G1 moves take 30-40% fewer bytes.
+ * Use buildroot/share/scripts/gcode_to_binary.py to encode files or lines.
+ */
+//#define BINARY_GCODE
+
 // Printrun may have trouble receiving long strings all at once.
 // This option inserts short delays between lines of serial output.
 #define SERIAL_OVERRUN_PROTECTION
@@ -3192,10 +3350,17 @@
 
 #if ENABLED(FASTER_GCODE_PARSER)
   //#define GCODE_QUOTED_STRINGS  // Support for quoted string parameters
+  //#define PREPARSED_GCODE_VALUES  // Convert numbers once per command, not on every value_float() (112 bytes SRAM)
+  //#define GCODE_PARSE_AHEAD       // Parse the next command while waiting for the planner. M576 reports buffer stats.
 #endif
 
 //#define GCODE_CASE_INSENSITIVE  // Accept G-code sent to the firmware in lowercase
 
+//#define GCODE_DISPATCH_TABLE    // Look up G and M codes in a sorted table instead of a switch
+#if ENABLED(GCODE_DISPATCH_TABLE)
+  //#define GCODE_DISPATCH_STATS  // Count the calls and time of each G and M code. M578 reports them. (8 bytes SRAM per code)
+#endif
+
 //#define REPETIER_GCODE_M360     // Add commands originally from Repetier FW
 
 /**
@@ -3224,12 +3389,25 @@
  * G-code Macros
  *
  * Add G-codes M810-M819 to define and run G-code macros.
- * Macros are not saved to EEPROM.
+ * Macros are not saved to EEPROM unless GCODE_MACROS_IN_EEPROM is enabled.
  */
 //#define GCODE_MACROS
 #if ENABLED(GCODE_MACROS)
   #define GCODE_MACROS_SLOTS       5  // Up to 10 may be used
   #define GCODE_MACROS_SLOT_SIZE  50  // Maximum length of a single macro
+
+  /**
+   * Parse each macro once, when it is set, and keep its commands in parsed form.
+   * Running the macro then skips the text parser. Uses about twice the SRAM
+   * of the macro text plus GCODE_MACROS_COMPILED_SIZE bytes per slot.
+   * Requires FASTER_GCODE_PARSER. Best with PREPARSED_GCODE_VALUES.
+   */
+  //#define GCODE_MACROS_PRECOMPILE
+  #if ENABLED(GCODE_MACROS_PRECOMPILE)
+    #define GCODE_MACROS_COMPILED_SIZE 100  // Bytes per slot. About 10 per command, +1 per parameter, +4 per value.
+  #endif
+
+  //#define GCODE_MACROS_IN_EEPROM          // Save macros with M500 and report them with M503. Requires EEPROM_SETTINGS.
 #endif
 
 /**
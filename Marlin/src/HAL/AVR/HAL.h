@@ -88,6 +88,10 @@ typedef int8_t pin_t;
     #error "SERIAL_PORT must be from -1 to 3. Please update your configuration."
   #endif
   #define MYSERIAL0 customizedSerial1
+  #if defined(SERIAL_TX_DEFER_PERCENT) && TX_BUFFER_SIZE > 0
+    #define SERIAL_TX_QUEUED() MYSERIAL0.tx_queued()
+    #define SERIAL_TX_CAPACITY TX_BUFFER_SIZE
+  #endif
 
   #ifdef SERIAL_PORT_2
     #if !WITHIN(SERIAL_PORT_2, -1, 3)
@@ -220,6 +220,9 @@
       #if HAS_DGUS_LCD
         static ring_buffer_pos_t get_tx_buffer_free();
       #endif
+      #ifdef SERIAL_TX_DEFER_PERCENT
+        FORCE_INLINE static uint8_t tx_queued() { return (tx_buffer.head - tx_buffer.tail) & (Cfg::TX_SIZE - 1); }
+      #endif
 
       static inline bool emergency_parser_enabled() { return Cfg::EMERGENCYPARSER; }
 
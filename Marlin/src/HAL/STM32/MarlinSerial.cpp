@@ -56,7 +56,9 @@
 void MarlinSerial::begin(unsigned long baud, uint8_t config) {
   HardwareSerial::begin(baud, config);
   // Replace the IRQ callback with the one we have defined
-  TERN_(EMERGENCY_PARSER, _serial.rx_callback = _rx_callback);
+  #if ANY(EMERGENCY_PARSER, SERIAL_STATS_DROPPED_RX, SERIAL_STATS_MAX_RX_QUEUED)
+    _serial.rx_callback = _rx_callback;
+  #endif
 }
 
 // This function is Copyright (c) 2006 Nicholas Zambetti.
@@ -76,6 +78,14 @@ void MarlinSerial::_rx_complete_irq(serial_t *obj) {
       obj->rx_buff[obj->rx_head] = c;
       obj->rx_head = i;
     }
+    #if ENABLED(SERIAL_STATS_DROPPED_RX)
+      else
+        rx_dropped_bytes++;
+    #endif
+
+    #if ENABLED(SERIAL_STATS_MAX_RX_QUEUED)
+      NOLESS(rx_max_enqueued, rx_buffer_index_t((obj->rx_head - obj->rx_tail + SERIAL_RX_BUFFER_SIZE) % SERIAL_RX_BUFFER_SIZE));
+    #endif
 
     #if ENABLED(EMERGENCY_PARSER)
       emergency_parser.update(emergency_state, c);
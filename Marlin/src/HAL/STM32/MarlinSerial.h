@@ -44,6 +44,16 @@ public:
 
   void _rx_complete_irq(serial_t* obj);
 
+  #if ENABLED(SERIAL_STATS_DROPPED_RX)
+    uint32_t rx_dropped_bytes = 0;
+    inline uint32_t dropped() { return rx_dropped_bytes; }
+  #endif
+
+  #if ENABLED(SERIAL_STATS_MAX_RX_QUEUED)
+    rx_buffer_index_t rx_max_enqueued = 0;
+    inline rx_buffer_index_t rxMaxEnqueued() { return rx_max_enqueued; }
+  #endif
+
 protected:
   usart_rx_callback_t _rx_callback;
   #if ENABLED(EMERGENCY_PARSER)
@@ -54,6 +54,13 @@
     return (bool) status;
   }
 
+  #if ENABLED(SD_ASYNC_READ)
+    // The USB mass storage driver owns the card, so read it right away
+    static bool async_status;
+    bool SDIO_ReadStart(uint32_t block, uint8_t *dst) { async_status = SDIO_ReadBlock(block, dst); return true; }
+    int8_t SDIO_ReadDone() { return async_status ? 1 : -1; }
+  #endif
+
 #else // !USBD_USE_CDC_COMPOSITE
 
   // use local drivers
@@ -169,6 +176,61 @@
 
   constexpr uint8_t SD_RETRY_COUNT = TERN(SD_CHECK_AND_RETRY, 3, 1);
 
+  #if ENABLED(SD_ASYNC_READ)
+
+    /**
+     * Background read. The SDIO interrupt empties the FIFO while the caller
+     * carries on, and the HAL callbacks set the state when the block is in.
+     * Blocking reads and writes finish it first, as the card is busy.
+     */
+    #ifdef STM32F7xx
+      #define SD_ASYNC_IRQn       SDMMC1_IRQn
+      #define SD_ASYNC_IRQHandler SDMMC1_IRQHandler
+    #else
+      #define SD_ASYNC_IRQn       SDIO_IRQn
+      #define SD_ASYNC_IRQHandler SDIO_IRQHandler
+    #endif
+
+    // Below the stepper ISR (2), which must not be held up ~16 times per block.
+    // A FIFO overrun while it runs fails the read, which is then retried.
+    #ifndef SDIO_IRQ_PRIO
+      #define SDIO_IRQ_PRIO 3
+    #endif
+
+    enum AsyncState : uint8_t { ASYNC_IDLE, ASYNC_BUSY, ASYNC_DONE, ASYNC_FAILED };
+    static volatile AsyncState async_state;
+    static uint32_t async_block;
+    static uint8_t *async_data;
+    static uint8_t async_retries;
+    static millis_t async_timeout;
+
+    extern "C" void SD_ASYNC_IRQHandler() { HAL_SD_IRQHandler(&hsd); }
+
+    void HAL_SD_RxCpltCallback(SD_HandleTypeDef *hsd) { UNUSED(hsd); async_state = ASYNC_DONE; }
+    void HAL_SD_ErrorCallback(SD_HandleTypeDef *hsd) { UNUSED(hsd); async_state = ASYNC_FAILED; }
+
+    static void async_start() {
+      while (async_retries) {
+        async_retries--;
+        async_state = ASYNC_BUSY;
+        async_timeout = millis() + 500;
+        if (HAL_SD_ReadBlocks_IT(&hsd, async_data, async_block, 1) == HAL_OK) return;
+      }
+      async_state = ASYNC_FAILED;
+    }
+
+    static void async_check() {
+      if (async_state == ASYNC_BUSY && ELAPSED(millis(), async_timeout)) {
+        HAL_SD_Abort(&hsd);
+        async_state = ASYNC_FAILED;
+      }
+      if (async_state == ASYNC_FAILED && async_retries) async_start();
+    }
+
+    static void async_finish() { while (async_state == ASYNC_BUSY) async_check(); }
+
+  #endif // SD_ASYNC_READ
+
   bool SDIO_Init() {
     //init SDIO and get SD card info
 
@@ -187,6 +249,8 @@
     hsd.Init.ClockDiv = 8;
     */
 
+    TERN_(SD_ASYNC_READ, async_state = ASYNC_IDLE);
+
     SD_LowLevel_Init();
 
     uint8_t retry_Cnt = retryCnt;
@@ -219,6 +283,11 @@
       }
     #endif
 
+    #if ENABLED(SD_ASYNC_READ)
+      HAL_NVIC_SetPriority(SD_ASYNC_IRQn, SDIO_IRQ_PRIO, 0);
+      HAL_NVIC_EnableIRQ(SD_ASYNC_IRQn);
+    #endif
+
     return true;
   }
   /*
@@ -256,6 +325,7 @@
   //bool SDIO_Init_C() { return (bool) (SD_SDIO_Init() ? 1 : 0);}
 
   bool SDIO_ReadBlock(uint32_t block, uint8_t *dst) {
+    TERN_(SD_ASYNC_READ, async_finish());
     hsd.Instance = SDIO;
     uint8_t retryCnt = SD_RETRY_COUNT;
 
@@ -305,6 +375,7 @@
   }
 
   bool SDIO_WriteBlock(uint32_t block, const uint8_t *src) {
+    TERN_(SD_ASYNC_READ, async_finish());
     hsd.Instance = SDIO;
     uint8_t retryCnt = SD_RETRY_COUNT;
     bool status;
@@ -317,5 +388,28 @@
     return status;
   }
 
+  #if ENABLED(SD_ASYNC_READ)
+
+    bool SDIO_ReadStart(uint32_t block, uint8_t *dst) {
+      async_finish();
+      hsd.Instance = SDIO;
+      async_block = block;
+      async_data = dst;
+      async_retries = SD_RETRY_COUNT;
+      async_start();
+      return async_state == ASYNC_BUSY;
+    }
+
+    int8_t SDIO_ReadDone() {
+      async_check();
+      switch (async_state) {
+        case ASYNC_BUSY: return 0;
+        case ASYNC_FAILED: async_state = ASYNC_IDLE; return -1;
+        default: async_state = ASYNC_IDLE; return 1;
+      }
+    }
+
+  #endif // SD_ASYNC_READ
+
 #endif // !USBD_USE_CDC_COMPOSITE
 #endif // SDIO_SUPPORT
@@ -81,6 +81,10 @@
   #define MYSERIAL0 UsbSerial
 #elif WITHIN(SERIAL_PORT, 1, NUM_UARTS)
   #define MYSERIAL0 MSERIAL(SERIAL_PORT)
+  #if defined(SERIAL_TX_DEFER_PERCENT) && ENABLED(SERIAL_DMA)
+    #define SERIAL_TX_QUEUED() MYSERIAL0.tx_queued()
+    #define SERIAL_TX_CAPACITY SERIAL_DMA_TX_SIZE
+  #endif
 #elif NUM_UARTS == 5
   #error "SERIAL_PORT must be -1 or from 1 to 5. Please update your configuration."
 #else
@@ -44,6 +44,9 @@ static inline __always_inline void my_usart_irq(ring_buffer *rb, ring_buffer *wb
     }
     else {
       uint8_t c = (uint8)regs->DR;
+      #if ENABLED(SERIAL_STATS_DROPPED_RX)
+        if (rb_is_full(rb)) serial.rx_dropped_bytes++;
+      #endif
       #ifdef USART_SAFE_INSERT
         // If the buffer is full and the user defines USART_SAFE_INSERT,
         // ignore new bytes.
@@ -52,6 +55,9 @@ static inline __always_inline void my_usart_irq(ring_buffer *rb, ring_buffer *wb
         // By default, push bytes around in the ring buffer.
         rb_push_insert(rb, c);
       #endif
+      #if ENABLED(SERIAL_STATS_MAX_RX_QUEUED)
+        NOLESS(serial.rx_max_enqueued, rb_full_count(rb));
+      #endif
       #if ENABLED(EMERGENCY_PARSER)
         if (serial.emergency_parser_enabled())
           emergency_parser.update(serial.emergency_state, c);
@@ -65,6 +71,14 @@ static inline __always_inline void my_usart_irq(ring_buffer *rb, ring_buffer *wb
     regs->DR;
   }
 
+  #if ENABLED(SERIAL_DMA)
+    // IDLE signifies a gap after received bytes. Reading DR clears it.
+    if ((cr1its & USART_CR1_IDLEIE) && (srflags & USART_SR_IDLE)) {
+      regs->DR;
+      serial.dma_rx_irq();
+    }
+  #endif
+
   // TXE signifies readiness to send a byte to DR.
   if ((cr1its & USART_CR1_TXEIE) && (srflags & USART_SR_TXE)) {
     if (!rb_is_empty(wb))
@@ -90,20 +104,57 @@ constexpr bool serial_handles_emergency(int port) {
   ;
 }
 
+#if ENABLED(SERIAL_DMA)
+
+  // Only the host and LCD ports get DMA buffers
+  #define serial_uses_dma serial_handles_emergency
+
+  // UART DMA requests, from RM0008 tables 78 and 79. UART5 has none.
+  #define DEFINE_SERIAL_DMA(n, ON_DMA2, RXCH, TXCH, RX_NVIC) \
+    static uint8_t serial_dma_buffer##n[serial_uses_dma(n) ? (RX_BUFFER_SIZE) + SERIAL_DMA_TX_SIZE : 1]; \
+    static void serial_dma_rx_irq##n(); \
+    static void serial_dma_tx_irq##n(); \
+    static const serial_dma_t serial_dma##n = { serial_dma_buffer##n, ON_DMA2, DMA_CH##RXCH, DMA_CH##TXCH, RX_NVIC, serial_dma_rx_irq##n, serial_dma_tx_irq##n };
+
+  #define DEFINE_SERIAL_DMA_IRQS(n) \
+    static void serial_dma_rx_irq##n() { MSerial##n.dma_rx_irq(); } \
+    static void serial_dma_tx_irq##n() { MSerial##n.dma_tx_irq(); }
+
+  DEFINE_SERIAL_DMA(1, false, 5, 4, NVIC_DMA_CH5)
+  DEFINE_SERIAL_DMA(2, false, 6, 7, NVIC_DMA_CH6)
+  DEFINE_SERIAL_DMA(3, false, 3, 2, NVIC_DMA_CH3)
+  #if EITHER(STM32_HIGH_DENSITY, STM32_XL_DENSITY)
+    DEFINE_SERIAL_DMA(4, true, 3, 5, NVIC_DMA2_CH3)
+  #endif
+
+  #define SERIAL_DMA_ARG(n) , serial_uses_dma(n) ? &serial_dma##n : nullptr
+  #define SERIAL_NO_DMA_ARG , nullptr
+
+#else
+
+  #define DEFINE_SERIAL_DMA_IRQS(n)
+  #define SERIAL_DMA_ARG(n)
+  #define SERIAL_NO_DMA_ARG
+
+#endif
+
 #define DEFINE_HWSERIAL_MARLIN(name, n)   \
   MarlinSerial name(USART##n,             \
             BOARD_USART##n##_TX_PIN,      \
             BOARD_USART##n##_RX_PIN,      \
-            serial_handles_emergency(n)); \
+            serial_handles_emergency(n)   \
+            SERIAL_DMA_ARG(n));           \
   extern "C" void __irq_usart##n(void) {  \
     my_usart_irq(USART##n->rb, USART##n->wb, USART##n##_BASE, MSerial##n); \
-  }
+  }                                       \
+  DEFINE_SERIAL_DMA_IRQS(n)
 
-#define DEFINE_HWSERIAL_UART_MARLIN(name, n) \
+#define DEFINE_HWSERIAL_UART_MARLIN(name, n, DMA_ARG) \
   MarlinSerial name(UART##n,                 \
           BOARD_USART##n##_TX_PIN,           \
           BOARD_USART##n##_RX_PIN,           \
-          serial_handles_emergency(n));      \
+          serial_handles_emergency(n)        \
+          DMA_ARG);                          \
   extern "C" void __irq_usart##n(void) {     \
     my_usart_irq(UART##n->rb, UART##n->wb, UART##n##_BASE, MSerial##n); \
   }
@@ -115,10 +166,138 @@ DEFINE_HWSERIAL_MARLIN(MSerial1, 1);
 DEFINE_HWSERIAL_MARLIN(MSerial2, 2);
 DEFINE_HWSERIAL_MARLIN(MSerial3, 3);
 #if EITHER(STM32_HIGH_DENSITY, STM32_XL_DENSITY)
-  DEFINE_HWSERIAL_UART_MARLIN(MSerial4, 4);
-  DEFINE_HWSERIAL_UART_MARLIN(MSerial5, 5);
+  DEFINE_HWSERIAL_UART_MARLIN(MSerial4, 4, SERIAL_DMA_ARG(4));
+  DEFINE_SERIAL_DMA_IRQS(4)
+  DEFINE_HWSERIAL_UART_MARLIN(MSerial5, 5, SERIAL_NO_DMA_ARG);
 #endif
 
+#if ENABLED(SERIAL_DMA)
+
+void MarlinSerial::dma_begin() {
+  usart_reg_map * const regs = c_dev()->regs;
+  dma_device = dma->on_dma2 ? DMA2 : DMA1;
+  dma_init(dma_device);
+
+  // Receive into the circular buffer. The half and full interrupts make sure
+  // every byte is seen by the emergency parser before it can be overwritten.
+  dma_disable(dma_device, dma->rx);
+  dma_setup_transfer(dma_device, dma->rx, &regs->DR, DMA_SIZE_8BITS, dma->buffer, DMA_SIZE_8BITS,
+                     DMA_MINC_MODE | DMA_CIRC_MODE | DMA_HALF_TRNS | DMA_TRNS_CMPLT);
+  dma_set_num_transfers(dma_device, dma->rx, RX_BUFFER_SIZE);
+  dma_set_priority(dma_device, dma->rx, DMA_PRIORITY_HIGH);
+  dma_attach_interrupt(dma_device, dma->rx, dma->rx_irq);
+  nvic_irq_set_priority(dma->rx_nvic, UART_IRQ_PRIO); // Same as the idle-line IRQ so neither preempts the other
+
+  // Transmit from the TX ring, one contiguous run at a time
+  dma_disable(dma_device, dma->tx);
+  dma_setup_transfer(dma_device, dma->tx, &regs->DR, DMA_SIZE_8BITS, tx_buffer(), DMA_SIZE_8BITS,
+                     DMA_MINC_MODE | DMA_FROM_MEM | DMA_TRNS_CMPLT);
+  dma_set_priority(dma_device, dma->tx, DMA_PRIORITY_LOW);
+  dma_attach_interrupt(dma_device, dma->tx, dma->tx_irq);
+
+  rx_tail = rx_scanned = 0;
+  tx_head = tx_tail = tx_len = 0;
+  rx_overrun = false;
+  dma_enable(dma_device, dma->rx);
+
+  // The DMA takes the bytes, so the UART only interrupts on an idle line
+  regs->CR1 = (regs->CR1 & ~(USART_CR1_RXNEIE | USART_CR1_TXEIE)) | USART_CR1_IDLEIE;
+  regs->CR3 |= USART_CR3_DMAR | USART_CR3_DMAT;
+}
+
+// Called from the UART idle-line and the DMA half / complete interrupts.
+// Bytes are only handed to the reader once they've been scanned here, so
+// rx_tail never passes rx_scanned and the unread count below is exact.
+void MarlinSerial::dma_rx_irq() {
+  constexpr uint16_t mask = (RX_BUFFER_SIZE) - 1;
+  const uint16_t head = rx_head(), scanned = rx_scanned,
+                 unread = ((scanned - rx_tail) & mask) + ((head - scanned) & mask);
+
+  #if ENABLED(EMERGENCY_PARSER)
+    if (emergency_parser_enabled())
+      for (uint16_t i = scanned; i != head; i = (i + 1) & mask)
+        emergency_parser.update(emergency_state, dma->buffer[i]);
+  #endif
+
+  // New bytes have overwritten unread ones. The reader will discard the buffer.
+  if (unread > mask) {
+    rx_overrun = true;
+    TERN_(SERIAL_STATS_DROPPED_RX, rx_dropped_bytes += unread - mask);
+  }
+  #if ENABLED(SERIAL_STATS_MAX_RX_QUEUED)
+    else NOLESS(rx_max_enqueued, unread);
+  #endif
+
+  rx_scanned = head;
+}
+
+int MarlinSerial::available() {
+  if (!dma) return HardwareSerial::available();
+  if (rx_overrun) {
+    rx_overrun = false;
+    rx_tail = rx_scanned;
+  }
+  return (rx_scanned - rx_tail) & ((RX_BUFFER_SIZE) - 1);
+}
+
+int MarlinSerial::peek() {
+  if (!dma) return HardwareSerial::peek();
+  return available() ? dma->buffer[rx_tail] : -1;
+}
+
+int MarlinSerial::read() {
+  if (!dma) return HardwareSerial::read();
+  if (!available()) return -1;
+  const uint8_t c = dma->buffer[rx_tail];
+  rx_tail = (rx_tail + 1) & ((RX_BUFFER_SIZE) - 1);
+  return c;
+}
+
+// Start sending the next contiguous run of the TX ring. Call with the TX IRQ blocked.
+void MarlinSerial::tx_start() {
+  const uint16_t head = tx_head, tail = tx_tail;
+  tx_len = (head >= tail ? head : SERIAL_DMA_TX_SIZE) - tail;
+  if (!tx_len) return;
+  dma_disable(dma_device, dma->tx);
+  dma_set_mem_addr(dma_device, dma->tx, tx_buffer() + tail);
+  dma_set_num_transfers(dma_device, dma->tx, tx_len);
+  dma_enable(dma_device, dma->tx);
+}
+
+void MarlinSerial::dma_tx_irq() {
+  tx_tail = (tx_tail + tx_len) & (SERIAL_DMA_TX_SIZE - 1);
+  tx_start();
+}
+
+// Called while waiting on the TX ring. With interrupts
+// disabled (e.g., kill) finish the transfer by polling.
+void MarlinSerial::tx_poll() {
+  if (!ISRS_ENABLED() && (dma_get_isr_bits(dma_device, dma->tx) & DMA_ISR_TCIF1)) {
+    dma_clear_isr_bits(dma_device, dma->tx);
+    dma_tx_irq();
+  }
+}
+
+size_t MarlinSerial::write(uint8_t c) {
+  if (!dma) return HardwareSerial::write(c);
+  const uint16_t next = (tx_head + 1) & (SERIAL_DMA_TX_SIZE - 1);
+  while (next == tx_tail) tx_poll();
+  tx_buffer()[tx_head] = c;
+  CRITICAL_SECTION_START();
+  tx_head = next;
+  if (!tx_len) tx_start();
+  CRITICAL_SECTION_END();
+  return 1;
+}
+
+void MarlinSerial::flush() {
+  if (!dma) return HardwareSerial::flush();
+  while (tx_tail != tx_head) tx_poll();
+  while (!(c_dev()->regs->SR & USART_SR_TC)) { /* last byte out */ }
+}
+
+#endif // SERIAL_DMA
+
 // Check the type of each serial port by passing it to a template function.
 // HardwareSerial is known to sometimes hang the controller when an error occurs,
 // so this case will fail the static assert. All other classes are assumed to be ok.
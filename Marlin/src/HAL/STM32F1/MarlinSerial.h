@@ -29,10 +29,26 @@
 #if ENABLED(EMERGENCY_PARSER)
   #include "../../feature/e_parser.h"
 #endif
+#if ENABLED(SERIAL_DMA)
+  #include <libmaple/dma.h>
+#endif
 
 // Increase priority of serial interrupts, to reduce overflow errors
 #define UART_IRQ_PRIO 1
 
+#if ENABLED(SERIAL_DMA)
+  #define SERIAL_DMA_TX_SIZE 128  // Power of 2
+
+  // DMA channels and buffer of one UART
+  typedef struct {
+    uint8_t *buffer;              // RX_BUFFER_SIZE bytes of RX ring, then SERIAL_DMA_TX_SIZE of TX ring
+    bool on_dma2;
+    dma_channel rx, tx;
+    nvic_irq_num rx_nvic;
+    voidFuncPtr rx_irq, tx_irq;
+  } serial_dma_t;
+#endif
+
 class MarlinSerial : public HardwareSerial {
 public:
   #if ENABLED(EMERGENCY_PARSER)
@@ -41,12 +57,29 @@ public:
     inline bool emergency_parser_enabled() { return ep_enabled; }
   #endif
 
-  MarlinSerial(struct usart_dev *usart_device, uint8 tx_pin, uint8 rx_pin, bool TERN_(EMERGENCY_PARSER, ep_capable)) :
+  #if ENABLED(SERIAL_STATS_DROPPED_RX)
+    uint32_t rx_dropped_bytes = 0;
+    inline uint32_t dropped() { return rx_dropped_bytes; }
+  #endif
+
+  #if ENABLED(SERIAL_STATS_MAX_RX_QUEUED)
+    uint16_t rx_max_enqueued = 0;
+    inline uint16_t rxMaxEnqueued() { return rx_max_enqueued; }
+  #endif
+
+  MarlinSerial(struct usart_dev *usart_device, uint8 tx_pin, uint8 rx_pin, bool TERN_(EMERGENCY_PARSER, ep_capable)
+    #if ENABLED(SERIAL_DMA)
+      , const serial_dma_t *dma_config
+    #endif
+  ) :
     HardwareSerial(usart_device, tx_pin, rx_pin)
     #if ENABLED(EMERGENCY_PARSER)
       , ep_enabled(ep_capable)
       , emergency_state(EmergencyParser::State::EP_RESET)
     #endif
+    #if ENABLED(SERIAL_DMA)
+      , dma(dma_config)
+    #endif
     { }
 
   #ifdef UART_IRQ_PRIO
@@ -58,8 +91,38 @@ public:
     void begin(uint32 baud, uint8_t config) {
       HardwareSerial::begin(baud, config);
       nvic_irq_set_priority(c_dev()->irq_num, UART_IRQ_PRIO);
+      TERN_(SERIAL_DMA, if (dma) dma_begin());
     }
   #endif
+
+  #if ENABLED(SERIAL_DMA)
+    // With DMA the UART fills a circular buffer on its own and only
+    // interrupts when the line goes idle, or the buffer is half or all full.
+    int available() override;
+    int peek() override;
+    int read() override;
+    size_t write(uint8_t c) override;
+    using Print::write;
+    void flush() override;
+
+    void dma_rx_irq();
+    void dma_tx_irq();
+
+    // Bytes waiting to be sent
+    inline uint16_t tx_queued() { return dma ? (tx_head - tx_tail) & (SERIAL_DMA_TX_SIZE - 1) : 0; }
+
+  private:
+    const serial_dma_t * const dma;   // nullptr for an interrupt per byte
+    dma_dev *dma_device;
+    volatile uint16_t rx_tail, rx_scanned, tx_head, tx_tail, tx_len;
+    volatile bool rx_overrun;
+
+    void dma_begin();
+    void tx_start();
+    void tx_poll();
+    inline uint16_t rx_head() { return (RX_BUFFER_SIZE - dma_get_count(dma_device, dma->rx)) & (RX_BUFFER_SIZE - 1); }
+    inline uint8_t* tx_buffer() { return dma->buffer + RX_BUFFER_SIZE; }
+  #endif
 };
 
 extern MarlinSerial MSerial1;
@@ -32,10 +32,20 @@
 
 SDIO_CardInfoTypeDef SdCard;
 
+#if ENABLED(SD_ASYNC_READ)
+  enum AsyncState : uint8_t { ASYNC_IDLE, ASYNC_BUSY, ASYNC_DONE, ASYNC_FAILED };
+  static AsyncState async_state;
+  static uint32_t async_block;
+  static uint8_t *async_data;
+  static uint8_t async_retries;
+#endif
+
 bool SDIO_Init() {
   uint32_t count = 0U;
   SdCard.CardType = SdCard.CardVersion = SdCard.Class = SdCard.RelCardAdd = SdCard.BlockNbr = SdCard.BlockSize = SdCard.LogBlockNbr = SdCard.LogBlockSize = 0;
 
+  TERN_(SD_ASYNC_READ, async_state = ASYNC_IDLE);
+
   sdio_begin();
   sdio_set_dbus_width(SDIO_CLKCR_WIDBUS_1BIT);
 
@@ -81,7 +91,8 @@ bool SDIO_Init() {
   return true;
 }
 
-bool SDIO_ReadBlock_DMA(uint32_t blockAddress, uint8_t *data) {
+// Set up the DMA and send the read command
+bool SDIO_ReadStart_DMA(uint32_t blockAddress, uint8_t *data) {
   if (SDIO_GetCardState() != SDIO_CARD_TRANSFER) return false;
   if (blockAddress >= SdCard.LogBlockNbr) return false;
   if ((0x03 & (uint32_t)data)) return false; // misaligned data
@@ -100,23 +111,27 @@ bool SDIO_ReadBlock_DMA(uint32_t blockAddress, uint8_t *data) {
     dma_disable(SDIO_DMA_DEV, SDIO_DMA_CHANNEL);
     return false;
   }
+  return true;
+}
 
-  while (!SDIO_GET_FLAG(SDIO_STA_DATAEND | SDIO_STA_TRX_ERROR_FLAGS)) { /* wait */ }
+// Check on a started read. 1 when done, 0 while busy, -1 on error.
+int8_t SDIO_ReadCheck_DMA() {
+  if (!SDIO_GET_FLAG(SDIO_STA_DATAEND | SDIO_STA_TRX_ERROR_FLAGS)) return 0;
 
   //If there were SDIO errors, do not wait DMA.
   if (SDIO->STA & SDIO_STA_TRX_ERROR_FLAGS) {
     SDIO_CLEAR_FLAG(SDIO_ICR_CMD_FLAGS | SDIO_ICR_DATA_FLAGS);
     dma_disable(SDIO_DMA_DEV, SDIO_DMA_CHANNEL);
-    return false;
+    return -1;
   }
 
   //Wait for DMA transaction to complete
-  while ((DMA2_BASE->ISR & (DMA_ISR_TEIF4|DMA_ISR_TCIF4)) == 0 ) { /* wait */ }
+  if ((DMA2_BASE->ISR & (DMA_ISR_TEIF4|DMA_ISR_TCIF4)) == 0) return 0;
 
   if (DMA2_BASE->ISR & DMA_ISR_TEIF4) {
     dma_disable(SDIO_DMA_DEV, SDIO_DMA_CHANNEL);
     SDIO_CLEAR_FLAG(SDIO_ICR_CMD_FLAGS | SDIO_ICR_DATA_FLAGS);
-    return false;
+    return -1;
   }
 
   dma_disable(SDIO_DMA_DEV, SDIO_DMA_CHANNEL);
@@ -124,18 +139,71 @@ bool SDIO_ReadBlock_DMA(uint32_t blockAddress, uint8_t *data) {
   if (SDIO->STA & SDIO_STA_RXDAVL) {
     while (SDIO->STA & SDIO_STA_RXDAVL) (void)SDIO->FIFO;
     SDIO_CLEAR_FLAG(SDIO_ICR_CMD_FLAGS | SDIO_ICR_DATA_FLAGS);
-    return false;
+    return -1;
   }
 
   if (SDIO_GET_FLAG(SDIO_STA_TRX_ERROR_FLAGS)) {
     SDIO_CLEAR_FLAG(SDIO_ICR_CMD_FLAGS | SDIO_ICR_DATA_FLAGS);
-    return false;
+    return -1;
   }
   SDIO_CLEAR_FLAG(SDIO_ICR_CMD_FLAGS | SDIO_ICR_DATA_FLAGS);
-  return true;
+  return 1;
 }
 
+bool SDIO_ReadBlock_DMA(uint32_t blockAddress, uint8_t *data) {
+  if (!SDIO_ReadStart_DMA(blockAddress, data)) return false;
+  int8_t status;
+  while (!(status = SDIO_ReadCheck_DMA())) { /* wait */ }
+  return status > 0;
+}
+
+#if ENABLED(SD_ASYNC_READ)
+
+  /**
+   * Background read. The DMA fills the buffer while the caller carries on.
+   * Blocking reads and writes finish it first, as the card is busy.
+   */
+  static void async_check() {
+    const int8_t status = SDIO_ReadCheck_DMA();
+    if (status > 0)
+      async_state = ASYNC_DONE;
+    else if (status < 0) {
+      async_state = ASYNC_FAILED;
+      while (async_retries) {
+        async_retries--;
+        if (SDIO_ReadStart_DMA(async_block, async_data)) { async_state = ASYNC_BUSY; break; }
+      }
+    }
+  }
+
+  static void async_finish() { while (async_state == ASYNC_BUSY) async_check(); }
+
+  bool SDIO_ReadStart(uint32_t blockAddress, uint8_t *data) {
+    async_finish();
+    async_block = blockAddress;
+    async_data = data;
+    async_retries = SDIO_READ_RETRIES;
+    async_state = ASYNC_FAILED;
+    while (async_retries) {
+      async_retries--;
+      if (SDIO_ReadStart_DMA(blockAddress, data)) { async_state = ASYNC_BUSY; return true; }
+    }
+    return false;
+  }
+
+  int8_t SDIO_ReadDone() {
+    if (async_state == ASYNC_BUSY) async_check();
+    switch (async_state) {
+      case ASYNC_BUSY: return 0;
+      case ASYNC_FAILED: async_state = ASYNC_IDLE; return -1;
+      default: async_state = ASYNC_IDLE; return 1;
+    }
+  }
+
+#endif // SD_ASYNC_READ
+
 bool SDIO_ReadBlock(uint32_t blockAddress, uint8_t *data) {
+  TERN_(SD_ASYNC_READ, async_finish());
   uint32_t retries = SDIO_READ_RETRIES;
   while (retries--) if (SDIO_ReadBlock_DMA(blockAddress, data)) return true;
   return false;
@@ -144,6 +212,7 @@ bool SDIO_ReadBlock(uint32_t blockAddress, uint8_t *data) {
 uint32_t millis();
 
 bool SDIO_WriteBlock(uint32_t blockAddress, const uint8_t *data) {
+  TERN_(SD_ASYNC_READ, async_finish());
   if (SDIO_GetCardState() != SDIO_CARD_TRANSFER) return false;
   if (blockAddress >= SdCard.LogBlockNbr) return false;
   if ((0x03 & (uint32_t)data)) return false; // misaligned data
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "../inc/MarlinConfig.h"
+#include "../libs/numtostr.h"
 
 /**
  * Define debug bit-masks
@@ -287,9 +288,16 @@ extern uint8_t marlin_debug_flags;
 #define SERIAL_ECHO_TERNARY(TF, PRE, ON, OFF, POST) serial_ternary(TF, PSTR(PRE), PSTR(ON), PSTR(OFF), PSTR(POST))
 
 #if SERIAL_FLOAT_PRECISION
-  #define SERIAL_DECIMAL(V) SERIAL_PRINT(V, SERIAL_FLOAT_PRECISION)
+  #define SERIAL_DECIMAL(V) SERIAL_ECHO(ftostrdp(V, SERIAL_FLOAT_PRECISION))
 #else
-  #define SERIAL_DECIMAL(V) SERIAL_ECHO(V)
+  #define SERIAL_DECIMAL(V) SERIAL_ECHO(ftostrdp(V, 2))
+#endif
+
+// Periodic reports are held back while the TX buffer is too full
+#ifdef SERIAL_TX_DEFER_PERCENT
+  #define SERIAL_TX_DEFER() (SERIAL_TX_QUEUED() > (SERIAL_TX_CAPACITY) * (SERIAL_TX_DEFER_PERCENT) / 100)
+#else
+  #define SERIAL_TX_DEFER() false
 #endif
 
 //
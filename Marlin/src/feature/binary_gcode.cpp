@@ -0,0 +1,190 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * feature/binary_gcode.cpp - Compact binary framing for G-code commands
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(BINARY_GCODE)
+
+#include "binary_gcode.h"
+#include "../libs/crc16.h"
+
+// Accumulate a varint, returning true on its last byte
+bool BinaryGCode::varint(const uint8_t c) {
+  if (shift > 28 || (shift == 28 && (c & 0x70))) overflow = true;
+  acc |= uint32_t(c & 0x7F) << shift;
+  shift += 7;
+  return !TEST(c, 7);
+}
+
+// Append one character of text, tracking the checksum
+void BinaryGCode::put(const char c, char * const out, int &ind) {
+  if (ind >= MAX_CMD_SIZE - 1) { overflow = true; return; }
+  out[ind++] = c;
+  checksum ^= c;
+}
+
+void BinaryGCode::put_uint(uint32_t v, char * const out, int &ind) {
+  char digits[10];
+  uint8_t n = 0;
+  do { digits[n++] = '0' + v % 10; v /= 10; } while (v);
+  while (n) put(digits[--n], out, ind);
+}
+
+// Append a mantissa with 'd' decimal places, e.g., -125,1 => "-12.5"
+void BinaryGCode::put_fixed(const int32_t m, const uint8_t d, char * const out, int &ind) {
+  if (m < 0) put('-', out, ind);
+  const uint32_t u = m < 0 ? -uint32_t(m) : uint32_t(m);
+  uint32_t scale = 1;
+  LOOP_L_N(i, d) scale *= 10;
+  put_uint(u / scale, out, ind);
+  if (d) {
+    put('.', out, ind);
+    uint32_t frac = u % scale;
+    for (scale /= 10; scale; scale /= 10) { put('0' + frac / scale, out, ind); frac %= scale; }
+  }
+}
+
+BinaryGCode::Status BinaryGCode::feed(const uint8_t c, char * const out, int &ind) {
+
+  switch (state) {
+    case ST_RESYNC:
+      if (c == '\n' || c == '\r') { state = ST_IDLE; return BGC_MORE; }
+      // Fall through - a SYNC starts a frame, as when idle
+    case ST_IDLE:
+      if (c != SYNC) return BGC_MORE;
+      state = ST_LEN;
+      crc = 0;
+      ind = 0;
+      checksum = 0;
+      overflow = false;
+      return BGC_MORE;
+
+    case ST_CRC_LO:
+      rx_crc = c;
+      state = ST_CRC_HI;
+      return BGC_MORE;
+
+    case ST_CRC_HI:
+      rx_crc |= uint16_t(c) << 8;
+      if (rx_crc != crc) return fail(ind);
+      if (letter & 0x80) {
+        const uint8_t cs = checksum;
+        put('*', out, ind);
+        put_uint(cs, out, ind);
+        if (overflow) return fail(ind);
+      }
+      state = ST_IDLE;
+      return BGC_DONE;
+
+    case ST_LEN:
+      crc16(&crc, &c, 1);
+      if (!c) return fail(ind);
+      left = c;
+      state = ST_LETTER;
+      return BGC_MORE;
+
+    default: break;
+  }
+
+  // All other bytes are payload
+  crc16(&crc, &c, 1);
+  --left;
+
+  switch (state) {
+    case ST_LETTER:
+      letter = c;
+      switch (c & 0x7F) { case 'G': case 'M': case 'T': break; default: return fail(ind); }
+      acc = shift = 0;
+      if (letter & 0x80)
+        state = ST_LINE;
+      else {
+        put(letter, out, ind);
+        state = ST_CODE;
+      }
+      break;
+
+    case ST_LINE:
+      if (varint(c)) {
+        put('N', out, ind);
+        put_uint(acc, out, ind);
+        put(' ', out, ind);
+        put(letter & 0x7F, out, ind);
+        acc = shift = 0;
+        state = ST_CODE;
+      }
+      break;
+
+    case ST_CODE:
+      if (varint(c)) {
+        put_uint(acc / 10, out, ind);
+        if (acc % 10) { put('.', out, ind); put('0' + acc % 10, out, ind); }
+        mask = shift = 0;
+        state = ST_MASK;
+      }
+      break;
+
+    case ST_MASK:
+      mask |= uint32_t(c) << shift;
+      shift += 8;
+      if (shift == 32) {
+        if (mask >= _BV32(26) || TEST32(mask, 'N' - 'A')) return fail(ind);
+        param = 0;
+        acc = shift = 0;
+        state = mask ? ST_VALUES : ST_END;
+      }
+      break;
+
+    case ST_VALUES:
+      if (varint(c)) {
+        while (!TEST32(mask, param)) param++;
+        CBI32(mask, param);
+        put(' ', out, ind);
+        put('A' + param, out, ind);
+        const uint8_t d = acc & 7;
+        const uint32_t z = acc >> 3;
+        if (d == 7) {
+          if (z) return fail(ind);
+        }
+        else
+          put_fixed(int32_t(z >> 1) ^ -int32_t(z & 1), d, out, ind);
+        acc = shift = 0;
+        if (!mask) state = ST_END;
+      }
+      break;
+
+    default: return fail(ind);
+  }
+
+  if (overflow) return fail(ind);
+
+  // The payload must end exactly with the last value
+  if ((state == ST_END) != !left) return fail(ind);
+  if (!left) state = ST_CRC_LO;
+
+  return BGC_MORE;
+}
+
+#endif // BINARY_GCODE
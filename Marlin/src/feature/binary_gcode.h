@@ -0,0 +1,91 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * feature/binary_gcode.h - Compact binary framing for G-code commands
+ *
+ * A frame carries one G, M or T command. Frames may be sent over serial or
+ * stored in a G-code file in place of a text line. Each frame is expanded
+ * into normalized text as it arrives, so the queue, parser, and everything
+ * downstream see an ordinary G-code line.
+ *
+ *   Frame   : SYNC (0xA5), LEN, payload[LEN], CRC16 (CCITT, LSB first, over LEN and payload)
+ *   Payload : letter  'G', 'M' or 'T'. Bit 7 set if a line number follows.
+ *             line    varint (only with bit 7 of letter)
+ *             code    varint, codenum * 10 + subcode
+ *             mask    4 bytes, LSB first. Bit n is set for parameter 'A' + n ('N' not allowed).
+ *             values  One varint per mask bit, in letter order:
+ *                       7 for a parameter with no value, or
+ *                       zigzag(mantissa) << 3 | decimals (0-6)
+ *
+ * Varints are 7 bits per byte, LSB first, with bit 7 set on all but the last byte.
+ * A value is its decimal text as an integer mantissa and a count of decimal places,
+ * so "X-12.5" is sent as mantissa -125 with 1 decimal and expands to the same text.
+ *
+ * A frame with a line number expands to "N<line> <command>*<checksum>" so line
+ * numbering and resend requests work as they do for text lines.
+ *
+ * See buildroot/share/scripts/gcode_to_binary.py for an encoder.
+ */
+
+#include "../inc/MarlinConfigPre.h"
+
+class BinaryGCode {
+public:
+  static constexpr uint8_t SYNC = 0xA5;
+
+  enum Status : uint8_t { BGC_MORE, BGC_DONE, BGC_ERROR };
+
+  // Expanding a frame? When idle only a SYNC byte should be fed.
+  inline bool active() const { return state != ST_IDLE; }
+
+  inline void reset() { state = ST_IDLE; }
+
+  /**
+   * Feed the next byte of a frame, appending its text to 'out' at 'ind'.
+   * BGC_DONE when a whole frame has passed its CRC. On BGC_ERROR the
+   * frame is dropped and 'ind' is reset. The bytes that follow are then
+   * skipped up to the next SYNC or end of line, so the rest of a bad
+   * frame is never taken for text.
+   */
+  Status feed(const uint8_t c, char * const out, int &ind);
+
+private:
+  enum State : uint8_t { ST_IDLE, ST_RESYNC, ST_LEN, ST_LETTER, ST_LINE, ST_CODE, ST_MASK, ST_VALUES, ST_END, ST_CRC_LO, ST_CRC_HI };
+
+  State state = ST_IDLE;
+  char letter;
+  uint8_t left,           // Payload bytes remaining
+          shift,          // Varint bit position, or mask byte count
+          param,          // Next parameter to check in 'mask'
+          checksum;       // Checksum of the expanded text
+  bool overflow;
+  uint16_t crc, rx_crc;
+  uint32_t acc, mask;
+
+  Status fail(int &ind) { state = ST_RESYNC; ind = 0; return BGC_ERROR; }
+  bool varint(const uint8_t c);
+  void put(const char c, char * const out, int &ind);
+  void put_uint(uint32_t v, char * const out, int &ind);
+  void put_fixed(const int32_t m, const uint8_t d, char * const out, int &ind);
+};
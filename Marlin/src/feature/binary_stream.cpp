@@ -31,6 +31,10 @@ char* SDFileTransferProtocol::Packet::Open::data = nullptr;
 size_t SDFileTransferProtocol::data_waiting, SDFileTransferProtocol::transfer_timeout, SDFileTransferProtocol::idle_timeout;
 bool SDFileTransferProtocol::transfer_active, SDFileTransferProtocol::dummy_transfer, SDFileTransferProtocol::compression;
 
+#ifdef BINARY_STREAM_WINDOW
+  char BinaryStream::window_buffer[BinaryStream::WINDOW - 1][MAX_CMD_SIZE];
+#endif
+
 BinaryStream binaryStream[NUM_SERIAL];
 
 #endif
@@ -265,10 +265,50 @@ public:
     }
   } packet{};
 
+  /**
+   * Up to WINDOW packets may be sent ahead of the "ok"s. Each is kept in the
+   * slot for its sync id until the ones before it have arrived, so after a
+   * resend request ("rs") the host only needs to repeat the missing packet.
+   * Packets are handed on in order, with the "ok", when the line is quiet.
+   */
+  #ifdef BINARY_STREAM_WINDOW
+    static constexpr uint8_t WINDOW = BINARY_STREAM_WINDOW;
+    static char window_buffer[WINDOW - 1][MAX_CMD_SIZE];
+  #else
+    static constexpr uint8_t WINDOW = 1;
+  #endif
+
+  struct Slot {
+    Packet::Header header;  // Protocol, type and size of the received packet
+    bool ready;             // Received, waiting for the packets before it
+  } slot[WINDOW];
+
+  // Slot 0 uses the buffer given to receive()
+  template<const size_t buffer_size>
+  char* slot_buffer(const uint8_t id, char (&buffer)[buffer_size]) {
+    #ifdef BINARY_STREAM_WINDOW
+      static_assert(buffer_size <= MAX_CMD_SIZE, "BINARY_STREAM_WINDOW buffers are MAX_CMD_SIZE.");
+      const uint8_t s = id % WINDOW;
+      if (s) return window_buffer[s - 1];
+    #else
+      UNUSED(id);
+    #endif
+    return buffer;
+  }
+
+  // The first packet not yet received
+  uint8_t hole() {
+    uint8_t id = sync;
+    while (uint8_t(id - sync) < WINDOW && slot[id % WINDOW].ready) id++;
+    return id;
+  }
+
   void reset() {
     sync = 0;
     packet_retries = 0;
     buffer_next_index = 0;
+    hole_reported = false;
+    LOOP_L_N(i, WINDOW) slot[i].ready = false;
   }
 
   // fletchers 16 checksum
@@ -304,6 +344,19 @@ public:
     #pragma GCC diagnostic ignored "-Warray-bounds"
 
     while (PENDING(millis(), transfer_window)) {
+      // Pass on the next packet in order unless more data is waiting
+      Slot &next = slot[sync % WINDOW];
+      if (next.ready && !bs_serial_data_available(card.transfer_port_index)) {
+        SERIAL_ECHOLNPAIR("ok", sync); // transmit valid packet received
+        packet_retries = 0;
+        hole_reported = false;
+        bytes_received += next.header.size;
+        dispatch(next.header, slot_buffer(sync, buffer));
+        next.ready = false;
+        sync++;
+        continue;
+      }
+
       switch (stream_state) {
          /**
           * Data stream packet handling
@@ -337,21 +390,30 @@ public:
             if (packet.header.checksum == packet.header_checksum) {
               // The SYNC control packet is a special case in that it doesn't require the stream sync to be correct
               if (static_cast<Protocol>(packet.header.protocol()) == Protocol::CONTROL && static_cast<ProtocolControl>(packet.header.type()) == ProtocolControl::SYNC) {
-                  SERIAL_ECHOLNPAIR("ss", sync, ",", buffer_size, ",", VERSION_MAJOR, ".", VERSION_MINOR, ".", VERSION_PATCH);
+                  #ifdef BINARY_STREAM_WINDOW
+                    SERIAL_ECHOLNPAIR("ss", sync, ",", buffer_size, ",", VERSION_MAJOR, ".", VERSION_MINOR, ".", VERSION_PATCH, ",", int(WINDOW));
+                  #else
+                    SERIAL_ECHOLNPAIR("ss", sync, ",", buffer_size, ",", VERSION_MAJOR, ".", VERSION_MINOR, ".", VERSION_PATCH);
+                  #endif
                   stream_state = StreamState::PACKET_RESET;
                   break;
               }
-              if (packet.header.sync == sync) {
-                buffer_next_index = 0;
-                packet.bytes_received = 0;
-                if (packet.header.size) {
-                  stream_state = StreamState::PACKET_DATA;
-                  packet.buffer = static_cast<char *>(&buffer[0]); // multipacket buffering not implemented, always allocate whole buffer to packet
+              const uint8_t ahead = packet.header.sync - sync, behind = sync - packet.header.sync;
+              if (ahead < WINDOW) {
+                if (slot[packet.header.sync % WINDOW].ready)
+                  stream_state = StreamState::PACKET_RESET;         // already buffered, drop the repeat
+                else {
+                  buffer_next_index = 0;
+                  packet.bytes_received = 0;
+                  if (packet.header.size) {
+                    stream_state = StreamState::PACKET_DATA;
+                    packet.buffer = slot_buffer(packet.header.sync, buffer);
+                  }
+                  else
+                    stream_state = StreamState::PACKET_PROCESS;
                 }
-                else
-                  stream_state = StreamState::PACKET_PROCESS;
               }
-              else if (packet.header.sync == sync - 1) {           // ok response must have been lost
+              else if (behind && behind <= WINDOW) {                // ok response must have been lost
                 SERIAL_ECHOLNPAIR("ok", packet.header.sync);  // transmit valid packet received and drop the payload
                 stream_state = StreamState::PACKET_RESET;
               }
@@ -405,22 +467,25 @@ public:
             }
           }
           break;
-        case StreamState::PACKET_PROCESS:
-          sync++;
-          packet_retries = 0;
-          bytes_received += packet.header.size;
-
-          SERIAL_ECHOLNPAIR("ok", packet.header.sync); // transmit valid packet received
-          dispatch();
+        case StreamState::PACKET_PROCESS: {
+          Slot &s = slot[packet.header.sync % WINDOW];
+          s.header = packet.header;
+          s.ready = true;
           stream_state = StreamState::PACKET_RESET;
-          break;
+          // A later packet got here first, so ask once for the one that was lost
+          if (!hole_reported && uint8_t(hole() - sync) < uint8_t(packet.header.sync - sync)) {
+            hole_reported = true;
+            SERIAL_ECHOLNPAIR("rs", hole());
+          }
+        } break;
         case StreamState::PACKET_RESEND:
           if (packet_retries < MAX_RETRIES || MAX_RETRIES == 0) {
             packet_retries++;
+            hole_reported = true;
             stream_state = StreamState::PACKET_RESET;
             SERIAL_ECHO_START();
             SERIAL_ECHOLNPAIR("Resend request ", int(packet_retries));
-            SERIAL_ECHOLNPAIR("rs", sync);
+            SERIAL_ECHOLNPAIR("rs", hole());
           }
           else
             stream_state = StreamState::PACKET_ERROR;
@@ -440,10 +505,10 @@ public:
     #pragma GCC diagnostic pop
   }
 
-  void dispatch() {
-    switch (static_cast<Protocol>(packet.header.protocol())) {
+  void dispatch(Packet::Header &header, char* buffer) {
+    switch (static_cast<Protocol>(header.protocol())) {
       case Protocol::CONTROL:
-        switch (static_cast<ProtocolControl>(packet.header.type())) {
+        switch (static_cast<ProtocolControl>(header.type())) {
           case ProtocolControl::CLOSE: // revert back to ASCII mode
             card.flag.binary_mode = false;
             break;
@@ -452,7 +517,7 @@ public:
         }
         break;
       case Protocol::FILE_TRANSFER:
-        SDFileTransferProtocol::process(packet.header.type(), packet.buffer, packet.header.size); // send user data to be processed
+        SDFileTransferProtocol::process(header.type(), buffer, header.size); // send user data to be processed
       break;
       default:
         SERIAL_ECHO_MSG("Unsupported Binary Protocol");
@@ -464,8 +529,9 @@ public:
     SDFileTransferProtocol::idle();
   }
 
-  static const uint16_t PACKET_MAX_WAIT = 500, RX_TIMESLICE = 20, MAX_RETRIES = 0, VERSION_MAJOR = 0, VERSION_MINOR = 1, VERSION_PATCH = 0;
+  static const uint16_t PACKET_MAX_WAIT = 500, RX_TIMESLICE = 20, MAX_RETRIES = 0, VERSION_MAJOR = 0, VERSION_MINOR = WINDOW > 1 ? 2 : 1, VERSION_PATCH = 0;
   uint8_t  packet_retries, sync;
+  bool hole_reported;         // "rs" already sent for the first missing packet
   uint16_t buffer_next_index;
   uint32_t bytes_received;
   StreamState stream_state = StreamState::PACKET_RESET;
@@ -0,0 +1,149 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(GCODE_MACROS)
+
+#include "gcode_macros.h"
+#include "../gcode/gcode.h"
+
+GCodeMacros gcode_macros;
+
+char GCodeMacros::text[GCODE_MACROS_SLOTS][GCODE_MACROS_SLOT_SIZE + 1]; // = { { 0 } }
+
+#if ENABLED(GCODE_MACROS_PRECOMPILE)
+
+  char GCodeMacros::lines[GCODE_MACROS_SLOTS][GCODE_MACROS_SLOT_SIZE + 1];
+  uint8_t GCodeMacros::packed[GCODE_MACROS_SLOTS][GCODE_MACROS_COMPILED_SIZE]; // = { { 0 } }
+
+  /**
+   * Parse all the commands in a macro and pack them.
+   * Commands that don't fit in the packed buffer are parsed when they run.
+   * Return false if there's no room left for even that.
+   */
+  bool GCodeMacros::compile(const uint8_t index) {
+    char * const line = lines[index];
+    uint8_t * const out = packed[index], *p = out + 1;
+    const uint8_t * const end = out + COUNT(packed[index]);
+
+    strcpy(line, text[index]);
+    const uint8_t len = strlen(line);
+    LOOP_L_N(i, len) if (line[i] == '\n') line[i] = '\0';
+
+    #if ENABLED(GCODE_MOTION_MODES)
+      const int16_t mode = parser.motion_mode_codenum;      // Parsing shouldn't change the mode
+      TERN_(USE_GCODE_SUBCODES, const uint8_t submode = parser.motion_mode_subcode);
+    #endif
+    char * const saved_cmd = parser.command_ptr;            // Save the parser state
+
+    bool ok = true;
+    *out = 0;
+    for (uint8_t i = 0, next; i < len; i = next) {
+      char * const cmd = &line[i];
+      next = i + strlen(cmd) + 1;                           // Before parse() adds a nul
+      if (!*cmd) continue;                                  // Skip empty commands
+      if (end - p < 2) { ok = false; break; }
+      parser.parse(cmd);
+      p[0] = i;
+      p[1] = parser.pack(cmd, p + 2, _MIN(end - p - 2, 255));
+      p += 2 + p[1];
+      (*out)++;
+    }
+
+    if (saved_cmd) parser.parse(saved_cmd);                 // Restore the parser state
+    #if ENABLED(GCODE_MOTION_MODES)
+      parser.motion_mode_codenum = mode;
+      TERN_(USE_GCODE_SUBCODES, parser.motion_mode_subcode = submode);
+    #endif
+
+    return ok;
+  }
+
+#endif // GCODE_MACROS_PRECOMPILE
+
+bool GCodeMacros::set(const uint8_t index, const char * const cmds) {
+  if (strlen(cmds) > GCODE_MACROS_SLOT_SIZE) return false;
+
+  char c, *d = text[index];
+  const char *s = cmds;
+  do {
+    c = *s++;
+    *d++ = c == '|' ? '\n' : c;
+  } while (c);
+
+  #if ENABLED(GCODE_MACROS_PRECOMPILE)
+    if (!compile(index)) {
+      text[index][0] = '\0';
+      packed[index][0] = 0;
+      return false;
+    }
+  #endif
+
+  return true;
+}
+
+void GCodeMacros::run(const uint8_t index) {
+  #if ENABLED(GCODE_MACROS_PRECOMPILE)
+
+    const uint8_t *p = packed[index];
+    uint8_t count = *p++;
+    if (!count) return;
+
+    char * const saved_cmd = parser.command_ptr;            // Save the parser state
+    while (count--) {
+      char * const cmd = &lines[index][p[0]];
+      const uint8_t size = p[1];
+      p += 2;
+      if (size) parser.unpack(p, cmd); else parser.parse(cmd);
+      p += size;
+      gcode.process_parsed_command(true);
+    }
+    parser.parse(saved_cmd);                                // Restore the parser state
+
+  #else
+
+    char * const cmd = text[index];
+    if (*cmd) gcode.process_subcommands_now(cmd);
+
+  #endif
+}
+
+void GCodeMacros::reset() {
+  LOOP_L_N(i, GCODE_MACROS_SLOTS) {
+    text[i][0] = '\0';
+    TERN_(GCODE_MACROS_PRECOMPILE, packed[i][0] = 0);
+  }
+}
+
+#if ENABLED(GCODE_MACROS_IN_EEPROM)
+
+  void GCodeMacros::refresh() {
+    LOOP_L_N(i, GCODE_MACROS_SLOTS) {
+      text[i][GCODE_MACROS_SLOT_SIZE] = '\0';
+      TERN_(GCODE_MACROS_PRECOMPILE, if (!compile(i)) text[i][0] = packed[i][0] = 0);
+    }
+  }
+
+#endif
+
+#endif // GCODE_MACROS
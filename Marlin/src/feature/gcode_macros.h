@@ -0,0 +1,65 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * feature/gcode_macros.h - Storage for the M810-M819 G-code macros
+ *
+ * A macro is kept as text, with commands separated by newlines.
+ *
+ * With GCODE_MACROS_PRECOMPILE each command is also parsed once, when the
+ * macro is set, into a private copy of the text. The parser state is packed
+ * (see GCodeParser::pack) after the command's offset in that copy, so running
+ * the macro just unpacks each command and runs it.
+ *
+ *   packed : count, then for each command: line offset, size, packed[size]
+ *
+ * A command with size 0 is parsed from its line when it runs.
+ */
+
+#include "../inc/MarlinConfigPre.h"
+
+class GCodeMacros {
+public:
+  static char text[GCODE_MACROS_SLOTS][GCODE_MACROS_SLOT_SIZE + 1];
+
+  // Set a macro from commands separated by '|'. False if it doesn't fit.
+  static bool set(const uint8_t index, const char * const cmds);
+
+  // Run all the commands of a macro in place, before anything else in the queue
+  static void run(const uint8_t index);
+
+  static void reset();
+
+  #if ENABLED(GCODE_MACROS_IN_EEPROM)
+    static void refresh();    // Prepare macros loaded from EEPROM
+  #endif
+
+private:
+  #if ENABLED(GCODE_MACROS_PRECOMPILE)
+    static char lines[GCODE_MACROS_SLOTS][GCODE_MACROS_SLOT_SIZE + 1];
+    static uint8_t packed[GCODE_MACROS_SLOTS][GCODE_MACROS_COMPILED_SIZE];
+    static bool compile(const uint8_t index);
+  #endif
+};
+
+extern GCodeMacros gcode_macros;
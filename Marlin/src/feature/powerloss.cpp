@@ -79,6 +79,161 @@ PrintJobRecovery recovery;
   #define POWER_LOSS_RETRACT_LEN 0
 #endif
 
+#if EITHER(POWER_LOSS_JOURNAL, HAS_POWER_LOSS_RING)
+
+  #include "../libs/crc16.h"
+
+  // Records have fixed slots, so one never crosses a block or a flash page
+  constexpr uint16_t record_size = 64;
+
+  static_assert(sizeof(job_recovery_record_t) <= record_size, "Too many HOTENDS or FANS for the power-loss records.");
+
+  static uint16_t record_crc(const job_recovery_record_t &r) {
+    uint16_t crc = 0;
+    crc16(&crc, (const uint8_t*)&r + sizeof(r.crc), sizeof(r) - sizeof(r.crc));
+    return crc;
+  }
+
+  /**
+   * Move the record fields of a copy of the info into a record, and get the
+   * CRC of what's left. While that doesn't change a record is enough to save.
+   */
+  static uint16_t split_record(job_recovery_info_t &i, job_recovery_record_t &r) {
+    memset(&r, 0, sizeof(r));
+    r.current_position = i.current_position;   i.current_position.reset();
+    r.zraise = i.zraise;                       i.zraise = 0;
+    r.sdpos = i.sdpos;                         i.sdpos = 0;
+    r.print_job_elapsed = i.print_job_elapsed; i.print_job_elapsed = 0;
+    r.feedrate = i.feedrate;                   i.feedrate = 0;
+    #if HAS_HOTEND
+      COPY(r.target_temperature, i.target_temperature);
+      ZERO(i.target_temperature);
+    #endif
+    #if HAS_HEATED_BED
+      r.target_temperature_bed = i.target_temperature_bed;
+      i.target_temperature_bed = 0;
+    #endif
+    #if HAS_FAN
+      COPY(r.fan_speed, i.fan_speed);
+      ZERO(i.fan_speed);
+    #endif
+
+    const uint8_t valid = i.valid_head;
+    i.valid_head = i.valid_foot = 0;
+    uint16_t crc = 0;
+    crc16(&crc, &i, sizeof(i));
+    i.valid_head = i.valid_foot = valid;
+    return crc;
+  }
+
+  // Put the record fields back into the info
+  static void merge_record(const job_recovery_record_t &r, job_recovery_info_t &i) {
+    i.current_position = r.current_position;
+    i.zraise = r.zraise;
+    i.sdpos = r.sdpos;
+    i.print_job_elapsed = r.print_job_elapsed;
+    i.feedrate = r.feedrate;
+    TERN_(HAS_HOTEND, COPY(i.target_temperature, r.target_temperature));
+    TERN_(HAS_HEATED_BED, i.target_temperature_bed = r.target_temperature_bed);
+    TERN_(HAS_FAN, COPY(i.fan_speed, r.fan_speed));
+  }
+
+  // Make a snapshot header for the info
+  static void snapshot_header(job_recovery_snapshot_t &h, const uint32_t gen, const job_recovery_info_t &i) {
+    h.size = sizeof(i);
+    h.gen = gen;
+    h.crc = 0;
+    crc16(&h.crc, &h.size, sizeof(h) - sizeof(h.crc));
+    crc16(&h.crc, &i, sizeof(i));
+  }
+
+#endif
+
+#if ENABLED(POWER_LOSS_JOURNAL)
+
+  #define JOURNAL_NEW 0xFFFF      // journal_count before the first save of a job
+
+  uint32_t PrintJobRecovery::journal_gen; // = 0
+  uint16_t PrintJobRecovery::journal_count = JOURNAL_NEW,
+           PrintJobRecovery::journal_base;
+
+  /**
+   * The journal file holds two snapshot slots, used in turn, followed by
+   * the records. A record never crosses a block, so appending one rewrites
+   * a single block of a file that never changes size.
+   */
+  constexpr uint32_t journal_slot_size = (sizeof(job_recovery_snapshot_t) + sizeof(job_recovery_info_t) + 511) / 512 * 512,
+                     journal_size = 2 * journal_slot_size + (POWER_LOSS_JOURNAL_RECORDS) * uint32_t(record_size);
+
+  static inline uint32_t record_pos(const uint16_t nr) { return 2 * journal_slot_size + nr * uint32_t(record_size); }
+
+#elif HAS_POWER_LOSS_RING
+
+  /**
+   * The ring is a run of sectors on the board's flash or EEPROM. Each one
+   * starts with a snapshot followed by the records that belong to it. A new
+   * sector is begun only when the last one is full. The sector after the
+   * current one is erased ahead of time, when a job starts and right after
+   * each snapshot, so a save only programs and the newest complete snapshot
+   * is never erased while it's needed.
+   */
+  #if ENABLED(POWER_LOSS_RING_W25QXX)
+
+    #include "../libs/W25Qxx.h"
+
+    #define RING_SECTOR_SIZE SPI_FLASH_SectorSize
+    #ifndef POWER_LOSS_RING_SECTORS
+      #define POWER_LOSS_RING_SECTORS 16
+    #endif
+    #ifndef POWER_LOSS_RING_ADDR
+      #define POWER_LOSS_RING_ADDR (SPI_FLASH_SIZE - (POWER_LOSS_RING_SECTORS) * uint32_t(RING_SECTOR_SIZE))
+    #endif
+
+    // Set up the SPI port on first use, by the boot-time load or a purge
+    static void ring_begin() {
+      static bool ready; // = false
+      if (!ready) { W25QXX.init(SPI_QUARTER_SPEED); ready = true; }
+    }
+    static void ring_read(const uint32_t addr, void * const buf, const uint16_t len) { W25QXX.SPI_FLASH_BufferRead((uint8_t*)buf, addr, len); }
+    static void ring_program(const uint32_t addr, const void * const buf, const uint16_t len) { W25QXX.SPI_FLASH_BufferWrite((uint8_t*)buf, addr, len); }
+    static void ring_erase(const uint32_t addr) { W25QXX.SPI_FLASH_SectorErase(addr, false); } // The next read or program waits for it
+
+  #elif ENABLED(POWER_LOSS_RING_BL24CXX)
+
+    #include "../libs/BL24CXX.h"
+
+    #define RING_SECTOR_SIZE 512
+    #ifndef POWER_LOSS_RING_SECTORS
+      #define POWER_LOSS_RING_SECTORS 2
+    #endif
+
+    static_assert((POWER_LOSS_RING_ADDR) + (POWER_LOSS_RING_SECTORS) * (RING_SECTOR_SIZE) <= (EE_TYPE) + 1, "POWER_LOSS_RING_BL24CXX doesn't fit in the EEPROM.");
+
+    static void ring_begin() {}
+    static void ring_read(const uint32_t addr, void * const buf, const uint16_t len) { BL24CXX::read(addr, (uint8_t*)buf, len); }
+    static void ring_program(const uint32_t addr, const void * const buf, const uint16_t len) { BL24CXX::write(addr, (uint8_t*)buf, len); }
+    static void ring_erase(const uint32_t) {}   // Bytes are simply overwritten. Old records have an older generation.
+
+  #endif
+
+  #define RING_NEW 0xFFFF         // ring_count before the first save of a job
+
+  uint32_t PrintJobRecovery::ring_gen; // = 0
+  uint8_t PrintJobRecovery::ring_sector; // = 0
+  uint16_t PrintJobRecovery::ring_count = RING_NEW,
+           PrintJobRecovery::ring_base;
+
+  constexpr uint16_t ring_records_pos = (sizeof(job_recovery_snapshot_t) + sizeof(job_recovery_info_t) + record_size - 1) / record_size * record_size,
+                     ring_records = (RING_SECTOR_SIZE - ring_records_pos) / record_size;
+
+  static_assert(ring_records >= 2, "The power-loss info is too big for a POWER_LOSS_RING sector.");
+
+  static inline uint32_t sector_addr(const uint8_t s) { return (POWER_LOSS_RING_ADDR) + s * uint32_t(RING_SECTOR_SIZE); }
+  static inline uint32_t record_addr(const uint8_t s, const uint16_t nr) { return sector_addr(s) + ring_records_pos + nr * record_size; }
+  static inline uint8_t next_sector(const uint8_t s) { return s + 1 < POWER_LOSS_RING_SECTORS ? s + 1 : 0; }
+
+#endif
+
 /**
  * Clear the recovery info
  */
@@ -123,18 +278,31 @@ void PrintJobRecovery::check() {
  */
 void PrintJobRecovery::purge() {
   init();
-  card.removeJobRecoveryFile();
+  #if HAS_POWER_LOSS_RING
+    ring_purge();
+  #else
+    card.removeJobRecoveryFile();
+  #endif
 }
 
 /**
  * Load the recovery data, if it exists
  */
 void PrintJobRecovery::load() {
+  #if HAS_POWER_LOSS_RING
+    ring_load();
+  #else
   if (exists()) {
     open(true);
-    (void)file.read(&info, sizeof(info));
+    #if ENABLED(POWER_LOSS_JOURNAL)
+      if (file.fileSize() == journal_size)
+        journal_load();
+      else
+    #endif
+        (void)file.read(&info, sizeof(info));
     close();
   }
+  #endif
   debug(PSTR("Load"));
 }
 
@@ -144,6 +312,8 @@ void PrintJobRecovery::load() {
 void PrintJobRecovery::prepare() {
   card.getAbsFilename(info.sd_filename);  // SD filename
   cmd_sdpos = 0;
+  TERN_(POWER_LOSS_JOURNAL, journal_count = JOURNAL_NEW); // Start with a snapshot
+  TERN_(HAS_POWER_LOSS_RING, ring_prepare());
 }
 
 /**
@@ -337,13 +507,293 @@ void PrintJobRecovery::write() {
 
   debug(PSTR("Write"));
 
-  open(false);
-  file.seekSet(0);
-  const int16_t ret = file.write(&info, sizeof(info));
-  if (ret == -1) DEBUG_ECHOLNPGM("Power-loss file write failed.");
-  if (!file.close()) DEBUG_ECHOLNPGM("Power-loss file close failed.");
+  #if HAS_POWER_LOSS_RING
+    if (!ring_write()) DEBUG_ECHOLNPGM("Power-loss ring write failed.");
+  #elif ENABLED(POWER_LOSS_JOURNAL)
+    if (!journal_write()) DEBUG_ECHOLNPGM("Power-loss journal write failed.");
+    if (file.isOpen() && !file.close()) DEBUG_ECHOLNPGM("Power-loss file close failed.");
+  #else
+    open(false);
+    file.seekSet(0);
+    const int16_t ret = file.write(&info, sizeof(info));
+    if (ret == -1) DEBUG_ECHOLNPGM("Power-loss file write failed.");
+    if (!file.close()) DEBUG_ECHOLNPGM("Power-loss file close failed.");
+  #endif
 }
 
+#if ENABLED(POWER_LOSS_JOURNAL)
+
+  /**
+   * Open the journal file, making it first if needed.
+   * A recovery file in the whole-info format is replaced.
+   */
+  bool PrintJobRecovery::journal_open() {
+    if (!card.isMounted()) return false;
+    if (file.isOpen()) file.close();
+    SdFile root = card.getroot();
+    if (file.open(&root, filename, O_RDWR)) {
+      if (file.fileSize() == journal_size) return true;
+      if (!file.remove()) { file.close(); return false; }
+    }
+    // A new file holds whatever was left on the card, so look it over first
+    journal_count = JOURNAL_NEW;
+    return file.createContiguous(&root, filename, journal_size);
+  }
+
+  // Check the snapshot in slot s, reading it in pieces to leave the info alone
+  bool PrintJobRecovery::journal_check(const uint8_t s, job_recovery_snapshot_t &h) {
+    if (!file.seekSet(s * journal_slot_size) || file.read(&h, sizeof(h)) != int16_t(sizeof(h))) return false;
+    if (h.size != sizeof(job_recovery_info_t)) return false;
+    uint16_t crc = 0;
+    crc16(&crc, &h.size, sizeof(h) - sizeof(h.crc));
+    uint8_t buf[32];
+    for (uint16_t n = sizeof(job_recovery_info_t); n;) {
+      const uint8_t len = _MIN(n, uint16_t(sizeof(buf)));
+      if (file.read(buf, len) != len) return false;
+      crc16(&crc, buf, len);
+      n -= len;
+    }
+    return crc == h.crc;
+  }
+
+  // The newest generation in the file, so a new job can't be mixed up with an old one
+  uint32_t PrintJobRecovery::journal_newest() {
+    uint32_t gen = 0;
+    job_recovery_snapshot_t h;
+    LOOP_L_N(s, 2) if (journal_check(s, h)) NOLESS(gen, h.gen);
+    job_recovery_record_t r;
+    for (uint16_t nr = 0; nr < POWER_LOSS_JOURNAL_RECORDS; nr++)
+      if (file.seekSet(record_pos(nr)) && file.read(&r, sizeof(r)) == int16_t(sizeof(r)) && r.crc == record_crc(r))
+        NOLESS(gen, r.gen);
+    return gen;
+  }
+
+  /**
+   * Append a record. When the journal is full, or anything but
+   * the record fields has changed, compact it into a snapshot.
+   */
+  bool PrintJobRecovery::journal_write() {
+    if (!journal_open()) return false;
+
+    // Work on a copy, since the stepper ISR updates info.sdpos
+    job_recovery_info_t now = info;
+    job_recovery_record_t r;
+    const uint16_t base = split_record(now, r);
+
+    if (journal_count < POWER_LOSS_JOURNAL_RECORDS && base == journal_base) {
+      r.gen = journal_gen;
+      r.crc = record_crc(r);
+      if (!file.seekSet(record_pos(journal_count)) || file.write(&r, sizeof(r)) != int16_t(sizeof(r))) return false;
+      journal_count++;
+      return true;
+    }
+
+    if (journal_count > POWER_LOSS_JOURNAL_RECORDS) {
+      // A new job. Clear both slots first, so a job left in the
+      // file can't be resumed in place of this one.
+      journal_gen = journal_newest();
+      const job_recovery_snapshot_t none = { 0 };
+      LOOP_L_N(s, 2)
+        if (!file.seekSet(s * journal_slot_size) || file.write(&none, sizeof(none)) != int16_t(sizeof(none)))
+          return false;
+    }
+
+    // Write the snapshot into the slot not holding the last one. If power
+    // fails before it's complete, the last snapshot and its records remain.
+    merge_record(r, now);
+    job_recovery_snapshot_t h;
+    snapshot_header(h, journal_gen + 1, now);
+    if (!file.seekSet((h.gen & 1) * journal_slot_size)
+      || file.write(&h, sizeof(h)) != int16_t(sizeof(h))
+      || file.write(&now, sizeof(now)) != int16_t(sizeof(now))
+    ) return false;
+
+    journal_gen = h.gen;
+    journal_count = 0;
+    journal_base = base;
+    return true;
+  }
+
+  /**
+   * Load the newer good snapshot, then replay the records that follow it.
+   * A snapshot or record cut short by the outage fails its CRC and is passed over.
+   */
+  void PrintJobRecovery::journal_load() {
+    job_recovery_snapshot_t h[2];
+    const bool ok0 = journal_check(0, h[0]), ok1 = journal_check(1, h[1]);
+    if (!ok0 && !ok1) return init();
+    const uint8_t s = ok1 && (!ok0 || h[1].gen > h[0].gen);
+    if (!file.seekSet(s * journal_slot_size + sizeof(h[s])) || file.read(&info, sizeof(info)) != int16_t(sizeof(info)))
+      return init();
+
+    journal_gen = h[s].gen;
+    job_recovery_record_t r;
+    uint16_t nr = 0;
+    for (; nr < POWER_LOSS_JOURNAL_RECORDS; nr++) {
+      if (!file.seekSet(record_pos(nr)) || file.read(&r, sizeof(r)) != int16_t(sizeof(r))) break;
+      if (r.gen != journal_gen || r.crc != record_crc(r)) break;
+      merge_record(r, info);
+    }
+    DEBUG_ECHOLNPAIR("Power-loss journal gen ", journal_gen, " records ", nr);
+
+    journal_count = JOURNAL_NEW;    // The next save starts with a snapshot
+  }
+
+#endif // POWER_LOSS_JOURNAL
+
+#if HAS_POWER_LOSS_RING
+
+  // Check the snapshot in sector s, reading it in pieces to leave the info alone
+  bool PrintJobRecovery::ring_check(const uint8_t s, job_recovery_snapshot_t &h) {
+    uint32_t addr = sector_addr(s);
+    ring_read(addr, &h, sizeof(h));
+    if (h.size != sizeof(job_recovery_info_t)) return false;
+    addr += sizeof(h);
+    uint16_t crc = 0;
+    crc16(&crc, &h.size, sizeof(h) - sizeof(h.crc));
+    uint8_t buf[32];
+    for (uint16_t n = sizeof(job_recovery_info_t); n;) {
+      const uint8_t len = _MIN(n, uint16_t(sizeof(buf)));
+      ring_read(addr, buf, len);
+      crc16(&crc, buf, len);
+      addr += len;
+      n -= len;
+    }
+    return crc == h.crc;
+  }
+
+  /**
+   * Get the sector with the newest good snapshot, or -1 if there are none.
+   * Also get the newest generation in the ring, including purged snapshots,
+   * so the next job's records can't be mixed up with old ones.
+   */
+  int8_t PrintJobRecovery::ring_scan(uint32_t &newest) {
+    ring_begin();
+    int8_t found = -1;
+    uint32_t found_gen = 0;
+    newest = 0;
+    LOOP_L_N(s, POWER_LOSS_RING_SECTORS) {
+      job_recovery_snapshot_t h;
+      if (ring_check(s, h)) {
+        if (found < 0 || h.gen > found_gen) { found = s; found_gen = h.gen; }
+      }
+      else if (h.size && h.size != sizeof(job_recovery_info_t))
+        continue;                   // Erased, or never used
+      if (h.gen != 0xFFFFFFFF) NOLESS(newest, h.gen);
+    }
+    return found;
+  }
+
+  bool PrintJobRecovery::ring_exists() {
+    uint32_t newest;
+    return ring_scan(newest) >= 0;
+  }
+
+  /**
+   * Follow on from whatever is in the ring, and erase the sector the job's
+   * first snapshot will go in, before the print gets going.
+   */
+  void PrintJobRecovery::ring_prepare() {
+    const int8_t s = ring_scan(ring_gen);
+    ring_sector = s < 0 ? POWER_LOSS_RING_SECTORS - 1 : s;
+    ring_count = ring_records;      // The next save starts the next sector
+    ring_erase(sector_addr(next_sector(ring_sector)));
+  }
+
+  /**
+   * Append a record to the current sector. When it's full, or anything but
+   * the record fields has changed, start the next (already erased) sector
+   * with a snapshot, then start erasing the one after it.
+   */
+  bool PrintJobRecovery::ring_write() {
+    // Work on a copy, since the stepper ISR updates info.sdpos
+    job_recovery_info_t now = info;
+    job_recovery_record_t r;
+    const uint16_t base = split_record(now, r);
+
+    if (ring_count < ring_records && base == ring_base) {
+      r.gen = ring_gen;
+      r.crc = record_crc(r);
+      ring_program(record_addr(ring_sector, ring_count), &r, sizeof(r));
+      ring_count++;
+      return true;
+    }
+
+    // Saved with no prepare() since a load or purge, as by M413 W
+    if (ring_count > ring_records) ring_prepare();
+
+    // Wear the sectors evenly by taking them in turn
+    ring_sector = next_sector(ring_sector);
+    const uint32_t addr = sector_addr(ring_sector);
+
+    merge_record(r, now);
+    job_recovery_snapshot_t h;
+    snapshot_header(h, ring_gen + 1, now);
+    ring_program(addr, &h, sizeof(h));
+    ring_program(addr + sizeof(h), &now, sizeof(now));
+
+    // Check the snapshot, since a flash sector may wear out
+    job_recovery_snapshot_t check;
+    const bool ok = ring_check(ring_sector, check) && check.gen == h.gen;
+
+    // Get the next sector ready. Unless snapshots keep failing the newest
+    // good one is in this sector or the last, so 3 sectors are enough.
+    ring_erase(sector_addr(next_sector(ring_sector)));
+
+    ring_gen = h.gen;
+    if (!ok) {
+      ring_count = ring_records;    // Go on to the next sector
+      return false;
+    }
+
+    ring_count = 0;
+    ring_base = base;
+    return true;
+  }
+
+  /**
+   * Load the newest good snapshot, then replay the records that follow it.
+   * A snapshot or record cut short by the outage fails its CRC and is passed over.
+   */
+  void PrintJobRecovery::ring_load() {
+    uint32_t newest;
+    const int8_t s = ring_scan(newest);
+    if (s < 0) return init();
+
+    job_recovery_snapshot_t h;
+    ring_read(sector_addr(s), &h, sizeof(h));
+    ring_read(sector_addr(s) + sizeof(h), &info, sizeof(info));
+
+    job_recovery_record_t r;
+    uint16_t nr = 0;
+    for (; nr < ring_records; nr++) {
+      ring_read(record_addr(s, nr), &r, sizeof(r));
+      if (r.gen != h.gen || r.crc != record_crc(r)) break;
+      merge_record(r, info);
+    }
+    DEBUG_ECHOLNPAIR("Power-loss ring sector ", int(s), " gen ", h.gen, " records ", nr);
+
+    ring_count = RING_NEW;          // The next save starts a new sector
+  }
+
+  /**
+   * Mark good snapshots as purged by clearing their size. Flash can clear
+   * bits without an erase, and the generation is kept for ring_scan.
+   */
+  void PrintJobRecovery::ring_purge() {
+    ring_begin();
+    LOOP_L_N(s, POWER_LOSS_RING_SECTORS) {
+      job_recovery_snapshot_t h;
+      if (ring_check(s, h)) {
+        const uint16_t none = 0;
+        ring_program(sector_addr(s) + offsetof(job_recovery_snapshot_t, size), &none, sizeof(none));
+      }
+    }
+    ring_count = RING_NEW;
+  }
+
+#endif // HAS_POWER_LOSS_RING
+
 /**
  * Resume the saved print job
  */
@@ -134,6 +134,37 @@ typedef struct {
 
 } job_recovery_info_t;
 
+#if EITHER(POWER_LOSS_JOURNAL, HAS_POWER_LOSS_RING)
+
+  // Written ahead of a full copy of the info
+  typedef struct {
+    uint16_t crc;                 // CRC16 of the rest of the header and the info
+    uint16_t size;                // sizeof(job_recovery_info_t), to reject other builds
+    uint32_t gen;                 // Generation, counting up from one snapshot to the next
+  } job_recovery_snapshot_t;
+
+  // The info that changes as the print goes on, appended after a snapshot
+  typedef struct {
+    uint16_t crc;                 // CRC16 of the rest of the record
+    uint16_t feedrate;
+    uint32_t gen;                 // Generation of the snapshot it follows
+    xyze_pos_t current_position;
+    float zraise;
+    uint32_t sdpos;
+    millis_t print_job_elapsed;
+    #if HAS_HOTEND
+      int16_t target_temperature[HOTENDS];
+    #endif
+    #if HAS_HEATED_BED
+      int16_t target_temperature_bed;
+    #endif
+    #if HAS_FAN
+      uint8_t fan_speed[FAN_COUNT];
+    #endif
+  } job_recovery_record_t;
+
+#endif
+
 class PrintJobRecovery {
   public:
     static const char filename[5];
@@ -174,7 +205,7 @@ class PrintJobRecovery {
     static void enable(const bool onoff);
     static void changed();
 
-    static inline bool exists() { return card.jobRecoverFileExists(); }
+    static inline bool exists() { return TERN(HAS_POWER_LOSS_RING, ring_exists(), card.jobRecoverFileExists()); }
     static inline void open(const bool read) { card.openJobRecoveryFile(read); }
     static inline void close() { file.close(); }
 
@@ -208,6 +239,31 @@ class PrintJobRecovery {
   private:
     static void write();
 
+    #if ENABLED(POWER_LOSS_JOURNAL)
+      static uint32_t journal_gen;    //!< Generation of the last snapshot
+      static uint16_t journal_count,  //!< Records written after the snapshot
+                      journal_base;   //!< CRC of the info that records don't carry
+      static bool journal_open();
+      static bool journal_check(const uint8_t s, job_recovery_snapshot_t &h);
+      static uint32_t journal_newest();
+      static bool journal_write();
+      static void journal_load();
+    #endif
+
+    #if HAS_POWER_LOSS_RING
+      static uint32_t ring_gen;       //!< Generation of the snapshot being appended to
+      static uint8_t ring_sector;     //!< Sector holding that snapshot
+      static uint16_t ring_count,     //!< Records written after the snapshot
+                      ring_base;      //!< CRC of the info that records don't carry
+      static bool ring_check(const uint8_t s, job_recovery_snapshot_t &h);
+      static int8_t ring_scan(uint32_t &newest);
+      static bool ring_exists();
+      static void ring_prepare();
+      static bool ring_write();
+      static void ring_load();
+      static void ring_purge();
+    #endif
+
     #if ENABLED(BACKUP_POWER_SUPPLY)
       static void retract_and_lift(const float &zraise);
     #endif
@@ -141,7 +141,7 @@
 
 constexpr float g26_e_axis_feedrate = 0.025;
 
-static MeshFlags circle_flags, horizontal_mesh_line_flags, vertical_mesh_line_flags;
+static MeshFlags circle_flags;
 float g26_random_deviation = 0.0;
 
 static bool g26_retracted = false; // Track the retracted state of the nozzle so mismatched
@@ -174,14 +174,14 @@ int8_t g26_prime_flag;
 
 #endif
 
-mesh_index_pair find_closest_circle_to_print(const xy_pos_t &pos) {
+mesh_index_pair find_closest_circle_to_print(const xy_pos_t &pos, MeshFlags &done) {
   float closest = 99999.99;
   mesh_index_pair out_point;
 
   out_point.pos = -1;
 
   GRID_LOOP(i, j) {
-    if (!circle_flags.marked(i, j)) {
+    if (!done.marked(i, j)) {
       // We found a circle that needs to be printed
       const xy_pos_t m = { _GET_MESH_X(i), _GET_MESH_Y(j) };
 
@@ -204,10 +204,32 @@ mesh_index_pair find_closest_circle_to_print(const xy_pos_t &pos) {
       }
     }
   }
-  circle_flags.mark(out_point); // Mark this location as done.
+  done.mark(out_point); // Mark this location as done.
   return out_point;
 }
 
+// A circle's place in the print order, as a linear mesh index
+typedef IF<(GRID_MAX_POINTS > 255), uint16_t, uint8_t>::type circle_index_t;
+
+/**
+ * Plan the order of all circles up front, with the same nearest-first
+ * search used before. With 'C' each search starts from the previous
+ * circle's center, near where the nozzle will be after printing it.
+ * Done once, before heating, so there's no whole-mesh search between
+ * the printed features.
+ */
+void plan_circle_order(circle_index_t order[GRID_MAX_POINTS], const bool continue_with_closest) {
+  MeshFlags planned;
+  planned.reset();
+  xy_pos_t pos = continue_with_closest ? xy_pos_t(current_position) : g26_xy_pos;
+  for (circle_index_t n = 0; n < GRID_MAX_POINTS; n++) {
+    const xy_int8_t ij = find_closest_circle_to_print(pos, planned);
+    order[n] = circle_index_t(ij.x) * (GRID_MAX_POINTS_Y) + ij.y;
+    if (continue_with_closest) pos.set(_GET_MESH_X(ij.x), _GET_MESH_Y(ij.y));
+    idle();
+  }
+}
+
 void move_to(const float &rx, const float &ry, const float &z, const float &e_delta) {
   static float last_z = -999.99;
 
@@ -295,56 +317,50 @@ void print_line_from_here_to_there(const xyz_pos_t &s, const xyz_pos_t &e) {
   move_to(e, e_pos_delta);  // Get to the ending point with an appropriate amount of extrusion
 }
 
-inline bool look_for_lines_to_connect() {
+// Print the line joining the circles at i,j and i+1,j
+void connect_right(const uint8_t i, const uint8_t j) {
   xyz_pos_t s, e;
   s.z = e.z = g26_layer_height;
+  s.x = _GET_MESH_X(  i  ) + (INTERSECTION_CIRCLE_RADIUS - (CROSSHAIRS_SIZE)); // right edge
+  e.x = _GET_MESH_X(i + 1) - (INTERSECTION_CIRCLE_RADIUS - (CROSSHAIRS_SIZE)); // left edge
 
-  GRID_LOOP(i, j) {
-
-    if (TERN0(HAS_LCD_MENU, user_canceled())) return true;
+  LIMIT(s.x, X_MIN_POS + 1, X_MAX_POS - 1);
+  s.y = e.y = constrain(_GET_MESH_Y(j), Y_MIN_POS + 1, Y_MAX_POS - 1);
+  LIMIT(e.x, X_MIN_POS + 1, X_MAX_POS - 1);
 
-    if (i < (GRID_MAX_POINTS_X)) {  // Can't connect to anything farther to the right than GRID_MAX_POINTS_X.
-                                    // Already a half circle at the edge of the bed.
-
-      if (circle_flags.marked(i, j) && circle_flags.marked(i + 1, j)) {   // Test whether a leftward line can be done
-        if (!horizontal_mesh_line_flags.marked(i, j)) {
-          // Two circles need a horizontal line to connect them
-          s.x = _GET_MESH_X(  i  ) + (INTERSECTION_CIRCLE_RADIUS - (CROSSHAIRS_SIZE)); // right edge
-          e.x = _GET_MESH_X(i + 1) - (INTERSECTION_CIRCLE_RADIUS - (CROSSHAIRS_SIZE)); // left edge
-
-          LIMIT(s.x, X_MIN_POS + 1, X_MAX_POS - 1);
-          s.y = e.y = constrain(_GET_MESH_Y(j), Y_MIN_POS + 1, Y_MAX_POS - 1);
-          LIMIT(e.x, X_MIN_POS + 1, X_MAX_POS - 1);
-
-          if (position_is_reachable(s.x, s.y) && position_is_reachable(e.x, e.y))
-            print_line_from_here_to_there(s, e);
+  if (position_is_reachable(s.x, s.y) && position_is_reachable(e.x, e.y))
+    print_line_from_here_to_there(s, e);
+}
 
-          horizontal_mesh_line_flags.mark(i, j); // Mark done, even if skipped
-        }
-      }
+// Print the line joining the circles at i,j and i,j+1
+void connect_back(const uint8_t i, const uint8_t j) {
+  xyz_pos_t s, e;
+  s.z = e.z = g26_layer_height;
+  s.y = _GET_MESH_Y(  j  ) + (INTERSECTION_CIRCLE_RADIUS - (CROSSHAIRS_SIZE)); // top edge
+  e.y = _GET_MESH_Y(j + 1) - (INTERSECTION_CIRCLE_RADIUS - (CROSSHAIRS_SIZE)); // bottom edge
 
-      if (j < (GRID_MAX_POINTS_Y)) {  // Can't connect to anything further back than GRID_MAX_POINTS_Y.
-                                      // Already a half circle at the edge of the bed.
+  s.x = e.x = constrain(_GET_MESH_X(i), X_MIN_POS + 1, X_MAX_POS - 1);
+  LIMIT(s.y, Y_MIN_POS + 1, Y_MAX_POS - 1);
+  LIMIT(e.y, Y_MIN_POS + 1, Y_MAX_POS - 1);
 
-        if (circle_flags.marked(i, j) && circle_flags.marked(i, j + 1)) {   // Test whether a downward line can be done
-          if (!vertical_mesh_line_flags.marked(i, j)) {
-            // Two circles that need a vertical line to connect them
-            s.y = _GET_MESH_Y(  j  ) + (INTERSECTION_CIRCLE_RADIUS - (CROSSHAIRS_SIZE)); // top edge
-            e.y = _GET_MESH_Y(j + 1) - (INTERSECTION_CIRCLE_RADIUS - (CROSSHAIRS_SIZE)); // bottom edge
+  if (position_is_reachable(s.x, s.y) && position_is_reachable(e.x, e.y))
+    print_line_from_here_to_there(s, e);
+}
 
-            s.x = e.x = constrain(_GET_MESH_X(i), X_MIN_POS + 1, X_MAX_POS - 1);
-            LIMIT(s.y, Y_MIN_POS + 1, Y_MAX_POS - 1);
-            LIMIT(e.y, Y_MIN_POS + 1, Y_MAX_POS - 1);
+/**
+ * Connect the circle just done to its finished neighbors. Only lines
+ * touching this circle can have become printable, and each line gets
+ * printed exactly once, when the second of its two circles is done.
+ */
+inline bool look_for_lines_to_connect(const xy_int8_t &pos) {
+  if (TERN0(HAS_LCD_MENU, user_canceled())) return true;
 
-            if (position_is_reachable(s.x, s.y) && position_is_reachable(e.x, e.y))
-              print_line_from_here_to_there(s, e);
+  const uint8_t i = pos.x, j = pos.y;
+  if (i > 0 && circle_flags.marked(i - 1, j)) connect_right(i - 1, j);
+  if (i < (GRID_MAX_POINTS_X) - 1 && circle_flags.marked(i + 1, j)) connect_right(i, j);
+  if (j > 0 && circle_flags.marked(i, j - 1)) connect_back(i, j - 1);
+  if (j < (GRID_MAX_POINTS_Y) - 1 && circle_flags.marked(i, j + 1)) connect_back(i, j);
 
-            vertical_mesh_line_flags.mark(i, j); // Mark done, even if skipped
-          }
-        }
-      }
-    }
-  }
   return false;
 }
 
@@ -665,6 +681,11 @@ void GcodeSuite::G26() {
     planner.calculate_volumetric_multipliers();
   #endif
 
+  // Plan the whole pattern before heating so it costs nothing later
+  circle_index_t circle_order[GRID_MAX_POINTS];
+  plan_circle_order(circle_order, g26_continue_with_closest);
+  const circle_index_t circle_count = _MIN(g26_repeats, GRID_MAX_POINTS);
+
   if (turn_on_heaters() != G26_OK) goto LEAVE;
 
   current_position.e = 0.0;
@@ -683,8 +704,6 @@ void GcodeSuite::G26() {
    */
 
   circle_flags.reset();
-  horizontal_mesh_line_flags.reset();
-  vertical_mesh_line_flags.reset();
 
   // Move nozzle to the specified height for the first layer
   destination = current_position;
@@ -714,20 +733,19 @@ void GcodeSuite::G26() {
 
   #endif // !ARC_SUPPORT
 
-  mesh_index_pair location;
-  do {
-    // Find the nearest confluence
-    location = find_closest_circle_to_print(g26_continue_with_closest ? xy_pos_t(current_position) : g26_xy_pos);
+  for (circle_index_t n = 0; n < circle_count; n++) {
+    // The next confluence, in the planned order
+    const xy_int8_t st = { int8_t(circle_order[n] / (GRID_MAX_POINTS_Y)), int8_t(circle_order[n] % (GRID_MAX_POINTS_Y)) };
+    circle_flags.mark(st);
 
-    if (location.valid()) {
-      const xy_pos_t circle = _GET_MESH_POS(location.pos);
+    const xy_pos_t circle = _GET_MESH_POS(st);
 
-      // If this mesh location is outside the printable radius, skip it.
-      if (!position_is_reachable(circle)) continue;
+    // If this mesh location is outside the printable radius, skip it
+    // but still join it to any neighbors that are already done.
+    if (position_is_reachable(circle)) {
 
       // Determine where to start and end the circle,
       // which is always drawn counter-clockwise.
-      const xy_int8_t st = location;
       const bool f = st.y == 0,
                  r = st.x >= GRID_MAX_POINTS_X - 1,
                  b = st.y >= GRID_MAX_POINTS_Y - 1;
@@ -827,17 +845,15 @@ void GcodeSuite::G26() {
           #endif
 
           print_line_from_here_to_there(p, q);
-          SERIAL_FLUSH();   // Prevent host M105 buffer overrun.
         }
 
       #endif // !ARC_SUPPORT
-
-      if (look_for_lines_to_connect()) goto LEAVE;
     }
 
-    SERIAL_FLUSH(); // Prevent host M105 buffer overrun.
+    if (look_for_lines_to_connect(st)) goto LEAVE;
 
-  } while (--g26_repeats && location.valid());
+    SERIAL_FLUSH(); // Prevent host M105 buffer overrun.
+  }
 
   LEAVE:
   ui.set_status_P(GET_TEXT(MSG_G26_LEAVING), -1);
@@ -46,7 +46,7 @@
   #include "../../../lcd/ultralcd.h"
 #endif
 
-#if ENABLED(AUTO_BED_LEVELING_LINEAR)
+#if EITHER(AUTO_BED_LEVELING_LINEAR, ABL_DRIFT_UPDATE)
   #include "../../../libs/least_squares_fit.h"
 #endif
 
@@ -85,6 +85,123 @@
 
 #define G29_RETURN(b) return TERN_(G29_RETRY_AND_RECOVER, b)
 
+#if ENABLED(ABL_DRIFT_UPDATE)
+
+  /**
+   * Update the stored grid for changes since it was probed, e.g., by thermal expansion.
+   *
+   * - Probe the four corners and the center of the grid.
+   * - Fit the changes from the stored grid to a plane.
+   * - Each quadrant whose corner fits the plane gets the plane added to it.
+   *   Quadrants that don't fit (or all of them if the center doesn't fit) are re-probed.
+   *
+   * The new grid is only stored once every point is done, so a failure leaves the old one.
+   * Return true on failure.
+   */
+  static bool g29_drift_update(const uint8_t verbose_level) {
+    constexpr uint8_t MX = (GRID_MAX_POINTS_X) - 1, MY = (GRID_MAX_POINTS_Y) - 1;
+    constexpr uint8_t NSAMPLES = 5, CENTER = 4;
+
+    // The corner of each quadrant, in quadrant order, then the center
+    static xy_uint8_t samples[NSAMPLES] = { { 0, 0 }, { MX, 0 }, { 0, MY }, { MX, MY }, { MX / 2, MY / 2 } };
+    auto quadrant = [](const uint8_t i, const uint8_t j) -> uint8_t { return (i * 2 > MX) + (j * 2 > MY) * 2; };
+    auto mesh_pos = [](const xy_uint8_t &ij) -> xy_pos_t { return { _GET_MESH_X(ij.x), _GET_MESH_Y(ij.y) }; };
+
+    const bool was_enabled = planner.leveling_active;
+
+    planner.synchronize();
+    remember_feedrate_scaling_off();
+    set_bed_leveling_enabled(false);
+
+    auto failed = [&]{
+      probe.stow();
+      set_bed_leveling_enabled(was_enabled);
+      restore_feedrate_and_scaling();
+      return true;
+    };
+
+    // Deploy certain probes before starting probing
+    if (ENABLED(BLTOUCH))
+      do_z_clearance(Z_CLEARANCE_DEPLOY_PROBE);
+    else if (probe.deploy())
+      return failed();
+
+    // Probe the samples and fit the changes to a plane
+    float measured[NSAMPLES];
+    struct linear_fit_data lsf_results;
+    incremental_LSF_reset(&lsf_results);
+    LOOP_L_N(s, NSAMPLES) {
+      const xy_uint8_t &ij = samples[s];
+      const xy_pos_t pos = mesh_pos(ij);
+      measured[s] = probe.probe_at_point(pos, PROBE_PT_RAISE, verbose_level);
+      if (isnan(measured[s])) return failed();
+      incremental_LSF(&lsf_results, pos, measured[s] - z_values[ij.x][ij.y]);
+      idle_no_sleep();
+    }
+
+    const bool fit_failed = finish_incremental_LSF(&lsf_results);
+    auto drift_at = [&](const xy_pos_t &pos) { return -(lsf_results.A * pos.x + lsf_results.B * pos.y + lsf_results.D); };
+
+    // A quadrant is kept if its corner (and the center) fit the plane
+    uint8_t reprobe = 0;
+    LOOP_L_N(s, NSAMPLES) {
+      const xy_uint8_t &ij = samples[s];
+      const float residual = fit_failed ? 999 : measured[s] - z_values[ij.x][ij.y] - drift_at(mesh_pos(ij));
+      if (ABS(residual) > ABL_DRIFT_TOLERANCE) reprobe |= (s == CENTER) ? 0x0F : _BV(s);
+      if (verbose_level) SERIAL_ECHOLNPAIR("Drift sample ", int(s + 1), " residual: ", residual);
+    }
+
+    if (verbose_level) {
+      SERIAL_ECHOPAIR_F("Drift plane A: ", lsf_results.A, 6);
+      SERIAL_ECHOPAIR_F(" B: ", lsf_results.B, 6);
+      SERIAL_ECHOPAIR_F(" D: ", lsf_results.D, 6);
+      SERIAL_EOL();
+    }
+
+    // Work out the new grid in zig-zag order, re-probing where the plane doesn't fit
+    bed_mesh_t new_z;
+    bool zig = true;
+    LOOP_L_N(j, GRID_MAX_POINTS_Y) {
+      LOOP_L_N(n, GRID_MAX_POINTS_X) {
+        const uint8_t i = zig ? n : MX - n;
+        const xy_uint8_t ij = { i, uint8_t(j) };
+        const xy_pos_t pos = mesh_pos(ij);
+        float newz = NAN;
+        LOOP_L_N(s, NSAMPLES) if (samples[s] == ij) newz = measured[s];
+        if (isnan(newz)) {
+          if (TEST(reprobe, quadrant(i, j))) {
+            newz = probe.probe_at_point(pos, PROBE_PT_RAISE, verbose_level);
+            if (isnan(newz)) return failed();
+            idle_no_sleep();
+          }
+          else
+            newz = z_values[i][j] + drift_at(pos);
+        }
+        new_z[i][j] = newz;
+      }
+      zig ^= true;
+    }
+
+    GRID_LOOP(i, j) {
+      z_values[i][j] = new_z[i][j];
+      TERN_(EXTENSIBLE_UI, ExtUI::onMeshUpdate(i, j, z_values[i][j]));
+    }
+
+    SERIAL_ECHOLNPAIR("Drift update re-probed ", int(!!(reprobe & 1) + !!(reprobe & 2) + !!(reprobe & 4) + !!(reprobe & 8)), " of 4 quadrants.");
+
+    probe.stow();
+    refresh_bed_level();
+    if (verbose_level) print_bilinear_leveling_grid();
+
+    set_bed_leveling_enabled(true);
+    restore_feedrate_and_scaling();
+    probe.move_z_after_probing();
+    report_current_position();
+    return false;
+  }
+
+#endif // ABL_DRIFT_UPDATE
+
 /**
  * G29: Detailed Z probe, probes the bed at 3 or more points.
  *      Will fail if the printer has not been homed with G28.
@@ -156,11 +273,21 @@
  *  Y  Y for mesh point, overrides J
  *  Z  Z for mesh point. Otherwise, raw current Z.
  *
+ * With ABL_DRIFT_UPDATE:
+ *
+ *  U  Update the stored grid for drift. Probe the corners and center, apply
+ *     the fitted change where it fits and re-probe the quadrants that don't.
+ *
  * Without PROBE_MANUALLY:
  *
  *  E  By default G29 will engage the Z probe, test the bed, then disengage.
  *     Include "E" to engage/disengage the Z probe for each sample.
  *     There's no extra effect if you have a fixed Z probe.
+ *
+ * With PROBE_ON_THE_FLY:
+ *
+ *  K  Fly over the grid points without a full raise between them. (Default 1)
+ *     Use 'K0' to probe each point the usual way.
  */
 G29_TYPE GcodeSuite::G29() {
 
@@ -303,6 +430,16 @@ G29_TYPE GcodeSuite::G29() {
         G29_RETURN(false);
       } // parser.seen('W')
 
+      #if ENABLED(ABL_DRIFT_UPDATE)
+        if (parser.seen('U')) {
+          if (!leveling_is_valid()) {
+            SERIAL_ERROR_MSG("No bilinear grid");
+            G29_RETURN(false);
+          }
+          G29_RETURN(g29_drift_update(parser.intval('V')));
+        }
+      #endif
+
     #else
 
       constexpr bool seen_w = false;
@@ -594,6 +731,11 @@ G29_TYPE GcodeSuite::G29() {
   {
     const ProbePtRaise raise_after = parser.boolval('E') ? PROBE_PT_STOW : PROBE_PT_RAISE;
 
+    #if ENABLED(PROBE_ON_THE_FLY)
+      const bool fly = !faux && raise_after != PROBE_PT_STOW && parser.boolval('K', true);
+      probe.fly_reset();
+    #endif
+
     measured_z = 0;
 
     #if ABL_GRID
@@ -709,7 +851,12 @@ G29_TYPE GcodeSuite::G29() {
           if (verbose_level) SERIAL_ECHOLNPAIR("Probing mesh point ", int(pt_index), "/", abl_points, ".");
           TERN_(HAS_DISPLAY, ui.status_printf_P(0, PSTR(S_FMT " %i/%i"), GET_TEXT(MSG_PROBING_MESH), int(pt_index), int(abl_points)));
 
-          measured_z = faux ? 0.001f * random(-100, 101) : probe.probe_at_point(probePos, raise_after, verbose_level);
+          #if ENABLED(PROBE_ON_THE_FLY)
+            if (fly)
+              measured_z = probe.fly_at_point(probePos, verbose_level);
+            else
+          #endif
+              measured_z = faux ? 0.001f * random(-100, 101) : probe.probe_at_point(probePos, raise_after, verbose_level);
 
           if (isnan(measured_z)) {
             set_bed_leveling_enabled(abl_should_enable);
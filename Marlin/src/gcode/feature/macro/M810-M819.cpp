@@ -25,10 +25,8 @@
 #if ENABLED(GCODE_MACROS)
 
 #include "../../gcode.h"
-#include "../../queue.h"
 #include "../../parser.h"
-
-char gcode_macros[GCODE_MACROS_SLOTS][GCODE_MACROS_SLOT_SIZE + 1] = {{ 0 }};
+#include "../../../feature/gcode_macros.h"
 
 /**
  * M810_819: Set/execute a G-code macro.
@@ -36,30 +34,20 @@ char gcode_macros[GCODE_MACROS_SLOTS][GCODE_MACROS_SLOT_SIZE + 1] = {{ 0 }};
  * Usage:
  *   M810 <command>|...   Set Macro 0 to the given commands, separated by the pipe character
  *   M810                 Execute Macro 0
+ *
+ * All the commands of a macro run in place, before any other queued command.
  */
 void GcodeSuite::M810_819() {
   const uint8_t index = parser.codenum - 810;
   if (index >= GCODE_MACROS_SLOTS) return;
 
-  const size_t len = strlen(parser.string_arg);
-
-  if (len) {
+  if (*parser.string_arg) {
     // Set a macro
-    if (len > GCODE_MACROS_SLOT_SIZE)
+    if (!gcode_macros.set(index, parser.string_arg))
       SERIAL_ERROR_MSG("Macro too long.");
-    else {
-      char c, *s = parser.string_arg, *d = gcode_macros[index];
-      do {
-        c = *s++;
-        *d++ = c == '|' ? '\n' : c;
-      } while (c);
-    }
-  }
-  else {
-    // Execute a macro
-    char * const cmd = gcode_macros[index];
-    if (strlen(cmd)) process_subcommands_now(cmd);
   }
+  else
+    gcode_macros.run(index);  // Execute a macro
 }
 
 #endif // GCODE_MACROS
@@ -239,6 +239,646 @@ void GcodeSuite::dwell(millis_t time) {
   extern void M100_dump_routine(PGM_P const title, const char * const start, const char * const end);
 #endif
 
+#if ENABLED(GCODE_DISPATCH_TABLE)
+
+  void GcodeSuite::G0() { G0_G1(TERN_(HAS_FAST_MOVES, true)); }
+  void GcodeSuite::G1() { G0_G1(TERN_(HAS_FAST_MOVES, false)); }
+  #if ENABLED(ARC_SUPPORT) && DISABLED(SCARA)
+    void GcodeSuite::G2() { G2_G3(true); }
+    void GcodeSuite::G3() { G2_G3(false); }
+  #endif
+  #if ENABLED(G38_PROBE_TARGET)
+    void GcodeSuite::G38_subcode() {
+      if (WITHIN(parser.subcode, 2, TERN(G38_PROBE_AWAY, 5, 3))) G38(parser.subcode);
+    }
+  #endif
+  void GcodeSuite::G90() { set_relative_mode(false); }
+  void GcodeSuite::G91() { set_relative_mode(true); }
+  #if HAS_CUTTER
+    void GcodeSuite::M3() { M3_M4(false); }
+    void GcodeSuite::M4() { M3_M4(true); }
+  #endif
+  #if ENABLED(FWRETRACT_AUTORETRACT)
+    void GcodeSuite::M209_autoretract() { if (MIN_AUTORETRACT <= MAX_AUTORETRACT) M209(); }
+  #endif
+  void GcodeSuite::ignore_command() {}
+
+  // Strictly ascending codes are required by the binary search
+  static constexpr bool dispatch_sorted(const GcodeSuite::dispatch_t * const t, const size_t n) {
+    return n < 2 || (t[0].code < t[1].code && dispatch_sorted(t + 1, n - 1));
+  }
+
+  #define _GC(N,F) { N, &GcodeSuite::F, 0 }
+
+  // Get the table for a command letter and its size (and statistics), or nullptr
+  const GcodeSuite::dispatch_t* GcodeSuite::dispatch_table(const char letter, uint16_t &size
+    #if ENABLED(GCODE_DISPATCH_STATS)
+      , dispatch_stats_t* &stats
+    #endif
+  ) {
+
+    static constexpr dispatch_t g_table[] PROGMEM = {
+      _GC(  0, G0),                                       // G0: Fast Move
+      _GC(  1, G1),                                       // G1: Linear Move
+      #if ENABLED(ARC_SUPPORT) && DISABLED(SCARA)
+        _GC(  2, G2),                                     // G2: CW ARC
+        _GC(  3, G3),                                     // G3: CCW ARC
+      #endif
+      _GC(  4, G4),                                       // G4: Dwell
+      #if ENABLED(BEZIER_CURVE_SUPPORT)
+        _GC(  5, G5),                                     // G5: Cubic B_spline
+      #endif
+      #if ENABLED(DIRECT_STEPPING)
+        _GC(  6, G6),                                     // G6: Direct Stepper Move
+      #endif
+      _GC(  8, G1),                                       // G8: Linear Move
+      #if ENABLED(FWRETRACT)
+        _GC( 10, G10),                                    // G10: Retract / Swap Retract
+        _GC( 11, G11),                                    // G11: Recover / Swap Recover
+      #endif
+      #if ENABLED(NOZZLE_CLEAN_FEATURE)
+        _GC( 12, G12),                                    // G12: Nozzle Clean
+      #endif
+      #if ENABLED(CNC_WORKSPACE_PLANES)
+        _GC( 17, G17),                                    // G17: Select Plane XY
+        _GC( 18, G18),                                    // G18: Select Plane ZX
+        _GC( 19, G19),                                    // G19: Select Plane YZ
+      #endif
+      #if ENABLED(INCH_MODE_SUPPORT)
+        _GC( 20, G20),                                    // G20: Inch Mode
+        _GC( 21, G21),                                    // G21: MM Mode
+      #else
+        _GC( 21, ignore_command),                         // No error on unknown G21
+      #endif
+      #if ENABLED(G26_MESH_VALIDATION)
+        _GC( 26, G26),                                    // G26: Mesh Validation Pattern generation
+      #endif
+      #if ENABLED(NOZZLE_PARK_FEATURE)
+        _GC( 27, G27),                                    // G27: Nozzle Park
+      #endif
+      _GC( 28, G28),                                      // G28: Home one or more axes
+      #if HAS_LEVELING
+        _GC( 29, TERN(G29_RETRY_AND_RECOVER, G29_with_retry, G29)),     // G29: Bed leveling calibration
+      #endif
+      #if HAS_BED_PROBE
+        _GC( 30, G30),                                    // G30: Single Z probe
+        #if ENABLED(Z_PROBE_SLED)
+          _GC( 31, G31),                                  // G31: dock the sled
+          _GC( 32, G32),                                  // G32: undock the sled
+        #endif
+      #endif
+      #if ENABLED(DELTA_AUTO_CALIBRATION)
+        _GC( 33, G33),                                    // G33: Delta Auto-Calibration
+      #endif
+      #if EITHER(Z_STEPPER_AUTO_ALIGN, MECHANICAL_GANTRY_CALIBRATION)
+        _GC( 34, G34),                                    // G34: Z Stepper automatic alignment using probe
+      #endif
+      #if ENABLED(ASSISTED_TRAMMING)
+        _GC( 35, G35),                                    // G35: Read four bed corners to help adjust bed screws
+      #endif
+      #if ENABLED(G38_PROBE_TARGET)
+        _GC( 38, G38_subcode),                            // G38.2 - G38.5: Probe towards / away from target
+      #endif
+      #if HAS_MESH
+        _GC( 42, G42),                                    // G42: Coordinated move to a mesh point
+      #endif
+      #if ENABLED(CNC_COORDINATE_SYSTEMS)
+        _GC( 53, G53),                                    // G53: (prefix) Apply native workspace
+        _GC( 54, G54),                                    // G54: Switch to Workspace 1
+        _GC( 55, G55),                                    // G55: Switch to Workspace 2
+        _GC( 56, G56),                                    // G56: Switch to Workspace 3
+        _GC( 57, G57),                                    // G57: Switch to Workspace 4
+        _GC( 58, G58),                                    // G58: Switch to Workspace 5
+        _GC( 59, G59),                                    // G59.0 - G59.3: Switch to Workspace 6-9
+      #endif
+      #if SAVED_POSITIONS
+        _GC( 60, G60),                                    // G60: save current position
+        _GC( 61, G61),                                    // G61: Apply/restore saved coordinates
+      #endif
+      #if ENABLED(PROBE_TEMP_COMPENSATION)
+        _GC( 76, G76),                                    // G76: Calibrate first layer compensation values
+      #endif
+      #if ENABLED(GCODE_MOTION_MODES)
+        _GC( 80, G80),                                    // G80: Reset the current motion mode
+      #endif
+      _GC( 90, G90),                                      // G90: Absolute Mode
+      _GC( 91, G91),                                      // G91: Relative Mode
+      _GC( 92, G92),                                      // G92: Set current axis position(s)
+      #if ENABLED(CALIBRATION_GCODE)
+        _GC(425, G425),                                   // G425: Perform calibration with calibration cube
+      #endif
+      #if ENABLED(DEBUG_GCODE_PARSER)
+        { 800, &GCodeParser::debug, 0 },                  // G800: GCode Parser Test for G
+      #endif
+    };
+
+    static constexpr dispatch_t m_table[] PROGMEM = {
+      #if HAS_RESUME_CONTINUE
+        _GC(   0, M0_M1),                                 // M0: Unconditional stop - Wait for user button press on LCD
+        _GC(   1, M0_M1),                                 // M1: Conditional stop - Wait for user button press on LCD
+      #endif
+      #if HAS_CUTTER
+        _GC(   3, M3),                                    // M3: Turn ON Laser | Spindle (clockwise), set Power | Speed
+        _GC(   4, M4),                                    // M4: Turn ON Laser | Spindle (counter-clockwise), set Power | Speed
+        _GC(   5, M5),                                    // M5: Turn OFF Laser | Spindle
+      #endif
+      #if ENABLED(COOLANT_CONTROL)
+        #if ENABLED(COOLANT_MIST)
+          _GC(   7, M7),                                  // M7: Mist coolant ON
+        #endif
+        #if ENABLED(COOLANT_FLOOD)
+          _GC(   8, M8),                                  // M8: Flood coolant ON
+        #endif
+        _GC(   9, M9),                                    // M9: Coolant OFF
+      #endif
+      #if ENABLED(EXTERNAL_CLOSED_LOOP_CONTROLLER)
+        _GC(  12, M12),                                   // M12: Synchronize and optionally force a CLC set
+      #endif
+      #if ENABLED(EXPECTED_PRINTER_CHECK)
+        _GC(  16, M16),                                   // M16: Expected printer check
+      #endif
+      _GC(  17, M17),                                     // M17: Enable all stepper motors
+      _GC(  18, M18_M84),                                 // M18: Disable Steppers / Set Timeout
+      #if ENABLED(SDSUPPORT)
+        _GC(  20, M20),                                   // M20: List SD card
+        _GC(  21, M21),                                   // M21: Init SD card
+        _GC(  22, M22),                                   // M22: Release SD card
+        _GC(  23, M23),                                   // M23: Select file
+        _GC(  24, M24),                                   // M24: Start SD print
+        _GC(  25, M25),                                   // M25: Pause SD print
+        _GC(  26, M26),                                   // M26: Set SD index
+        _GC(  27, M27),                                   // M27: Get SD status
+        _GC(  28, M28),                                   // M28: Start SD write
+        _GC(  29, M29),                                   // M29: Stop SD write
+        _GC(  30, M30),                                   // M30 <filename> Delete File
+      #endif
+      _GC(  31, M31),                                     // M31: Report time since the start of SD print or last M109
+      #if ENABLED(SDSUPPORT)
+        _GC(  32, M32),                                   // M32: Select file and start SD print
+        #if ENABLED(LONG_FILENAME_HOST_SUPPORT)
+          _GC(  33, M33),                                 // M33: Get the long full path to a file or folder
+        #endif
+        #if BOTH(SDCARD_SORT_ALPHA, SDSORT_GCODE)
+          _GC(  34, M34),                                 // M34: Set SD card sorting options
+        #endif
+      #endif
+      #if ENABLED(DIRECT_PIN_CONTROL)
+        _GC(  42, M42),                                   // M42: Change pin state
+      #endif
+      #if ENABLED(PINS_DEBUGGING)
+        _GC(  43, M43),                                   // M43: Read pin state
+      #endif
+      #if ENABLED(Z_MIN_PROBE_REPEATABILITY_TEST)
+        _GC(  48, M48),                                   // M48: Z probe repeatability test
+      #endif
+      #if ENABLED(LCD_SET_PROGRESS_MANUALLY)
+        _GC(  73, M73),                                   // M73: Set progress percentage (for display on LCD)
+      #endif
+      _GC(  75, M75),                                     // M75: Start print timer
+      _GC(  76, M76),                                     // M76: Pause print timer
+      _GC(  77, M77),                                     // M77: Stop print timer
+      #if ENABLED(PRINTCOUNTER)
+        _GC(  78, M78),                                   // M78: Show print statistics
+      #endif
+      #if ENABLED(PSU_CONTROL)
+        _GC(  80, M80),                                   // M80: Turn on Power Supply
+      #endif
+      _GC(  81, M81),                                     // M81: Turn off Power, including Power Supply, if possible
+      _GC(  82, M82),                                     // M82: Set E axis normal mode (same as other axes)
+      _GC(  83, M83),                                     // M83: Set E axis relative mode
+      _GC(  84, M18_M84),                                 // M84: Disable Steppers / Set Timeout
+      _GC(  85, M85),                                     // M85: Set inactivity stepper shutdown timeout
+      _GC(  92, M92),                                     // M92: Set the steps-per-unit for one or more axes
+      #if ENABLED(M100_FREE_MEMORY_WATCHER)
+        _GC( 100, M100),                                  // M100: Free Memory Report
+      #endif
+      #if EXTRUDERS
+        _GC( 104, M104),                                  // M104: Set hot end temperature
+      #endif
+      { 105, &GcodeSuite::M105, GC_NO_OK },               // M105: Report Temperatures (and say "ok")
+      #if HAS_FAN
+        _GC( 106, M106),                                  // M106: Fan On
+        _GC( 107, M107),                                  // M107: Fan Off
+      #endif
+      _GC( 108, TERN(EMERGENCY_PARSER, ignore_command, M108)),    // M108: Cancel Waiting
+      #if EXTRUDERS
+        _GC( 109, M109),                                  // M109: Wait for hotend temperature to reach target
+      #endif
+      _GC( 110, M110),                                    // M110: Set Current Line Number
+      _GC( 111, M111),                                    // M111: Set debug level
+      _GC( 112, TERN(EMERGENCY_PARSER, ignore_command, M112)),    // M112: Full Shutdown
+      #if ENABLED(HOST_KEEPALIVE_FEATURE)
+        _GC( 113, M113),                                  // M113: Set Host Keepalive interval
+      #endif
+      _GC( 114, M114),                                    // M114: Report current position
+      _GC( 115, M115),                                    // M115: Report capabilities
+      _GC( 117, M117),                                    // M117: Set LCD message text, if possible
+      _GC( 118, M118),                                    // M118: Display a message in the host console
+      _GC( 119, M119),                                    // M119: Report endstop states
+      _GC( 120, M120),                                    // M120: Enable endstops
+      _GC( 121, M121),                                    // M121: Disable endstops
+      #if HAS_TRINAMIC_CONFIG || HAS_L64XX
+        _GC( 122, M122),                                  // M122: Report driver configuration and status
+      #endif
+      #if ENABLED(PARK_HEAD_ON_PAUSE)
+        _GC( 125, M125),                                  // M125: Store current position and move to filament change position
+      #endif
+      #if ENABLED(BARICUDA)
+        #if HAS_HEATER_1
+          _GC( 126, M126),                                // M126: valve open
+          _GC( 127, M127),                                // M127: valve closed
+        #endif
+        #if HAS_HEATER_2
+          _GC( 128, M128),                                // M128: valve open
+          _GC( 129, M129),                                // M129: valve closed
+        #endif
+      #endif
+      #if HAS_HEATED_BED
+        _GC( 140, M140),                                  // M140: Set bed temperature
+      #endif
+      #if HAS_HEATED_CHAMBER
+        _GC( 141, M141),                                  // M141: Set chamber temperature
+      #endif
+      #if PREHEAT_COUNT
+        _GC( 145, M145),                                  // M145: Set material heatup parameters
+      #endif
+      #if ENABLED(TEMPERATURE_UNITS_SUPPORT)
+        _GC( 149, M149),                                  // M149: Set temperature units
+      #endif
+      #if HAS_COLOR_LEDS
+        _GC( 150, M150),                                  // M150: Set Status LED Color
+      #endif
+      #if BOTH(AUTO_REPORT_TEMPERATURES, HAS_TEMP_SENSOR)
+        _GC( 155, M155),                                  // M155: Set temperature auto-report interval
+      #endif
+      #if ENABLED(MIXING_EXTRUDER)
+        _GC( 163, M163),                                  // M163: Set a component weight for mixing extruder
+        _GC( 164, M164),                                  // M164: Save current mix as a virtual extruder
+        #if ENABLED(DIRECT_MIXING_IN_G1)
+          _GC( 165, M165),                                // M165: Set multiple mix weights
+        #endif
+        #if ENABLED(GRADIENT_MIX)
+          _GC( 166, M166),                                // M166: Set Gradient Mix
+        #endif
+        #if ENABLED(RANDOM_MIX)
+          _GC( 167, M167),                                // M167: Set random Mix
+        #endif
+      #endif
+      #if HAS_HEATED_BED
+        _GC( 190, M190),                                  // M190: Wait for bed temperature to reach target
+      #endif
+      #if HAS_HEATED_CHAMBER
+        _GC( 191, M191),                                  // M191: Wait for chamber temperature to reach target
+      #endif
+      #if ENABLED(PROBE_TEMP_COMPENSATION)
+        _GC( 192, M192),                                  // M192: Wait for probe temp
+      #endif
+      #if DISABLED(NO_VOLUMETRICS)
+        _GC( 200, M200),                                  // M200: Set filament diameter, E to cubic units
+      #endif
+      _GC( 201, M201),                                    // M201: Set max acceleration for print moves (units/s^2)
+      _GC( 203, M203),                                    // M203: Set max feedrate (units/sec)
+      _GC( 204, M204),                                    // M204: Set acceleration
+      _GC( 205, M205),                                    // M205: Set advanced settings
+      #if HAS_M206_COMMAND
+        _GC( 206, M206),                                  // M206: Set home offsets
+      #endif
+      #if ENABLED(FWRETRACT)
+        _GC( 207, M207),                                  // M207: Set Retract Length, Feedrate, and Z lift
+        _GC( 208, M208),                                  // M208: Set Recover (unretract) Additional Length and Feedrate
+        #if ENABLED(FWRETRACT_AUTORETRACT)
+          _GC( 209, M209_autoretract),                    // M209: Turn Automatic Retract Detection on/off
+        #endif
+      #endif
+      #if HAS_SOFTWARE_ENDSTOPS
+        _GC( 211, M211),                                  // M211: Enable, Disable, and/or Report software endstops
+      #endif
+      #if (HAS_MULTI_EXTRUDER && FEATURE_TOOL_CHANGE)
+        _GC( 217, M217),                                  // M217: Set filament swap parameters
+      #endif
+      #if HAS_HOTEND_OFFSET
+        _GC( 218, M218),                                  // M218: Set a tool offset
+      #endif
+      _GC( 220, M220),                                    // M220: Set Feedrate Percentage: S<percent> ("FR" on your LCD)
+      #if EXTRUDERS
+        _GC( 221, M221),                                  // M221: Set Flow Percentage
+      #endif
+      #if ENABLED(DIRECT_PIN_CONTROL)
+        _GC( 226, M226),                                  // M226: Wait until a pin reaches a state
+      #endif
+      #if ENABLED(PHOTO_GCODE)
+        _GC( 240, M240),                                  // M240: Trigger a camera
+      #endif
+      #if HAS_LCD_CONTRAST
+        _GC( 250, M250),                                  // M250: Set LCD contrast
+      #endif
+      #if ENABLED(EXPERIMENTAL_I2CBUS)
+        _GC( 260, M260),                                  // M260: Send data to an i2c slave
+        _GC( 261, M261),                                  // M261: Request data from an i2c slave
+      #endif
+      #if HAS_SERVOS
+        _GC( 280, M280),                                  // M280: Set servo position absolute
+        #if ENABLED(EDITABLE_SERVO_ANGLES)
+          _GC( 281, M281),                                // M281: Set servo angles
+        #endif
+      #endif
+      #if ENABLED(BABYSTEPPING)
+        _GC( 290, M290),                                  // M290: Babystepping
+      #endif
+      #if HAS_BUZZER
+        _GC( 300, M300),                                  // M300: Play beep tone
+      #endif
+      #if ENABLED(PIDTEMP)
+        _GC( 301, M301),                                  // M301: Set hotend PID parameters
+      #endif
+      #if ENABLED(PREVENT_COLD_EXTRUSION)
+        _GC( 302, M302),                                  // M302: Allow cold extrudes (set the minimum extrude temperature)
+      #endif
+      #if HAS_PID_HEATING
+        _GC( 303, M303),                                  // M303: PID autotune
+      #endif
+      #if ENABLED(PIDTEMPBED)
+        _GC( 304, M304),                                  // M304: Set bed PID parameters
+      #endif
+      #if HAS_USER_THERMISTORS
+        _GC( 305, M305),                                  // M305: Set user thermistor parameters
+      #endif
+      #if HAS_MICROSTEPS
+        _GC( 350, M350),                                  // M350: Set microstepping mode
+        _GC( 351, M351),                                  // M351: Toggle MS1 MS2 pins directly
+      #endif
+      #if ENABLED(CASE_LIGHT_ENABLE)
+        _GC( 355, M355),                                  // M355: Set case light brightness
+      #endif
+      #if ENABLED(REPETIER_GCODE_M360)
+        _GC( 360, M360),                                  // M360: Firmware settings
+      #endif
+      #if EITHER(EXT_SOLENOID, MANUAL_SOLENOID_CONTROL)
+        _GC( 380, M380),                                  // M380: Activate solenoid on active (or specified) extruder
+        _GC( 381, M381),                                  // M381: Disable all solenoids or the active (or specified) solenoid
+      #endif
+      _GC( 400, M400),                                    // M400: Finish all moves
+      #if HAS_BED_PROBE
+        _GC( 401, M401),                                  // M401: Deploy probe
+        _GC( 402, M402),                                  // M402: Stow probe
+      #endif
+      #if ENABLED(PRUSA_MMU2)
+        _GC( 403, M403),                                  // M403: Set filament type for MMU2
+      #endif
+      #if ENABLED(FILAMENT_WIDTH_SENSOR)
+        _GC( 404, M404),                                  // M404: Enter or display the nominal filament width
+        _GC( 405, M405),                                  // M405: Turn on filament sensor for control
+        _GC( 406, M406),                                  // M406: Turn off filament sensor for control
+        _GC( 407, M407),                                  // M407: Display measured filament diameter
+      #endif
+      _GC( 410, TERN(EMERGENCY_PARSER, ignore_command, M410)),    // M410: Quickstop - Abort all the planned moves
+      #if HAS_FILAMENT_SENSOR
+        _GC( 412, M412),                                  // M412: Enable/Disable filament runout detection
+      #endif
+      #if ENABLED(POWER_LOSS_RECOVERY)
+        _GC( 413, M413),                                  // M413: Enable/disable/query Power-Loss Recovery
+      #endif
+      #if HAS_LEVELING
+        _GC( 420, M420),                                  // M420: Enable/Disable Bed Leveling
+      #endif
+      #if HAS_MESH
+        _GC( 421, M421),                                  // M421: Set a Mesh Bed Leveling Z coordinate
+      #endif
+      #if ENABLED(Z_STEPPER_AUTO_ALIGN)
+        _GC( 422, M422),                                  // M422: Set Z Stepper automatic alignment position using probe
+      #endif
+      #if ENABLED(BACKLASH_GCODE)
+        _GC( 425, M425),                                  // M425: Tune backlash compensation
+      #endif
+      #if HAS_M206_COMMAND
+        _GC( 428, M428),                                  // M428: Apply current_position to home_offset
+      #endif
+      #if HAS_POWER_MONITOR
+        _GC( 430, M430),                                  // M430: Read the system current (A), voltage (V), and power (W)
+      #endif
+      #if ENABLED(CANCEL_OBJECTS)
+        _GC( 486, M486),                                  // M486: Identify and cancel objects
+      #endif
+      _GC( 500, M500),                                    // M500: Store settings in EEPROM
+      _GC( 501, M501),                                    // M501: Read settings from EEPROM
+      _GC( 502, M502),                                    // M502: Revert to default settings
+      #if DISABLED(DISABLE_M503)
+        _GC( 503, M503),                                  // M503: print settings currently in memory
+      #endif
+      #if ENABLED(EEPROM_SETTINGS)
+        _GC( 504, M504),                                  // M504: Validate EEPROM contents
+      #endif
+      #if ENABLED(PASSWORD_FEATURE)
+        _GC( 510, M510),                                  // M510: Lock Printer
+        #if ENABLED(PASSWORD_UNLOCK_GCODE)
+          _GC( 511, M511),                                // M511: Unlock Printer
+        #endif
+        #if ENABLED(PASSWORD_CHANGE_GCODE)
+          _GC( 512, M512),                                // M512: Set/Change/Remove Password
+        #endif
+      #endif
+      #if ENABLED(SDSUPPORT)
+        _GC( 524, M524),                                  // M524: Abort the current SD print job
+      #endif
+      #if ENABLED(SD_ABORT_ON_ENDSTOP_HIT)
+        _GC( 540, M540),                                  // M540: Set abort on endstop hit for SD printing
+      #endif
+      #if BOTH(HAS_TRINAMIC_CONFIG, HAS_STEALTHCHOP)
+        _GC( 569, M569),                                  // M569: Enable stealthChop on an axis
+      #endif
+      #if ENABLED(BAUD_RATE_GCODE)
+        _GC( 575, M575),                                  // M575: Set serial baudrate
+      #endif
+      #if ENABLED(GCODE_PARSE_AHEAD)
+        _GC( 576, M576),                                  // M576: Report buffer statistics
+      #endif
+      #if ENABLED(CREDIT_FLOW_CONTROL)
+        _GC( 577, M577),                                  // M577: Set serial flow control
+      #endif
+      #if ENABLED(GCODE_DISPATCH_STATS)
+        _GC( 578, M578),                                  // M578: Report G-code dispatch statistics
+      #endif
+      #if ENABLED(ADVANCED_PAUSE_FEATURE)
+        _GC( 600, M600),                                  // M600: Pause for Filament Change
+        _GC( 603, M603),                                  // M603: Configure Filament Change
+      #endif
+      #if HAS_DUPLICATION_MODE
+        _GC( 605, M605),                                  // M605: Set Dual X Carriage movement mode
+      #endif
+      #if ENABLED(DELTA)
+        _GC( 665, M665),                                  // M665: Set delta configurations
+      #endif
+      #if ENABLED(DELTA) || HAS_EXTRA_ENDSTOPS
+        _GC( 666, M666),                                  // M666: Set delta or multiple endstop adjustment
+      #endif
+      #if ENABLED(DUET_SMART_EFFECTOR) && PIN_EXISTS(SMART_EFFECTOR_MOD)
+        _GC( 672, M672),                                  // M672: Set/clear Duet Smart Effector sensitivity
+      #endif
+      #if ENABLED(FILAMENT_LOAD_UNLOAD_GCODES)
+        _GC( 701, M701),                                  // M701: Load Filament
+        _GC( 702, M702),                                  // M702: Unload Filament
+      #endif
+      #if ENABLED(CONTROLLER_FAN_EDITABLE)
+        _GC( 710, M710),                                  // M710: Set Controller Fan settings
+      #endif
+      #if ENABLED(DEBUG_GCODE_PARSER)
+        { 800, &GCodeParser::debug, 0 },                  // M800: GCode Parser Test for M
+      #endif
+      #if ENABLED(GCODE_MACROS)
+        _GC( 810, M810_819), _GC( 811, M810_819),         // M810-M819: Define/execute G-code macro
+        _GC( 812, M810_819), _GC( 813, M810_819),
+        _GC( 814, M810_819), _GC( 815, M810_819),
+        _GC( 816, M810_819), _GC( 817, M810_819),
+        _GC( 818, M810_819), _GC( 819, M810_819),
+      #endif
+      #if HAS_BED_PROBE
+        _GC( 851, M851),                                  // M851: Set Z Probe Z Offset
+      #endif
+      #if ENABLED(SKEW_CORRECTION_GCODE)
+        _GC( 852, M852),                                  // M852: Set Skew factors
+      #endif
+      #if ENABLED(I2C_POSITION_ENCODERS)
+        _GC( 860, M860),                                  // M860: Report encoder module position
+        _GC( 861, M861),                                  // M861: Report encoder module status
+        _GC( 862, M862),                                  // M862: Perform axis test
+        _GC( 863, M863),                                  // M863: Calibrate steps/mm
+        _GC( 864, M864),                                  // M864: Change module address
+        _GC( 865, M865),                                  // M865: Check module firmware version
+        _GC( 866, M866),                                  // M866: Report axis error count
+        _GC( 867, M867),                                  // M867: Toggle error correction
+        _GC( 868, M868),                                  // M868: Set error correction threshold
+        _GC( 869, M869),                                  // M869: Report axis error
+      #endif
+      #if ENABLED(PROBE_TEMP_COMPENSATION)
+        _GC( 871, M871),                                  // M871: Print/reset/clear first layer temperature offset values
+      #endif
+      #if ENABLED(HOST_PROMPT_SUPPORT)
+        _GC( 876, TERN(EMERGENCY_PARSER, ignore_command, M876)),    // M876: Handle Host prompt responses
+      #endif
+      #if ENABLED(LIN_ADVANCE)
+        _GC( 900, M900),                                  // M900: Set advance K factor
+      #endif
+      #if HAS_TRINAMIC_CONFIG || HAS_L64XX
+        _GC( 906, M906),                                  // M906: Set motor current or drive level
+      #endif
+      #if ANY(HAS_MOTOR_CURRENT_SPI, HAS_MOTOR_CURRENT_PWM, HAS_MOTOR_CURRENT_I2C, HAS_MOTOR_CURRENT_DAC)
+        _GC( 907, M907),                                  // M907: Set digital trimpot motor current using axis codes
+        #if EITHER(HAS_MOTOR_CURRENT_SPI, HAS_MOTOR_CURRENT_DAC)
+          _GC( 908, M908),                                // M908: Control digital trimpot directly
+          #if ENABLED(HAS_MOTOR_CURRENT_DAC)
+            _GC( 909, M909),                              // M909: Print digipot/DAC current value
+            _GC( 910, M910),                              // M910: Commit digipot/DAC value to external EEPROM
+          #endif
+        #endif
+      #endif
+      #if HAS_TRINAMIC_CONFIG
+        #if ENABLED(MONITOR_DRIVER_STATUS)
+          _GC( 911, M911),                                // M911: Report TMC2130 prewarn triggered flags
+          _GC( 912, M912),                                // M912: Clear TMC2130 prewarn triggered flags
+        #endif
+        #if ENABLED(HYBRID_THRESHOLD)
+          _GC( 913, M913),                                // M913: Set HYBRID_THRESHOLD speed
+        #endif
+        #if USE_SENSORLESS
+          _GC( 914, M914),                                // M914: Set StallGuard sensitivity
+        #endif
+      #endif
+      #if HAS_L64XX
+        _GC( 916, M916),                                  // M916: L6470 tuning: Increase drive level until thermal warning
+        _GC( 917, M917),                                  // M917: L6470 tuning: Find minimum current thresholds
+        _GC( 918, M918),                                  // M918: L6470 tuning: Increase speed until max or error
+      #endif
+      #if ENABLED(SDSUPPORT)
+        _GC( 928, M928),                                  // M928: Start SD write
+      #endif
+      #if ENABLED(MAGNETIC_PARKING_EXTRUDER)
+        _GC( 951, M951),                                  // M951: Set Magnetic Parking Extruder parameters
+      #endif
+      #if ALL(HAS_SPI_FLASH, SDSUPPORT, MARLIN_DEV_MODE)
+        _GC( 993, M993),                                  // M993: Backup SPI Flash to SD
+        _GC( 994, M994),                                  // M994: Load a Backup from SD to SPI Flash
+      #endif
+      #if ENABLED(TOUCH_SCREEN_CALIBRATION)
+        _GC( 995, M995),                                  // M995: Touch screen calibration for TFT display
+      #endif
+      #if ENABLED(PLATFORM_M997_SUPPORT)
+        _GC( 997, M997),                                  // M997: Perform in-application firmware update
+      #endif
+      _GC( 999, M999),                                    // M999: Restart after being Stopped
+      #if ENABLED(POWER_LOSS_RECOVERY)
+        _GC(1000, M1000),                                 // M1000: [INTERNAL] Resume from power-loss
+      #endif
+      #if ENABLED(SDSUPPORT)
+        _GC(1001, M1001),                                 // M1001: [INTERNAL] Handle SD completion
+      #endif
+      #if ENABLED(MAX7219_GCODE)
+        _GC(7219, M7219),                                 // M7219: Set LEDs, columns, and rows
+      #endif
+    };
+
+    static_assert(dispatch_sorted(g_table, COUNT(g_table)), "G-code dispatch table must be in ascending order.");
+    static_assert(dispatch_sorted(m_table, COUNT(m_table)), "M-code dispatch table must be in ascending order.");
+
+    #if ENABLED(GCODE_DISPATCH_STATS)
+      static dispatch_stats_t g_stats[COUNT(g_table)], m_stats[COUNT(m_table)];
+    #endif
+
+    switch (letter) {
+      case 'G': size = COUNT(g_table); TERN_(GCODE_DISPATCH_STATS, stats = g_stats); return g_table;
+      case 'M': size = COUNT(m_table); TERN_(GCODE_DISPATCH_STATS, stats = m_stats); return m_table;
+      default: size = 0; return nullptr;
+    }
+  }
+
+  #undef _GC
+
+  // Binary search a table for a code. Return its index, or -1 if it's not there.
+  int16_t GcodeSuite::find_command(const dispatch_t * const table, const uint16_t size, const uint16_t code) {
+    uint16_t lo = 0, hi = size;
+    while (lo < hi) {
+      const uint16_t mid = (lo + hi) >> 1,
+                     c = pgm_read_word(&table[mid].code);
+      if (c < code)
+        lo = mid + 1;
+      else if (c > code)
+        hi = mid;
+      else
+        return mid;
+    }
+    return -1;
+  }
+
+  /**
+   * Dispatch the parsed G or M code to its handler.
+   * Return false if the handler already sent "ok".
+   */
+  bool GcodeSuite::dispatch_command() {
+    uint16_t size;
+    #if ENABLED(GCODE_DISPATCH_STATS)
+      dispatch_stats_t *stats;
+      const dispatch_t * const table = dispatch_table(parser.command_letter, size, stats);
+    #else
+      const dispatch_t * const table = dispatch_table(parser.command_letter, size);
+    #endif
+    const int16_t i = find_command(table, size, parser.codenum);
+    if (i < 0) {
+      parser.unknown_command_warning();
+      return true;
+    }
+    const handler_t handler = reinterpret_cast<handler_t>(pgm_read_ptr(&table[i].handler));
+    #if ENABLED(GCODE_DISPATCH_STATS)
+      const uint32_t start = micros();
+      handler();
+      stats[i].count++;
+      stats[i].us += micros() - start;
+    #else
+      handler();
+    #endif
+    return !(pgm_read_byte(&table[i].flags) & GC_NO_OK);
+  }
+
+#endif // GCODE_DISPATCH_TABLE
+
 /**
  * Process the parsed command and dispatch it to its handler
  */
@@ -258,6 +898,13 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
 
   // Handle a known G, M, or T
   switch (parser.command_letter) {
+
+    #if ENABLED(GCODE_DISPATCH_TABLE)
+
+      case 'G': case 'M': if (!dispatch_command()) return; break;
+
+    #else
+
     case 'G': switch (parser.codenum) {
 
       case 0: case 1: case 8:                                             // G0: Fast Move, G1: Linear Move
@@ -493,7 +1140,7 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
         case 108: M108(); break;                                  // M108: Cancel Waiting
         case 112: M112(); break;                                  // M112: Full Shutdown
         case 410: M410(); break;                                  // M410: Quickstop - Abort all the planned moves.
-        TERN_(HOST_PROMPT_SUPPORT, case 876:)                     // M876: Handle Host prompt responses
+        TERN_(HOST_PROMPT_SUPPORT, case 876: M876(); break;)      // M876: Handle Host prompt responses
       #else
         case 108: case 112: case 410:
         TERN_(HOST_PROMPT_SUPPORT, case 876:)
@@ -773,6 +1420,14 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
         case 575: M575(); break;                                  // M575: Set serial baudrate
       #endif
 
+      #if ENABLED(GCODE_PARSE_AHEAD)
+        case 576: M576(); break;                                  // M576: Report buffer statistics
+      #endif
+
+      #if ENABLED(CREDIT_FLOW_CONTROL)
+        case 577: M577(); break;                                  // M577: Set serial flow control
+      #endif
+
       #if ENABLED(ADVANCED_PAUSE_FEATURE)
         case 600: M600(); break;                                  // M600: Pause for Filament Change
         case 603: M603(); break;                                  // M603: Configure Filament Change
@@ -929,6 +1584,8 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
     }
     break;
 
+    #endif // !GCODE_DISPATCH_TABLE
+
     case 'T': T(parser.codenum); break;                           // Tn: Tool Change
 
     #if ENABLED(MARLIN_DEV_MODE)
@@ -950,7 +1607,7 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
  * This is called from the main loop()
  */
 void GcodeSuite::process_next_command() {
-  char * const current_command = queue.command_buffer[queue.index_r];
+  char * const current_command = queue.command(queue.index_r);
 
   PORT_REDIRECT(queue.port[queue.index_r]);
 
@@ -963,12 +1620,17 @@ void GcodeSuite::process_next_command() {
     SERIAL_ECHOLN(current_command);
     #if ENABLED(M100_FREE_MEMORY_DUMPER)
       SERIAL_ECHOPAIR("slot:", queue.index_r);
-      M100_dump_routine(PSTR("   Command Queue:"), &queue.command_buffer[0][0], &queue.command_buffer[BUFSIZE - 1][MAX_CMD_SIZE - 1]);
+      #if ENABLED(PACKED_COMMAND_QUEUE)
+        M100_dump_routine(PSTR("   Command Queue:"), &queue.command_ring[0], &queue.command_ring[COMMAND_QUEUE_BYTES - 1]);
+      #else
+        M100_dump_routine(PSTR("   Command Queue:"), &queue.command_buffer[0][0], &queue.command_buffer[BUFSIZE - 1][MAX_CMD_SIZE - 1]);
+      #endif
     #endif
   }
 
-  // Parse the next command in the queue
-  parser.parse(current_command);
+  // Parse the next command in the queue, unless that was done already
+  if (TERN1(GCODE_PARSE_AHEAD, !queue.restore_parsed()))
+    parser.parse(current_command);
   process_parsed_command();
 }
 
@@ -1007,6 +1669,34 @@ void GcodeSuite::process_subcommands_now(char * gcode) {
   parser.parse(saved_cmd);                            // Restore the parser state
 }
 
+#if ENABLED(STATUS_QUERY_ASAP)
+
+  /**
+   * M105, M27 and M31 don't touch motion or the queue, so they can be
+   * answered as soon as they arrive instead of waiting behind buffered moves.
+   */
+  bool GcodeSuite::process_status_query(char * const cmd) {
+    const char *p = cmd;
+    if (*p == 'N') {                                  // Skip the line number
+      do ++p; while (NUMERIC(*p));
+      while (*p == ' ') ++p;
+    }
+    if (*p != 'M') return false;
+
+    char *end;
+    const long code = strtol(p + 1, &end, 10);
+    if (*end == '.' || !(code == 105 || code == 31 || TERN0(SDSUPPORT, code == 27))) return false;
+
+    GCodeParser::state_t running;                     // idle() may get here in the middle of a command
+    parser.save_state(running);
+    parser.parse(cmd);
+    process_parsed_command(true);                     // The queue sends the "ok" in turn
+    parser.restore_state(running);
+    return true;
+  }
+
+#endif
+
 #if ENABLED(HOST_KEEPALIVE_FEATURE)
 
   /**
@@ -1017,7 +1707,7 @@ void GcodeSuite::process_subcommands_now(char * gcode) {
     const millis_t ms = millis();
     static millis_t next_busy_signal_ms = 0;
     if (!autoreport_paused && host_keepalive_interval && busy_state != NOT_BUSY) {
-      if (PENDING(ms, next_busy_signal_ms)) return;
+      if (PENDING(ms, next_busy_signal_ms) || SERIAL_TX_DEFER()) return;
       switch (busy_state) {
         case IN_HANDLER:
         case IN_PROCESS:
@@ -96,7 +96,7 @@
  * M23  - Select SD file: "M23 /path/file.gco". (Requires SDSUPPORT)
  * M24  - Start/resume SD print. (Requires SDSUPPORT)
  * M25  - Pause SD print. (Requires SDSUPPORT)
- * M26  - Set SD position in bytes: "M26 S12345". (Requires SDSUPPORT)
+ * M26  - Set SD position in bytes: "M26 S12345", or go to a layer: "M26 L12". (Requires SDSUPPORT. L requires SD_GCODE_INDEX)
  * M27  - Report SD print status. (Requires SDSUPPORT)
  *        OR, with 'S<seconds>' set the SD status auto-report interval. (Requires AUTO_REPORT_SD_STATUS)
  *        OR, with 'C' get the current filename.
@@ -232,6 +232,9 @@
  * M524 - Abort the current SD print job started with M24. (Requires SDSUPPORT)
  * M540 - Enable/disable SD card abort on endstop hit: "M540 S<state>". (Requires SD_ABORT_ON_ENDSTOP_HIT)
  * M569 - Enable stealthChop on an axis. (Requires at least one _DRIVER_TYPE to be TMC2130/2160/2208/2209/5130/5160)
+ * M576 - Report command buffer and planner stall statistics. (Requires GCODE_PARSE_AHEAD)
+ * M577 - Set serial flow control: "M577 S<0|1>" for an "ok" per line or a credit window. (Requires CREDIT_FLOW_CONTROL)
+ * M578 - Report calls and time of each G and M code: "M578 [R]". (Requires GCODE_DISPATCH_STATS)
  * M600 - Pause for filament change: "M600 X<pos> Y<pos> Z<raise> E<first_retract> L<later_retract>". (Requires ADVANCED_PAUSE_FEATURE)
  * M603 - Configure filament change: "M603 T<tool> U<unload_length> L<load_length>". (Requires ADVANCED_PAUSE_FEATURE)
  * M605 - Set Dual X-Carriage movement mode: "M605 S<mode> [X<x_offset>] [R<temp_offset>]". (Requires DUAL_X_CARRIAGE)
@@ -362,10 +365,27 @@ public:
   static void process_parsed_command(const bool no_ok=false);
   static void process_next_command();
 
+  #if ENABLED(GCODE_DISPATCH_TABLE)
+    // G and M codes are dispatched through tables sorted by code number
+    enum DispatchFlag : uint8_t {
+      GC_NO_OK  = _BV(0)    // Sends its own "ok"
+    };
+    typedef void (*handler_t)();
+    struct dispatch_t { uint16_t code; handler_t handler; uint8_t flags; };
+    #if ENABLED(GCODE_DISPATCH_STATS)
+      struct dispatch_stats_t { uint32_t count, us; };
+    #endif
+  #endif
+
   // Execute G-code in-place, preserving current G-code parameters
   static void process_subcommands_now_P(PGM_P pgcode);
   static void process_subcommands_now(char * gcode);
 
+  #if ENABLED(STATUS_QUERY_ASAP)
+    // Run a status query right away, without "ok". Return false if the line isn't one.
+    static bool process_status_query(char * const cmd);
+  #endif
+
   static inline void home_all_axes() {
     extern const char G28_STR[];
     process_subcommands_now_P(G28_STR);
@@ -410,6 +430,33 @@ public:
 
 private:
 
+  #if ENABLED(GCODE_DISPATCH_TABLE)
+    static const dispatch_t* dispatch_table(const char letter, uint16_t &size
+      #if ENABLED(GCODE_DISPATCH_STATS)
+        , dispatch_stats_t* &stats
+      #endif
+    );
+    static int16_t find_command(const dispatch_t * const table, const uint16_t size, const uint16_t code);
+    static bool dispatch_command();
+
+    // Handlers for codes that share a function in the switch
+    static void G0();
+    static void G1();
+    #if ENABLED(ARC_SUPPORT) && DISABLED(SCARA)
+      static void G2();
+      static void G3();
+    #endif
+    TERN_(G38_PROBE_TARGET, static void G38_subcode());
+    static void G90();
+    static void G91();
+    #if HAS_CUTTER
+      static void M3();
+      static void M4();
+    #endif
+    TERN_(FWRETRACT_AUTORETRACT, static void M209_autoretract());
+    static void ignore_command();
+  #endif
+
   TERN_(MARLIN_DEV_MODE, static void D(const int16_t dcode));
 
   static void G0_G1(TERN_(HAS_FAST_MOVES, const bool fast_move=false));
@@ -784,6 +831,12 @@ private:
 
   TERN_(BAUD_RATE_GCODE, static void M575());
 
+  TERN_(GCODE_PARSE_AHEAD, static void M576());
+
+  TERN_(CREDIT_FLOW_CONTROL, static void M577());
+
+  TERN_(GCODE_DISPATCH_STATS, static void M578());
+
   #if ENABLED(ADVANCED_PAUSE_FEATURE)
     static void M600();
     static void M603();
@@ -67,6 +67,9 @@ void GcodeSuite::M115() {
     // BINARY_FILE_TRANSFER (M28 B1)
     cap_line(PSTR("BINARY_FILE_TRANSFER"), ENABLED(BINARY_FILE_TRANSFER));
 
+    // CREDIT_FLOW (M577)
+    cap_line(PSTR("CREDIT_FLOW"), ENABLED(CREDIT_FLOW_CONTROL));
+
     // EEPROM (M500, M501)
     cap_line(PSTR("EEPROM"), ENABLED(EEPROM_SETTINGS));
 
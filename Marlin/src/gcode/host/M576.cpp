@@ -0,0 +1,59 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(GCODE_PARSE_AHEAD)
+
+#include "../gcode.h"
+#include "../queue.h"
+#include "../../module/planner.h"
+
+/**
+ * M576: Report command buffer statistics
+ *
+ *   P<free>    Free planner blocks
+ *   B<free>    Free command queue slots
+ *   Q<count>   Commands in the queue, including this one
+ *   S<count>   Moves that waited for a free planner block
+ *   W<ms>      Total time spent waiting for the planner
+ *   A<count>   Commands that were parsed while waiting
+ *
+ * Parameters:
+ *   R          Reset the counters after reporting
+ */
+void GcodeSuite::M576() {
+  SERIAL_ECHOLNPAIR("M576 P", int(planner.moves_free()),
+                    " B", int(queue.free_slots()),
+                    " Q", int(queue.length),
+                    " S", planner.stall_count,
+                    " W", planner.stall_ms,
+                    " A", queue.parsed_ahead);
+
+  if (parser.seen('R')) {
+    planner.stall_count = planner.stall_ms = 0;
+    queue.parsed_ahead = 0;
+  }
+}
+
+#endif // GCODE_PARSE_AHEAD
@@ -0,0 +1,52 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(CREDIT_FLOW_CONTROL)
+
+#include "../gcode.h"
+#include "../queue.h"
+
+/**
+ * M577: Set flow control for the serial port that sent the command
+ *
+ *   S1  Credit flow. No "ok" per line. Bytes read are returned as 'credit:<bytes>'.
+ *   S0  Send an "ok" for every line (default)
+ *
+ * Reports 'window:<bytes>', the bytes the host may have in flight, or 0 if off.
+ * Send M577 S1 and wait for its "ok" before streaming. After M577 S0 wait
+ * for 'window:0' since this command gets no "ok" of its own.
+ */
+void GcodeSuite::M577() {
+  const int16_t p = queue.command_port();
+  if (p < 0) return;
+
+  if (parser.seen('S')) {
+    queue.credit_flow[p] = parser.value_bool();
+    queue.credit_pending[p] = 0;
+  }
+  SERIAL_ECHOLNPAIR("window:", queue.credit_flow[p] ? CREDIT_WINDOW : 0);
+}
+
+#endif // CREDIT_FLOW_CONTROL
@@ -0,0 +1,61 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(GCODE_DISPATCH_STATS)
+
+#include "../gcode.h"
+
+/**
+ * M578: Report G-code dispatch statistics
+ *
+ * One line for each G and M code run since the last reset:
+ *   M578 <code> N<count> U<us>
+ *
+ *   <code>     The command, such as G1
+ *   N<count>   Times it was run
+ *   U<us>      Total time spent in its handler, in microseconds
+ *
+ * Parameters:
+ *   R          Reset the counters after reporting
+ */
+void GcodeSuite::M578() {
+  const bool reset = parser.seen('R');
+  LOOP_L_N(l, 2) {
+    const char letter = l ? 'M' : 'G';
+    uint16_t size;
+    dispatch_stats_t *stats;
+    const dispatch_t * const table = dispatch_table(letter, size, stats);
+    LOOP_L_N(i, size) {
+      if (!stats[i].count) continue;
+      SERIAL_ECHOPGM("M578 ");
+      SERIAL_CHAR(letter);
+      SERIAL_ECHO(pgm_read_word(&table[i].code));
+      SERIAL_ECHOLNPAIR(" N", stats[i].count, " U", stats[i].us);
+    }
+    if (reset) memset(stats, 0, size * sizeof(*stats));
+  }
+}
+
+#endif // GCODE_DISPATCH_STATS
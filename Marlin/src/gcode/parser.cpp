@@ -66,6 +66,11 @@ int GCodeParser::codenum;
   // Optimized Parameters
   uint32_t GCodeParser::codebits;  // found bits
   uint8_t GCodeParser::param[26];  // parameter offsets from command_ptr
+  #if ENABLED(PREPARSED_GCODE_VALUES)
+    uint32_t GCodeParser::numbits, GCodeParser::intbits;
+    GCodeParser::param_value_t GCodeParser::param_value[26];
+    uint8_t GCodeParser::value_ind;
+  #endif
 #else
   char *GCodeParser::command_args; // start of parameters
 #endif
@@ -90,6 +95,151 @@ void GCodeParser::reset() {
   #endif
 }
 
+#if ANY(GCODE_PARSE_AHEAD, STATUS_QUERY_ASAP)
+
+  void GCodeParser::save_state(state_t &s) {
+    s.value_ptr = value_ptr;
+    s.command_ptr = command_ptr;
+    s.string_arg = string_arg;
+    s.command_letter = command_letter;
+    s.codenum = codenum;
+    TERN_(USE_GCODE_SUBCODES, s.subcode = subcode);
+    s.codebits = codebits;
+    COPY(s.param, param);
+    #if ENABLED(PREPARSED_GCODE_VALUES)
+      s.numbits = numbits;
+      s.intbits = intbits;
+      COPY(s.param_value, param_value);
+      s.value_ind = value_ind;
+    #endif
+  }
+
+  void GCodeParser::restore_state(const state_t &s) {
+    value_ptr = s.value_ptr;
+    command_ptr = s.command_ptr;
+    string_arg = s.string_arg;
+    command_letter = s.command_letter;
+    codenum = s.codenum;
+    TERN_(USE_GCODE_SUBCODES, subcode = s.subcode);
+    codebits = s.codebits;
+    COPY(param, s.param);
+    #if ENABLED(PREPARSED_GCODE_VALUES)
+      numbits = s.numbits;
+      intbits = s.intbits;
+      COPY(param_value, s.param_value);
+      value_ind = s.value_ind;
+    #endif
+  }
+
+#endif
+
+#if ENABLED(GCODE_MACROS_PRECOMPILE)
+
+  /**
+   * Packed form of a parsed command:
+   *   command_ptr offset, letter, codenum (2), [subcode], codebits (4), string_arg offset (0xFF for none),
+   *   one offset per parameter in codebits, [numbits (4), intbits (4), one value per bit in numbits]
+   * Offsets are into the parsed text, so it must stay in place, unchanged.
+   * A line only having parameters for the motion mode isn't packed, since the
+   * mode may change before the command runs again.
+   */
+  uint8_t GCodeParser::pack(const char * const line, uint8_t * const dst, const uint8_t size) {
+    const char c = *command_ptr;
+    if (TERN(GCODE_CASE_INSENSITIVE, c + (WITHIN(c, 'a', 'z') ? 'A' - 'a' : 0), c) != command_letter) return 0;
+    if (string_arg && string_arg - command_ptr > 0xFE) return 0;
+
+    uint16_t len = 0;
+    auto put = [&](const void * const v, const uint8_t n) {
+      if (len + n <= size) memcpy(dst + len, v, n);
+      len += n;
+    };
+
+    const uint8_t cmd_ofs = command_ptr - line, arg_ofs = string_arg ? string_arg - command_ptr : 0xFF;
+    const int16_t code = codenum;
+    put(&cmd_ofs, 1);
+    put(&command_letter, 1);
+    put(&code, 2);
+    TERN_(USE_GCODE_SUBCODES, put(&subcode, 1));
+    put(&codebits, 4);
+    put(&arg_ofs, 1);
+    LOOP_L_N(i, COUNT(param)) if (TEST32(codebits, i)) put(&param[i], 1);
+    #if ENABLED(PREPARSED_GCODE_VALUES)
+      const uint32_t nbits = numbits & codebits, ibits = intbits & nbits;
+      put(&nbits, 4);
+      put(&ibits, 4);
+      LOOP_L_N(i, COUNT(param_value)) if (TEST32(nbits, i)) put(&param_value[i], sizeof(param_value_t));
+    #endif
+
+    return len <= size ? len : 0;
+  }
+
+  void GCodeParser::unpack(const uint8_t *src, char * const line) {
+    auto get = [&](void * const v, const uint8_t n) { memcpy(v, src, n); src += n; };
+
+    uint8_t cmd_ofs, arg_ofs;
+    int16_t code;
+    get(&cmd_ofs, 1);
+    command_ptr = line + cmd_ofs;
+    get(&command_letter, 1);
+    get(&code, 2);
+    codenum = code;
+    TERN_(USE_GCODE_SUBCODES, get(&subcode, 1));
+    get(&codebits, 4);
+    get(&arg_ofs, 1);
+    string_arg = arg_ofs == 0xFF ? nullptr : command_ptr + arg_ofs;
+    value_ptr = nullptr;
+    LOOP_L_N(i, COUNT(param)) if (TEST32(codebits, i)) get(&param[i], 1);
+    #if ENABLED(PREPARSED_GCODE_VALUES)
+      get(&numbits, 4);
+      get(&intbits, 4);
+      LOOP_L_N(i, COUNT(param_value)) if (TEST32(numbits, i)) get(&param_value[i], sizeof(param_value_t));
+    #endif
+
+    TERN_(GCODE_MOTION_MODES, update_motion_mode());
+  }
+
+#endif
+
+#if ENABLED(PREPARSED_GCODE_VALUES)
+
+  /**
+   * Convert a parameter value once, as it is found by parse().
+   * Accepts [-+]digits[.digits] (already checked by valid_number).
+   * As with value_float there's no exponent, so 'E' ends the number.
+   * Integers are kept exact. Fractions are limited to 9 digits.
+   * An integer part too big for int32_t is left for strtof/strtol.
+   */
+  void GCodeParser::parse_value(const uint8_t ind, const char *p) {
+    const bool neg = *p == '-';
+    if (neg || *p == '+') p++;
+
+    uint32_t ipart = 0;
+    for (; NUMERIC(*p); p++) {
+      if (ipart > 429496728UL) { CBI32(numbits, ind); return; }
+      ipart = ipart * 10 + (*p - '0');
+    }
+    if (ipart > INT32_MAX) { CBI32(numbits, ind); return; }
+
+    SBI32(numbits, ind);
+    param_value_t &v = param_value[ind];
+
+    if (*p != '.') {
+      SBI32(intbits, ind);
+      v.u = neg ? -ipart : ipart;
+      return;
+    }
+
+    uint32_t fpart = 0, fdiv = 1;
+    for (p++; NUMERIC(*p); p++)
+      if (fdiv < 1000000000UL) { fpart = fpart * 10 + (*p - '0'); fdiv *= 10; }
+
+    CBI32(intbits, ind);
+    const float f = float(ipart) + float(fpart) / float(fdiv);
+    v.f = neg ? -f : f;
+  }
+
+#endif
+
 #if ENABLED(GCODE_QUOTED_STRINGS)
 
   // Pass the address after the first quote (if any)
@@ -204,14 +354,7 @@ void GCodeParser::parse(char *p) {
       // Skip all spaces to get to the first argument, or nul
       while (*p == ' ') p++;
 
-      #if ENABLED(GCODE_MOTION_MODES)
-        if (letter == 'G'
-          && (codenum <= TERN(ARC_SUPPORT, 3, 1) || codenum == 5 || TERN0(G38_PROBE_TARGET, codenum == 38))
-        ) {
-          motion_mode_codenum = codenum;
-          TERN_(USE_GCODE_SUBCODES, motion_mode_subcode = subcode);
-        }
-      #endif
+      TERN_(GCODE_MOTION_MODES, update_motion_mode());
 
       break;
 
@@ -49,6 +49,8 @@
  *  - FASTER_GCODE_PARSER:
  *    - Flags existing params (1 bit each)
  *    - Stores value offsets (1 byte each)
+ *  - PREPARSED_GCODE_VALUES:
+ *    - Converts numeric values once, in parse() (4 bytes each)
  *  - Provide accessors for parameters:
  *    - Parameter exists
  *    - Parameter has value
@@ -62,6 +64,14 @@ private:
   #if ENABLED(FASTER_GCODE_PARSER)
     static uint32_t codebits;       // Parameters pre-scanned
     static uint8_t param[26];       // For A-Z, offsets into command args
+    #if ENABLED(PREPARSED_GCODE_VALUES)
+      typedef union { float f; int32_t l; uint32_t u; } param_value_t;
+      static uint32_t numbits,      // Parameters with a pre-converted number
+                      intbits;      // ...which is an integer in 'l' / 'u'
+      static param_value_t param_value[26];
+      static uint8_t value_ind;     // Set by seen, the parameter for value_ptr
+      static void parse_value(const uint8_t ind, const char *p);
+    #endif
   #else
     static char *command_args;      // Args start here, for slow scan
   #endif
@@ -95,6 +105,43 @@ public:
       static uint8_t motion_mode_subcode;
     #endif
     FORCE_INLINE static void cancel_motion_mode() { motion_mode_codenum = -1; }
+    // G0-G3, G5, and G38 set the mode for lines having only parameters
+    static inline void update_motion_mode() {
+      if (command_letter == 'G'
+        && (codenum <= TERN(ARC_SUPPORT, 3, 1) || codenum == 5 || TERN0(G38_PROBE_TARGET, codenum == 38))
+      ) {
+        motion_mode_codenum = codenum;
+        TERN_(USE_GCODE_SUBCODES, motion_mode_subcode = subcode);
+      }
+    }
+  #endif
+
+  #if ANY(GCODE_PARSE_AHEAD, STATUS_QUERY_ASAP)
+    // A parsed command, to be set aside and restored later
+    typedef struct {
+      char *value_ptr, *command_ptr, *string_arg, command_letter;
+      int codenum;
+      #if ENABLED(USE_GCODE_SUBCODES)
+        uint8_t subcode;
+      #endif
+      uint32_t codebits;
+      uint8_t param[26];
+      #if ENABLED(PREPARSED_GCODE_VALUES)
+        uint32_t numbits, intbits;
+        param_value_t param_value[26];
+        uint8_t value_ind;
+      #endif
+    } state_t;
+
+    static void save_state(state_t &s);
+    static void restore_state(const state_t &s);
+  #endif
+
+  #if ENABLED(GCODE_MACROS_PRECOMPILE)
+    // Pack the command just parsed from 'line'. Return the size, or 0 if it must be parsed again.
+    static uint8_t pack(const char * const line, uint8_t * const dst, const uint8_t size);
+    // Restore a command packed from 'line', as if it was parsed again
+    static void unpack(const uint8_t *src, char * const line);
   #endif
 
   #if ENABLED(DEBUG_GCODE_PARSER)
@@ -131,6 +178,9 @@ public:
       if (ind >= COUNT(param)) return;           // Only A-Z
       SBI32(codebits, ind);                      // parameter exists
       param[ind] = ptr ? ptr - command_ptr : 0;  // parameter offset or 0
+      #if ENABLED(PREPARSED_GCODE_VALUES)
+        if (ptr && valid_number(ptr)) parse_value(ind, ptr); else CBI32(numbits, ind);
+      #endif
       #if ENABLED(DEBUG_GCODE_PARSER)
         if (codenum == 800) {
           SERIAL_ECHOPAIR("Set bit ", (int)ind, " of codebits (", hex_address((void*)(codebits >> 16)));
@@ -147,6 +197,7 @@ public:
       if (ind >= COUNT(param)) return false; // Only A-Z
       const bool b = TEST32(codebits, ind);
       if (b) {
+        TERN_(PREPARSED_GCODE_VALUES, value_ind = ind);
         if (param[ind]) {
           char * const ptr = command_ptr + param[ind];
           value_ptr = valid_number(ptr) ? ptr : nullptr;
@@ -253,8 +304,20 @@ public:
   // The value as a string
   static inline char* value_string() { return value_ptr; }
 
+  #if ENABLED(PREPARSED_GCODE_VALUES)
+    // The value was converted in parse()
+    FORCE_INLINE static bool has_number() { return value_ptr && TEST32(numbits, value_ind); }
+    FORCE_INLINE static bool number_is_int() { return TEST32(intbits, value_ind); }
+  #endif
+
   // Float removes 'E' to prevent scientific notation interpretation
   static inline float value_float() {
+    #if ENABLED(PREPARSED_GCODE_VALUES)
+      if (has_number()) {
+        const param_value_t &v = param_value[value_ind];
+        return number_is_int() ? float(v.l) : v.f;
+      }
+    #endif
     if (value_ptr) {
       char *e = value_ptr;
       for (;;) {
@@ -274,8 +337,21 @@ public:
   }
 
   // Code value as a long or ulong
-  static inline int32_t value_long() { return value_ptr ? strtol(value_ptr, nullptr, 10) : 0L; }
-  static inline uint32_t value_ulong() { return value_ptr ? strtoul(value_ptr, nullptr, 10) : 0UL; }
+  #if ENABLED(PREPARSED_GCODE_VALUES)
+    static inline int32_t value_long() {
+      if (!has_number()) return value_ptr ? strtol(value_ptr, nullptr, 10) : 0L;
+      const param_value_t &v = param_value[value_ind];
+      return number_is_int() ? v.l : int32_t(v.f);
+    }
+    static inline uint32_t value_ulong() {
+      if (!has_number()) return value_ptr ? strtoul(value_ptr, nullptr, 10) : 0UL;
+      const param_value_t &v = param_value[value_ind];
+      return number_is_int() ? v.u : uint32_t(int32_t(v.f));
+    }
+  #else
+    static inline int32_t value_long() { return value_ptr ? strtol(value_ptr, nullptr, 10) : 0L; }
+    static inline uint32_t value_ulong() { return value_ptr ? strtoul(value_ptr, nullptr, 10) : 0UL; }
+  #endif
 
   // Code value for use as time
   static inline millis_t value_millis() { return value_ulong(); }
@@ -51,6 +51,10 @@ GCodeQueue queue;
   #include "../feature/powerloss.h"
 #endif
 
+#if ENABLED(BINARY_GCODE)
+  #include "../feature/binary_gcode.h"
+#endif
+
 /**
  * GCode line number handling. Hosts may opt to include line numbers when
  * sending commands to Marlin, and lines will be checked for sequentiality.
@@ -58,6 +62,11 @@ GCodeQueue queue;
  */
 long GCodeQueue::last_N[NUM_SERIAL];
 
+#if ENABLED(CREDIT_FLOW_CONTROL)
+  bool GCodeQueue::credit_flow[NUM_SERIAL];
+  uint16_t GCodeQueue::credit_pending[NUM_SERIAL];
+#endif
+
 /**
  * GCode Command Queue
  * A simple ring buffer of BUFSIZE command strings.
@@ -71,7 +80,13 @@ uint8_t GCodeQueue::length = 0,  // Count of commands in the queue
         GCodeQueue::index_r = 0, // Ring buffer read position
         GCodeQueue::index_w = 0; // Ring buffer write position
 
-char GCodeQueue::command_buffer[BUFSIZE][MAX_CMD_SIZE];
+#if ENABLED(PACKED_COMMAND_QUEUE)
+  char GCodeQueue::command_ring[COMMAND_QUEUE_BYTES];
+  uint16_t GCodeQueue::command_pos[BUFSIZE],
+           GCodeQueue::ring_w; // = 0
+#else
+  char GCodeQueue::command_buffer[BUFSIZE][MAX_CMD_SIZE];
+#endif
 
 /*
  * The port that the command was received on
@@ -80,6 +95,22 @@ char GCodeQueue::command_buffer[BUFSIZE][MAX_CMD_SIZE];
   int16_t GCodeQueue::port[BUFSIZE];
 #endif
 
+#ifdef SERIAL_PORT_WEIGHTS
+
+  uint8_t GCodeQueue::port_length[NUM_SERIAL]; // = { 0 }
+
+  static constexpr uint8_t port_weight[] = SERIAL_PORT_WEIGHTS;
+  static_assert(COUNT(port_weight) == NUM_SERIAL, "SERIAL_PORT_WEIGHTS needs one weight for each serial port.");
+  static_assert(port_weight[0] && port_weight[1], "SERIAL_PORT_WEIGHTS must be greater than 0.");
+
+  // A port may fill its share of the buffer, rounded, and at least one slot
+  bool GCodeQueue::port_has_room(const uint8_t p) {
+    constexpr uint16_t total = port_weight[0] + port_weight[1];
+    return port_length[p] < _MAX(1, ((BUFSIZE) * port_weight[p] + total / 2) / total);
+  }
+
+#endif
+
 /**
  * Serial command injection
  */
@@ -89,6 +120,12 @@ static int serial_count[NUM_SERIAL] = { 0 };
 
 bool send_ok[BUFSIZE];
 
+#if ENABLED(STATUS_QUERY_ASAP)
+  // Status queries run on arrival. Their slots only hold the "ok" for its turn.
+  static bool answered[BUFSIZE];
+  static bool answering; // = false
+#endif
+
 /**
  * Next Injected PROGMEM Command pointer. (nullptr == empty)
  * Internal commands are enqueued ahead of serial / SD commands.
@@ -112,13 +149,76 @@ bool GCodeQueue::has_commands_queued() {
   return queue.length || injected_commands_P || injected_commands[0];
 }
 
+#if ENABLED(GCODE_PARSE_AHEAD)
+
+  uint32_t GCodeQueue::parsed_ahead; // = 0
+
+  static int16_t parsed_index = -1;           // Queue slot held in parsed_state
+  static GCodeParser::state_t parsed_state;
+
+  void GCodeQueue::parse_ahead() {
+    // The current command is at index_r. Is the one after it here yet?
+    // Commands being written to SD must keep their original text.
+    if (length < 2 || TERN0(SDSUPPORT, card.flag.saving)) return;
+    const uint8_t i = (index_r + 1) % (BUFSIZE);
+    if (parsed_index == i || TERN0(STATUS_QUERY_ASAP, answered[i])) return;
+
+    GCodeParser::state_t current;
+    parser.save_state(current);
+    parser.parse(command(i));
+    parser.save_state(parsed_state);
+    parser.restore_state(current);
+    parsed_index = i;
+  }
+
+  bool GCodeQueue::restore_parsed() {
+    if (parsed_index != index_r) return false;
+    parsed_index = -1;
+    parser.restore_state(parsed_state);
+    parsed_ahead++;
+    return true;
+  }
+
+#endif
+
 /**
  * Clear the Marlin command queue
  */
 void GCodeQueue::clear() {
   index_r = index_w = length = 0;
+  TERN_(PACKED_COMMAND_QUEUE, ring_w = 0);
+  TERN_(GCODE_PARSE_AHEAD, parsed_index = -1);
+  TERN_(STATUS_QUERY_ASAP, ZERO(answered));
+  #ifdef SERIAL_PORT_WEIGHTS
+    ZERO(port_length);
+  #endif
 }
 
+#if ENABLED(PACKED_COMMAND_QUEUE)
+
+  bool GCodeQueue::has_room() {
+    if (length >= BUFSIZE) return false;
+    if (!length) return true;
+    const uint16_t r = command_pos[index_r];
+    if (ring_w < r) return ring_w + (MAX_CMD_SIZE) <= r;    // Wrapped. Room before the oldest command?
+    if (ring_w == r) return false;                          // Wrapped and exactly full
+    return ring_w + (MAX_CMD_SIZE) <= (COMMAND_QUEUE_BYTES) || (MAX_CMD_SIZE) <= r; // Room at the end, or at the start
+  }
+
+  uint8_t GCodeQueue::free_slots() {
+    if (!has_room()) return 0;
+    // Count the full-length commands that would fit in the free space
+    const uint16_t r = length ? command_pos[index_r] : ring_w,
+                   bytes = ring_w < r ? r - ring_w : ((COMMAND_QUEUE_BYTES) - ring_w) / (MAX_CMD_SIZE) * (MAX_CMD_SIZE) + r;
+    return _MIN(BUFSIZE - length, bytes / (MAX_CMD_SIZE));
+  }
+
+#else
+
+  uint8_t GCodeQueue::free_slots() { return BUFSIZE - length; }
+
+#endif
+
 /**
  * Once a new command is in the ring buffer, call this to commit it
  */
@@ -127,8 +227,17 @@ void GCodeQueue::_commit_command(bool say_ok
     , int16_t p/*=-1*/
   #endif
 ) {
+  #if ENABLED(PACKED_COMMAND_QUEUE)
+    const uint16_t pos = next_command_pos();
+    command_pos[index_w] = pos;
+    ring_w = pos + strlen(&command_ring[pos]) + 1;
+  #endif
   send_ok[index_w] = say_ok;
+  TERN_(STATUS_QUERY_ASAP, answered[index_w] = false);
   TERN_(HAS_MULTI_SERIAL, port[index_w] = p);
+  #ifdef SERIAL_PORT_WEIGHTS
+    if (p >= 0) port_length[p]++;
+  #endif
   TERN_(POWER_LOSS_RECOVERY, recovery.commit_sdpos(index_w));
   if (++index_w >= BUFSIZE) index_w = 0;
   length++;
@@ -144,8 +253,8 @@ bool GCodeQueue::_enqueue(const char* cmd, bool say_ok/*=false*/
     , int16_t pn/*=-1*/
   #endif
 ) {
-  if (*cmd == ';' || length >= BUFSIZE) return false;
-  strcpy(command_buffer[index_w], cmd);
+  if (*cmd == ';' || !has_room()) return false;
+  strcpy(next_command(), cmd);
   _commit_command(say_ok
     #if HAS_MULTI_SERIAL
       , pn
@@ -268,6 +377,14 @@ void GCodeQueue::enqueue_now_P(PGM_P const pgcode) {
   }
 }
 
+/**
+ * Whether the command being run is due an "ok". It isn't with credit flow,
+ * from SD, or for a status query answered on arrival.
+ */
+bool GCodeQueue::ok_due() {
+  return send_ok[index_r] && TERN1(STATUS_QUERY_ASAP, !answering);
+}
+
 /**
  * Send an "ok" message to the host, indicating
  * that a command was successfully processed.
@@ -286,7 +403,7 @@ void GCodeQueue::ok_to_send() {
   if (!send_ok[index_r]) return;
   SERIAL_ECHOPGM(STR_OK);
   #if ENABLED(ADVANCED_OK)
-    char* p = command_buffer[index_r];
+    char* p = command(index_r);
     if (*p == 'N') {
       SERIAL_ECHO(' ');
       SERIAL_ECHO(*p++);
@@ -294,7 +411,7 @@ void GCodeQueue::ok_to_send() {
         SERIAL_ECHO(*p++);
     }
     SERIAL_ECHOPAIR_P(SP_P_STR, int(planner.moves_free()),
-                      SP_B_STR, int(BUFSIZE - length));
+                      SP_B_STR, int(free_slots()));
   #endif
   SERIAL_EOL();
 }
@@ -303,16 +420,26 @@ void GCodeQueue::ok_to_send() {
  * Send a "Resend: nnn" message to the host to
  * indicate that a command needs to be re-sent.
  */
-void GCodeQueue::flush_and_request_resend() {
-  const int16_t pn = command_port();
+void GCodeQueue::flush_and_request_resend(const int16_t pn) {
   #if HAS_MULTI_SERIAL
     if (pn < 0) return;
     PORT_REDIRECT(pn);                    // Reply to the serial port that sent the command
   #endif
-  SERIAL_FLUSH();
+  // With credit flow every byte must be read (and credited), not flushed.
+  // Lines already in flight are refused by their line number.
+  if (TERN1(CREDIT_FLOW_CONTROL, !credit_flow[pn])) SERIAL_FLUSH();
   SERIAL_ECHOPGM(STR_RESEND);
   SERIAL_ECHOLN(last_N[pn] + 1);
-  ok_to_send();
+
+  // The "ok" goes to the same port, since the line never reached the queue
+  if (TERN1(CREDIT_FLOW_CONTROL, !credit_flow[pn])) {
+    SERIAL_ECHOPGM(STR_OK);
+    #if ENABLED(ADVANCED_OK)
+      SERIAL_ECHOPAIR_P(SP_P_STR, int(planner.moves_free()),
+                        SP_B_STR, int(free_slots()));
+    #endif
+    SERIAL_EOL();
+  }
 }
 
 inline bool serial_data_available() {
@@ -329,13 +456,44 @@ inline int read_serial(const uint8_t index) {
   }
 }
 
+#if ENABLED(CREDIT_FLOW_CONTROL)
+
+  inline bool serial_data_available(const uint8_t index) {
+    switch (index) {
+      case 0: return MYSERIAL0.available();
+      #if HAS_MULTI_SERIAL
+        case 1: return MYSERIAL1.available();
+      #endif
+      default: return false;
+    }
+  }
+
+  /**
+   * Return the bytes read since the last credit to the host,
+   * once a quarter of the window is free or the input has caught up.
+   */
+  void GCodeQueue::send_credits() {
+    LOOP_L_N(p, NUM_SERIAL) {
+      const uint16_t c = credit_pending[p];
+      if (!c || (c < (CREDIT_WINDOW) / 4 && serial_data_available(p))) continue;
+      credit_pending[p] = 0;
+      PORT_REDIRECT(p);
+      SERIAL_ECHOLNPAIR("credit:", c);
+    }
+  }
+
+#endif
+
 void GCodeQueue::gcode_line_error(PGM_P const err, const int8_t pn) {
   PORT_REDIRECT(pn);                      // Reply to the serial port that sent the command
   SERIAL_ERROR_START();
   serialprintPGM(err);
   SERIAL_ECHOLN(last_N[pn]);
-  while (read_serial(pn) != -1);          // Clear out the RX buffer
-  flush_and_request_resend();
+  // Clear out the RX buffer. With credit flow the bytes are credited as if read.
+  while (read_serial(pn) != -1) {
+    TERN_(CREDIT_FLOW_CONTROL, if (credit_flow[pn]) credit_pending[pn]++);
+  }
+  flush_and_request_resend(pn);
   serial_count[pn] = 0;
 }
 
@@ -350,7 +508,7 @@ FORCE_INLINE bool is_M29(const char * const cmd) {  // matches "M29" & "M29 ", b
 #define PS_PAREN  3
 #define PS_ESC    4
 
-inline void process_stream_char(const char c, uint8_t &sis, char (&buff)[MAX_CMD_SIZE], int &ind) {
+inline void process_stream_char(const char c, uint8_t &sis, char * const buff, int &ind) {
 
   if (sis == PS_EOL) return;    // EOL comment or overflow
 
@@ -406,7 +564,7 @@ inline void process_stream_char(const char c, uint8_t &sis, char (&buff)[MAX_CMD
  * Handle a line being completed. For an empty line
  * keep sensor readings going and watchdog alive.
  */
-inline bool process_line_done(uint8_t &sis, char (&buff)[MAX_CMD_SIZE], int &ind) {
+inline bool process_line_done(uint8_t &sis, char * const buff, int &ind) {
   sis = PS_NORMAL;
   buff[ind] = 0;
   if (ind) { ind = 0; return false; }
@@ -424,6 +582,10 @@ void GCodeQueue::get_serial_commands() {
 
   static uint8_t serial_input_state[NUM_SERIAL] = { PS_NORMAL };
 
+  #if ENABLED(BINARY_GCODE)
+    static BinaryGCode serial_frame[NUM_SERIAL];
+  #endif
+
   #if ENABLED(BINARY_FILE_TRANSFER)
     if (card.flag.binary_mode) {
       /**
@@ -450,15 +612,42 @@ void GCodeQueue::get_serial_commands() {
   /**
    * Loop while serial characters are incoming and the queue is not full
    */
-  while (length < BUFSIZE && serial_data_available()) {
+  while (has_room() && serial_data_available()) {
+    #ifdef SERIAL_PORT_WEIGHTS
+      bool got_char = false;
+    #endif
     LOOP_L_N(i, NUM_SERIAL) {
 
+      #ifdef SERIAL_PORT_WEIGHTS
+        if (!port_has_room(i)) continue;  // Leave its data in the RX buffer for now
+      #endif
+
       const int c = read_serial(i);
       if (c < 0) continue;
 
+      #ifdef SERIAL_PORT_WEIGHTS
+        got_char = true;
+      #endif
+
+      TERN_(CREDIT_FLOW_CONTROL, if (credit_flow[i]) credit_pending[i]++);
+
       const char serial_char = c;
 
-      if (ISEOL(serial_char)) {
+      #if ENABLED(BINARY_GCODE)
+        // A binary frame may start a line. It expands into the line buffer.
+        bool frame_done = false;
+        if (serial_frame[i].active() || (!serial_count[i] && serial_input_state[i] == PS_NORMAL && uint8_t(c) == BinaryGCode::SYNC)) {
+          switch (serial_frame[i].feed(c, serial_line_buffer[i], serial_count[i])) {
+            case BinaryGCode::BGC_ERROR: return gcode_line_error(PSTR(STR_ERR_CHECKSUM_MISMATCH), i);
+            case BinaryGCode::BGC_MORE: continue;
+            case BinaryGCode::BGC_DONE: frame_done = true; break;
+          }
+        }
+      #else
+        constexpr bool frame_done = false;
+      #endif
+
+      if (frame_done || ISEOL(serial_char)) {
 
         // Reset our state, continue if the line was empty
         if (process_line_done(serial_input_state[i], serial_line_buffer[i], serial_count[i]))
@@ -534,13 +723,34 @@ void GCodeQueue::get_serial_commands() {
           if (strcmp_P(command, PSTR("M410")) == 0) quickstop_stepper();
         #endif
 
+        #if ENABLED(STATUS_QUERY_ASAP)
+          // Status queries are answered now, unless they're being written to SD.
+          // The line still takes a slot, so its "ok" follows those of earlier commands.
+          if (TERN1(SDSUPPORT, !card.flag.saving)) {
+            PORT_REDIRECT(i);
+            answering = true;
+            const bool query = gcode.process_status_query(command);
+            answering = false;
+            if (query) {
+              if (_enqueue(serial_line_buffer[i], TERN1(CREDIT_FLOW_CONTROL, !credit_flow[i])
+                #if HAS_MULTI_SERIAL
+                  , i
+                #endif
+              )) answered[(index_w ? index_w : BUFSIZE) - 1] = true;
+              continue;
+            }
+          }
+        #endif
+
 		#if ENABLED(PROCESS_M290_ASAP)
 		  if (strstr_P(command, PSTR("M290")) != nullptr){
 		  	char* zpos = strchr(command + 4, 'Z');
 			if(zpos){
 				const float offs = constrain(strtof(zpos + 1, nullptr),-2,2);
 				babystep.add_mm(Z_AXIS, offs);
-				_commit_command(true
+				// Queue a report in its place so the 'ok' still goes out in order
+				TERN_(PACKED_COMMAND_QUEUE, strcpy_P(next_command(), PSTR("M290 R")));
+				_commit_command(TERN1(CREDIT_FLOW_CONTROL, !credit_flow[i])
 	    		#if HAS_MULTI_SERIAL
 	      		, i
 	    		#endif
@@ -555,7 +765,7 @@ void GCodeQueue::get_serial_commands() {
         #endif
 
         // Add the command to the queue
-        _enqueue(serial_line_buffer[i], true
+        _enqueue(serial_line_buffer[i], TERN1(CREDIT_FLOW_CONTROL, !credit_flow[i])
           #if HAS_MULTI_SERIAL
             , i
           #endif
@@ -565,6 +775,10 @@ void GCodeQueue::get_serial_commands() {
         process_stream_char(serial_char, serial_input_state[i], serial_line_buffer[i], serial_count[i]);
 
     } // for NUM_SERIAL
+
+    #ifdef SERIAL_PORT_WEIGHTS
+      if (!got_char) break;                 // Only ports over their share have data
+    #endif
   } // queue has space, serial has data
 }
 
@@ -579,22 +793,47 @@ void GCodeQueue::get_serial_commands() {
   inline void GCodeQueue::get_sdcard_commands() {
     static uint8_t sd_input_state = PS_NORMAL;
 
+    #if ENABLED(BINARY_GCODE)
+      static BinaryGCode sd_frame;
+    #endif
+
     if (!IS_SD_PRINTING()) return;
 
+    TERN_(SD_ASYNC_READ, card.ahead_poll());
+
     int sd_count = 0;
     bool card_eof = card.eof();
-    while (length < BUFSIZE && !card_eof) {
+    while (has_room() && !card_eof) {
       const int16_t n = card.get();
       card_eof = card.eof();
       if (n < 0 && !card_eof) { SERIAL_ERROR_MSG(STR_SD_ERR_READ); continue; }
 
       const char sd_char = (char)n;
-      const bool is_eol = ISEOL(sd_char);
+
+      #if ENABLED(BINARY_GCODE)
+        // A binary frame may start a line. It expands into the command buffer.
+        bool frame_done = false;
+        if (sd_frame.active() || (!sd_count && sd_input_state == PS_NORMAL && uint8_t(n) == BinaryGCode::SYNC)) {
+          switch (sd_frame.feed(n, next_command(), sd_count)) {
+            case BinaryGCode::BGC_ERROR: SERIAL_ERROR_MSG(STR_SD_ERR_FRAME); break;
+            case BinaryGCode::BGC_MORE: break;
+            case BinaryGCode::BGC_DONE: frame_done = true; break;
+          }
+          if (!frame_done) {
+            if (card_eof) { sd_frame.reset(); sd_count = 0; card.fileHasFinished(); }
+            continue;
+          }
+        }
+      #else
+        constexpr bool frame_done = false;
+      #endif
+
+      const bool is_eol = frame_done || ISEOL(sd_char);
       if (is_eol || card_eof) {
 
         // Reset stream state, terminate the buffer, and commit a non-empty command
         if (!is_eol && sd_count) ++sd_count;          // End of file with no newline
-        if (!process_line_done(sd_input_state, command_buffer[index_w], sd_count)) {
+        if (!process_line_done(sd_input_state, next_command(), sd_count)) {
           _commit_command(false);
           #if ENABLED(POWER_LOSS_RECOVERY)
             recovery.cmd_sdpos = card.getIndex();     // Prime for the NEXT _commit_command
@@ -604,7 +843,7 @@ void GCodeQueue::get_serial_commands() {
         if (card_eof) card.fileHasFinished();         // Handle end of file reached
       }
       else
-        process_stream_char(sd_char, sd_input_state, command_buffer[index_w], sd_count);
+        process_stream_char(sd_char, sd_input_state, next_command(), sd_count);
 
     }
   }
@@ -621,6 +860,8 @@ void GCodeQueue::get_available_commands() {
 
   get_serial_commands();
 
+  TERN_(CREDIT_FLOW_CONTROL, send_credits());
+
   TERN_(SDSUPPORT, get_sdcard_commands());
 }
 
@@ -638,8 +879,8 @@ void GCodeQueue::advance() {
   #if ENABLED(SDSUPPORT)
 
     if (card.flag.saving) {
-      char* command = command_buffer[index_r];
-      if (is_M29(command)) {
+      char* cmd = command(index_r);
+      if (is_M29(cmd)) {
         // M29 closes the file
         card.closefile();
         SERIAL_ECHOLNPGM(STR_FILE_SAVED);
@@ -657,24 +898,34 @@ void GCodeQueue::advance() {
       }
       else {
         // Write the string from the read buffer to SD
-        card.write_command(command);
+        card.write_command(cmd);
         if (card.flag.logging)
           gcode.process_next_command(); // The card is saving because it's logging
         else
           ok_to_send();
       }
     }
+    else if (TERN0(STATUS_QUERY_ASAP, answered[index_r]))
+      ok_to_send();                     // Answered on arrival
     else
       gcode.process_next_command();
 
   #else
 
-    gcode.process_next_command();
+    if (TERN0(STATUS_QUERY_ASAP, answered[index_r]))
+      ok_to_send();                     // Answered on arrival
+    else
+      gcode.process_next_command();
 
   #endif // SDSUPPORT
 
   // The queue may be reset by a command handler or by code invoked by idle() within a handler
+  #ifdef SERIAL_PORT_WEIGHTS
+    const int16_t p = port[index_r];
+    if (p >= 0 && port_length[p]) port_length[p]--;
+  #endif
   --length;
   if (++index_r >= BUFSIZE) index_r = 0;
+  TERN_(PACKED_COMMAND_QUEUE, if (!length) ring_w = 0); // Empty, so the whole ring is free
 
 }
@@ -38,6 +38,16 @@ public:
 
   static long last_N[NUM_SERIAL];
 
+  #if ENABLED(CREDIT_FLOW_CONTROL)
+    /**
+     * With credit flow (M577 S1) a port gets no "ok" per line. Instead the
+     * bytes read from it are returned to the host as 'credit:<bytes>'.
+     */
+    static bool credit_flow[NUM_SERIAL];
+    static uint16_t credit_pending[NUM_SERIAL];
+    static void send_credits();
+  #endif
+
   /**
    * GCode Command Queue
    * A simple ring buffer of BUFSIZE command strings.
@@ -50,7 +60,19 @@ public:
   static uint8_t length,  // Count of commands in the queue
                  index_r; // Ring buffer read position
 
-  static char command_buffer[BUFSIZE][MAX_CMD_SIZE];
+  #if ENABLED(PACKED_COMMAND_QUEUE)
+    /**
+     * Commands are packed end-to-end in a byte ring, each ending with a nul.
+     * A command never wraps, so the write position skips to the start of the
+     * ring whenever a full-length command wouldn't fit before the end.
+     */
+    static char command_ring[COMMAND_QUEUE_BYTES];
+    static uint16_t command_pos[BUFSIZE];   // Start of each queued command in the ring
+    static inline char* command(const uint8_t i) { return &command_ring[command_pos[i]]; }
+  #else
+    static char command_buffer[BUFSIZE][MAX_CMD_SIZE];
+    static inline char* command(const uint8_t i) { return command_buffer[i]; }
+  #endif
 
   /**
    * The port that the command was received on
@@ -63,6 +85,15 @@ public:
     return TERN0(HAS_MULTI_SERIAL, port[index_r]);
   }
 
+  #ifdef SERIAL_PORT_WEIGHTS
+    /**
+     * Commands from each serial port in the buffer. A port that has its
+     * share of BUFSIZE (by SERIAL_PORT_WEIGHTS) isn't read until one runs.
+     */
+    static uint8_t port_length[NUM_SERIAL];
+    static bool port_has_room(const uint8_t p);
+  #endif
+
   GCodeQueue();
 
   /**
@@ -117,11 +148,40 @@ public:
    */
   static bool has_commands_queued();
 
+  /**
+   * Check for room to read one more command of up to MAX_CMD_SIZE
+   */
+  #if ENABLED(PACKED_COMMAND_QUEUE)
+    static bool has_room();
+  #else
+    static inline bool has_room() { return length < BUFSIZE; }
+  #endif
+
+  /**
+   * Number of further commands that are sure to fit
+   */
+  static uint8_t free_slots();
+
   /**
    * Get the next command in the queue, optionally log it to SD, then dispatch it
    */
   static void advance();
 
+  #if ENABLED(GCODE_PARSE_AHEAD)
+    static uint32_t parsed_ahead;   // Commands dispatched without waiting to be parsed
+
+    /**
+     * Parse the command after the current one, while waiting for the planner,
+     * so it can be dispatched as soon as the current command is done.
+     */
+    static void parse_ahead();
+
+    /**
+     * Load the parser with the command at index_r, if it was parsed ahead
+     */
+    static bool restore_parsed();
+  #endif
+
   /**
    * Add to the circular command queue the next command from:
    *  - The command-injection queue (injected_commands_P)
@@ -141,16 +201,34 @@ public:
    */
   static void ok_to_send();
 
+  /**
+   * For commands that send their own "ok" (M105), whether one is due
+   */
+  static bool ok_due();
+
   /**
    * Clear the serial line and request a resend of
    * the next expected line number.
    */
-  static void flush_and_request_resend();
+  static void flush_and_request_resend(const int16_t pn);
+  static inline void flush_and_request_resend() { flush_and_request_resend(command_port()); }
 
 private:
 
   static uint8_t index_w;  // Ring buffer write position
 
+  #if ENABLED(PACKED_COMMAND_QUEUE)
+    static uint16_t ring_w;  // Ring position after the last queued command
+
+    // Where the next command goes, so a full-length command fits before the end
+    static inline uint16_t next_command_pos() {
+      return ring_w + (MAX_CMD_SIZE) > (COMMAND_QUEUE_BYTES) ? 0 : ring_w;
+    }
+    static inline char* next_command() { return &command_ring[next_command_pos()]; }
+  #else
+    static inline char* next_command() { return command_buffer[index_w]; }
+  #endif
+
   static void get_serial_commands();
 
   #if ENABLED(SDSUPPORT)
@@ -27,11 +27,40 @@
 #include "../gcode.h"
 #include "../../sd/cardreader.h"
 
+#if ENABLED(SD_GCODE_INDEX)
+  #include "../../module/motion.h"
+#endif
+
 /**
  * M26: Set SD Card file index
+ *
+ *  S<byte>  - Set the file position
+ *  L<layer> - Go to the start of a layer, with SD_GCODE_INDEX, and set E
+ *             to the file's E position there. Layers are counted from 0.
  */
 void GcodeSuite::M26() {
-  if (card.isMounted() && parser.seenval('S'))
+  if (!card.isMounted()) return;
+
+  #if ENABLED(SD_GCODE_INDEX)
+    if (parser.seenval('L')) {
+      const uint16_t nr = parser.value_ushort();
+      gcode_index_layer_t l;
+      if (!card.isFileOpen() || !gcode_index.layer(nr, l)) {
+        SERIAL_ERROR_MSG("Layer not indexed.");
+        return;
+      }
+      card.setIndex(l.offset);
+      if (!l.relative_e) {
+        current_position.e = l.e;
+        sync_plan_position_e();
+      }
+      SERIAL_ECHO_START();
+      SERIAL_ECHOLNPAIR("Layer ", nr, " Z", l.z, " E", l.e, " at ", l.offset);
+      return;
+    }
+  #endif
+
+  if (parser.seenval('S'))
     card.setIndex(parser.value_long());
 }
 
@@ -31,6 +31,8 @@
  * M27: Get SD Card status
  *      OR, with 'S<seconds>' set the SD status auto-report interval. (Requires AUTO_REPORT_SD_STATUS)
  *      OR, with 'C' get the current filename.
+ *      OR, with 'L' get the background read times. (Requires SD_ASYNC_READ)
+ *      OR, with 'I' get the layer index state. (Requires SD_GCODE_INDEX)
  */
 void GcodeSuite::M27() {
   if (parser.seen('C')) {
@@ -38,6 +40,16 @@ void GcodeSuite::M27() {
     card.printFilename();
   }
 
+  #if ENABLED(SD_ASYNC_READ)
+    else if (parser.seen('L'))
+      card.report_read_stats();
+  #endif
+
+  #if ENABLED(SD_GCODE_INDEX)
+    else if (parser.seen('I'))
+      gcode_index.report();
+  #endif
+
   #if ENABLED(AUTO_REPORT_SD_STATUS)
     else if (parser.seenval('S'))
       card.set_auto_report_interval(parser.value_byte());
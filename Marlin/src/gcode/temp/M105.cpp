@@ -21,6 +21,7 @@
  */
 
 #include "../gcode.h"
+#include "../queue.h"
 #include "../../module/temperature.h"
 
 /**
@@ -31,7 +32,7 @@ void GcodeSuite::M105() {
   const int8_t target_extruder = get_target_extruder_from_command();
   if (target_extruder < 0) return;
 
-  SERIAL_ECHOPGM(STR_OK);
+  if (queue.ok_due()) SERIAL_ECHOPGM(STR_OK);
 
   #if HAS_TEMP_SENSOR
 
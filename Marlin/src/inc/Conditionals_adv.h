@@ -442,6 +442,11 @@
   #define SD_CONNECTION_IS(...) 0
 #endif
 
+// Power-loss recovery data kept off the SD card
+#if ANY(POWER_LOSS_RING_W25QXX, POWER_LOSS_RING_BL24CXX)
+  #define HAS_POWER_LOSS_RING 1
+#endif
+
 // Power Monitor sensors
 #if EITHER(POWER_MONITOR_CURRENT, POWER_MONITOR_VOLTAGE)
   #define HAS_POWER_MONITOR 1
@@ -464,7 +469,7 @@
 #endif
 
 // Flag whether least_squares_fit.cpp is used
-#if ANY(AUTO_BED_LEVELING_UBL, AUTO_BED_LEVELING_LINEAR, Z_STEPPER_ALIGN_KNOWN_STEPPER_POSITIONS)
+#if ANY(AUTO_BED_LEVELING_UBL, AUTO_BED_LEVELING_LINEAR, ABL_DRIFT_UPDATE, Z_STEPPER_ALIGN_KNOWN_STEPPER_POSITIONS)
   #define NEED_LSF 1
 #endif
 
@@ -594,6 +594,24 @@
   #error "SERIAL_XON_XOFF and SERIAL_STATS_* features not supported on USB-native AVR devices."
 #endif
 
+#ifdef SERIAL_TX_DEFER_PERCENT
+  #ifndef SERIAL_TX_QUEUED
+    #error "SERIAL_TX_DEFER_PERCENT requires TX_BUFFER_SIZE on AVR, or SERIAL_DMA on STM32F1, and a hardware SERIAL_PORT."
+  #elif !WITHIN(SERIAL_TX_DEFER_PERCENT, 1, 99)
+    #error "SERIAL_TX_DEFER_PERCENT must be from 1 to 99."
+  #endif
+#endif
+
+#if ENABLED(SERIAL_DMA)
+  #ifndef __STM32F1__
+    #error "SERIAL_DMA is currently only supported on STM32F1."
+  #elif RX_BUFFER_SIZE < 64
+    #error "SERIAL_DMA requires an RX_BUFFER_SIZE of 64 or more."
+  #elif ENABLED(SERIAL_XON_XOFF)
+    #error "SERIAL_DMA is not compatible with SERIAL_XON_XOFF."
+  #endif
+#endif
+
 #ifndef SERIAL_PORT
   #error "SERIAL_PORT must be defined in Configuration.h"
 #elif defined(SERIAL_PORT_2) && SERIAL_PORT_2 == SERIAL_PORT
@@ -1347,6 +1365,30 @@ static_assert(Y_MAX_LENGTH >= Y_BED_SIZE, "Movement bounds (Y_MIN_POS, Y_MAX_POS
     #endif
   #endif
 
+  #if ENABLED(ADAPTIVE_PROBING)
+    #if MULTIPLE_PROBING > 0
+      #error "ADAPTIVE_PROBING replaces MULTIPLE_PROBING. Disable one or the other."
+    #elif ADAPTIVE_PROBING_MIN_TAPS < 2
+      #error "ADAPTIVE_PROBING_MIN_TAPS must be 2 or more."
+    #elif ADAPTIVE_PROBING_MAX_TAPS < ADAPTIVE_PROBING_MIN_TAPS || ADAPTIVE_PROBING_MAX_TAPS > 20
+      #error "ADAPTIVE_PROBING_MAX_TAPS must be from ADAPTIVE_PROBING_MIN_TAPS to 20."
+    #endif
+    static_assert(ADAPTIVE_PROBING_STDDEV > 0 && ADAPTIVE_PROBING_OUTLIER > 0, "ADAPTIVE_PROBING_STDDEV and ADAPTIVE_PROBING_OUTLIER must be greater than 0.");
+  #endif
+
+  #if ENABLED(PROBE_ON_THE_FLY)
+    #if !(ABL_GRID && HAS_ABL_NOT_UBL)
+      #error "PROBE_ON_THE_FLY requires AUTO_BED_LEVELING_LINEAR or AUTO_BED_LEVELING_BILINEAR."
+    #elif IS_KINEMATIC
+      #error "PROBE_ON_THE_FLY is not compatible with DELTA or SCARA."
+    #elif ENABLED(SENSORLESS_PROBING)
+      #error "PROBE_ON_THE_FLY is not compatible with SENSORLESS_PROBING."
+    #elif ENABLED(PROBING_STEPPERS_OFF)
+      #error "PROBE_ON_THE_FLY is not compatible with PROBING_STEPPERS_OFF."
+    #endif
+    static_assert(PROBE_FLY_HOVER > 0 && PROBE_FLY_RUN_UP > 0 && PROBE_FLY_TOLERANCE > 0, "PROBE_FLY_HOVER, PROBE_FLY_RUN_UP, and PROBE_FLY_TOLERANCE must be greater than 0.");
+  #endif
+
   #if Z_PROBE_LOW_POINT > 0
     #error "Z_PROBE_LOW_POINT must be less than or equal to 0."
   #endif
@@ -1413,6 +1455,15 @@ static_assert(Y_MAX_LENGTH >= Y_BED_SIZE, "Movement bounds (Y_MIN_POS, Y_MAX_POS
     #error "SCARA machines can only use the AUTO_BED_LEVELING_BILINEAR leveling option."
   #endif
 
+  #if ENABLED(ABL_DRIFT_UPDATE)
+    #if DISABLED(AUTO_BED_LEVELING_BILINEAR)
+      #error "ABL_DRIFT_UPDATE requires AUTO_BED_LEVELING_BILINEAR."
+    #elif !HAS_BED_PROBE
+      #error "ABL_DRIFT_UPDATE requires a bed probe."
+    #endif
+    static_assert(ABL_DRIFT_TOLERANCE > 0, "ABL_DRIFT_TOLERANCE must be greater than 0.");
+  #endif
+
 #elif ENABLED(MESH_BED_LEVELING)
 
   // Hide PROBE_MANUALLY from the rest of the code
@@ -2737,6 +2788,60 @@ static_assert(   _ARR_TEST(3,0) && _ARR_TEST(3,1) && _ARR_TEST(3,2)
 
 #undef _ARR_TEST
 
+#if ENABLED(PREPARSED_GCODE_VALUES) && DISABLED(FASTER_GCODE_PARSER)
+  #error "PREPARSED_GCODE_VALUES requires FASTER_GCODE_PARSER."
+#endif
+
+#if ENABLED(GCODE_PARSE_AHEAD)
+  #if DISABLED(FASTER_GCODE_PARSER)
+    #error "GCODE_PARSE_AHEAD requires FASTER_GCODE_PARSER."
+  #elif ENABLED(GCODE_MOTION_MODES)
+    #error "GCODE_PARSE_AHEAD is incompatible with GCODE_MOTION_MODES."
+  #endif
+#endif
+
+#if ENABLED(CREDIT_FLOW_CONTROL)
+  #if !defined(CREDIT_WINDOW) || CREDIT_WINDOW < MAX_CMD_SIZE
+    #error "CREDIT_FLOW_CONTROL requires a CREDIT_WINDOW of at least MAX_CMD_SIZE."
+  #elif defined(RX_BUFFER_SIZE) && RX_BUFFER_SIZE > 0 && CREDIT_WINDOW >= RX_BUFFER_SIZE
+    #error "CREDIT_WINDOW must be less than RX_BUFFER_SIZE."
+  #endif
+#endif
+
+#ifdef BINARY_STREAM_WINDOW
+  #if DISABLED(BINARY_FILE_TRANSFER)
+    #error "BINARY_STREAM_WINDOW requires BINARY_FILE_TRANSFER."
+  #elif BINARY_STREAM_WINDOW != 2 && BINARY_STREAM_WINDOW != 4 && BINARY_STREAM_WINDOW != 8
+    #error "BINARY_STREAM_WINDOW must be 2, 4, or 8."
+  #endif
+#endif
+
+#if defined(SERIAL_PORT_WEIGHTS) && !defined(SERIAL_PORT_2)
+  #error "SERIAL_PORT_WEIGHTS requires SERIAL_PORT_2."
+#endif
+
+#if ENABLED(STATUS_QUERY_ASAP) && DISABLED(FASTER_GCODE_PARSER)
+  #error "STATUS_QUERY_ASAP requires FASTER_GCODE_PARSER."
+#endif
+
+#if BOTH(GCODE_DISPATCH_TABLE, MORGAN_SCARA)
+  #error "GCODE_DISPATCH_TABLE doesn't support the MORGAN_SCARA M360-M364 commands."
+#elif ENABLED(GCODE_DISPATCH_STATS) && DISABLED(GCODE_DISPATCH_TABLE)
+  #error "GCODE_DISPATCH_STATS requires GCODE_DISPATCH_TABLE."
+#endif
+
+#if ENABLED(PACKED_COMMAND_QUEUE)
+  #if !defined(COMMAND_QUEUE_BYTES)
+    #error "PACKED_COMMAND_QUEUE requires COMMAND_QUEUE_BYTES."
+  #elif COMMAND_QUEUE_BYTES < 2 * (MAX_CMD_SIZE)
+    #error "COMMAND_QUEUE_BYTES must be at least 2 * MAX_CMD_SIZE."
+  #elif COMMAND_QUEUE_BYTES > 65535
+    #error "COMMAND_QUEUE_BYTES must be 65535 or less."
+  #elif BUFSIZE > 255
+    #error "BUFSIZE must be 255 or less with PACKED_COMMAND_QUEUE."
+  #endif
+#endif
+
 #if BOTH(CNC_COORDINATE_SYSTEMS, NO_WORKSPACE_OFFSETS)
   #error "CNC_COORDINATE_SYSTEMS is incompatible with NO_WORKSPACE_OFFSETS."
 #endif
@@ -2771,6 +2876,42 @@ static_assert(   _ARR_TEST(3,0) && _ARR_TEST(3,1) && _ARR_TEST(3,2)
   #error "BACKUP_POWER_SUPPLY requires a POWER_LOSS_PIN."
 #endif
 
+#if ENABLED(POWER_LOSS_JOURNAL)
+  #if DISABLED(POWER_LOSS_RECOVERY)
+    #error "POWER_LOSS_JOURNAL requires POWER_LOSS_RECOVERY."
+  #elif !WITHIN(POWER_LOSS_JOURNAL_RECORDS, 8, 1024)
+    #error "POWER_LOSS_JOURNAL_RECORDS must be a number from 8 to 1024."
+  #endif
+#endif
+
+#if HAS_POWER_LOSS_RING
+  #if BOTH(POWER_LOSS_RING_W25QXX, POWER_LOSS_RING_BL24CXX)
+    #error "Enable only one of POWER_LOSS_RING_W25QXX or POWER_LOSS_RING_BL24CXX."
+  #elif DISABLED(POWER_LOSS_RECOVERY)
+    #error "POWER_LOSS_RING_* requires POWER_LOSS_RECOVERY."
+  #elif ENABLED(POWER_LOSS_JOURNAL)
+    #error "POWER_LOSS_JOURNAL can't be used with POWER_LOSS_RING_*."
+  #elif defined(POWER_LOSS_RING_SECTORS) && !WITHIN(POWER_LOSS_RING_SECTORS, 2, 64)
+    #error "POWER_LOSS_RING_SECTORS must be a number from 2 to 64."
+  #elif ENABLED(POWER_LOSS_RING_W25QXX)
+    #if !HAS_SPI_FLASH
+      #error "POWER_LOSS_RING_W25QXX requires a board with SPI flash (HAS_SPI_FLASH)."
+    #elif !defined(POWER_LOSS_RING_ADDR) && !defined(SPI_FLASH_SIZE)
+      #error "POWER_LOSS_RING_W25QXX requires POWER_LOSS_RING_ADDR or SPI_FLASH_SIZE."
+    #elif defined(POWER_LOSS_RING_SECTORS) && POWER_LOSS_RING_SECTORS < 3
+      #error "POWER_LOSS_RING_W25QXX requires 3 or more POWER_LOSS_RING_SECTORS."
+    #endif
+  #elif ENABLED(POWER_LOSS_RING_BL24CXX)
+    #if DISABLED(IIC_BL24CXX_EEPROM)
+      #error "POWER_LOSS_RING_BL24CXX requires IIC_BL24CXX_EEPROM."
+    #elif !defined(POWER_LOSS_RING_ADDR)
+      #error "POWER_LOSS_RING_BL24CXX requires POWER_LOSS_RING_ADDR."
+    #elif defined(MARLIN_EEPROM_SIZE) && POWER_LOSS_RING_ADDR < MARLIN_EEPROM_SIZE
+      #error "POWER_LOSS_RING_ADDR overlaps the settings stored in the EEPROM."
+    #endif
+  #endif
+#endif
+
 #if ENABLED(Z_STEPPER_AUTO_ALIGN)
   #if NUM_Z_STEPPER_DRIVERS <= 1
     #error "Z_STEPPER_AUTO_ALIGN requires NUM_Z_STEPPER_DRIVERS greater than 1."
@@ -2812,10 +2953,66 @@ static_assert(   _ARR_TEST(3,0) && _ARR_TEST(3,1) && _ARR_TEST(3,2)
   #error "SD_FIRMWARE_UPDATE requires an ATmega2560-based (Arduino Mega) board."
 #endif
 
+#if ENABLED(SD_READ_AHEAD) && !WITHIN(SD_READ_AHEAD_BLOCKS, 2, 8)
+  #error "SD_READ_AHEAD_BLOCKS must be a number from 2 to 8."
+#endif
+
+#if ENABLED(SD_ASYNC_READ) && !BOTH(SD_READ_AHEAD, SDIO_SUPPORT)
+  #error "SD_ASYNC_READ requires SD_READ_AHEAD and SDIO_SUPPORT."
+#endif
+
+#if defined(SD_CACHE_BLOCKS) && !WITHIN(SD_CACHE_BLOCKS, 1, 16)
+  #error "SD_CACHE_BLOCKS must be a number from 1 to 16."
+#endif
+
+#if ENABLED(SD_WRITE_STREAM)
+  #if ENABLED(SDCARD_READONLY)
+    #error "SD_WRITE_STREAM is not compatible with SDCARD_READONLY."
+  #elif !WITHIN(SD_WRITE_PREALLOCATE, 1, 255)
+    #error "SD_WRITE_PREALLOCATE must be a number from 1 to 255."
+  #endif
+#endif
+
+#if ENABLED(SD_FAST_SEEK) && !WITHIN(SD_SEEK_EXTENTS, 1, 32)
+  #error "SD_SEEK_EXTENTS must be a number from 1 to 32."
+#endif
+
+#if ENABLED(SD_GCODE_INDEX)
+  #if ENABLED(SDCARD_READONLY)
+    #error "SD_GCODE_INDEX is not compatible with SDCARD_READONLY."
+  #elif !WITHIN(SD_GCODE_INDEX_LAYERS, 100, 10000)
+    #error "SD_GCODE_INDEX_LAYERS must be a number from 100 to 10000."
+  #endif
+#endif
+
+#if ENABLED(SD_DIR_INDEX)
+  #if ENABLED(SDCARD_READONLY)
+    #error "SD_DIR_INDEX is not compatible with SDCARD_READONLY."
+  #elif !WITHIN(SD_DIR_INDEX_DIRS, 1, 16)
+    #error "SD_DIR_INDEX_DIRS must be a number from 1 to 16."
+  #elif !WITHIN(SD_DIR_INDEX_LIMIT, 16, 1024)
+    #error "SD_DIR_INDEX_LIMIT must be a number from 16 to 1024."
+  #endif
+#endif
+
 #if ENABLED(GCODE_MACROS) && !WITHIN(GCODE_MACROS_SLOTS, 1, 10)
   #error "GCODE_MACROS_SLOTS must be a number from 1 to 10."
 #endif
 
+#if ENABLED(GCODE_MACROS_PRECOMPILE)
+  #if DISABLED(FASTER_GCODE_PARSER)
+    #error "GCODE_MACROS_PRECOMPILE requires FASTER_GCODE_PARSER."
+  #elif GCODE_MACROS_SLOT_SIZE > 250
+    #error "GCODE_MACROS_SLOT_SIZE must be 250 or less with GCODE_MACROS_PRECOMPILE."
+  #elif !WITHIN(GCODE_MACROS_COMPILED_SIZE, 3, 1000)
+    #error "GCODE_MACROS_COMPILED_SIZE must be a number from 3 to 1000."
+  #endif
+#endif
+
+#if ENABLED(GCODE_MACROS_IN_EEPROM) && DISABLED(EEPROM_SETTINGS)
+  #error "GCODE_MACROS_IN_EEPROM requires EEPROM_SETTINGS."
+#endif
+
 #if ENABLED(CUSTOM_USER_MENUS)
   #ifdef USER_GCODE_1
     constexpr char _chr1 = USER_GCODE_1[strlen(USER_GCODE_1) - 1];
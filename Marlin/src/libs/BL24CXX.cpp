@@ -261,13 +261,46 @@ void BL24CXX::read(uint16_t ReadAddr, uint8_t *pBuffer, uint16_t NumToRead) {
     *pBuffer++ = readOneByte(ReadAddr++);
 }
 
+// Bytes that can be sent in one write cycle
+#if EE_TYPE <= BL24C02
+  #define EE_PAGE_SIZE  8
+#elif EE_TYPE <= BL24C16
+  #define EE_PAGE_SIZE 16
+#elif EE_TYPE <= BL24C64
+  #define EE_PAGE_SIZE 32
+#else
+  #define EE_PAGE_SIZE 64
+#endif
+
 // Start writing the specified number of data at the specified address in BL24CXX
+// Data is sent a page at a time, with one write cycle delay for each page.
 // WriteAddr: the address to start writing, 0~255 for 24c02
 // pBuffer: the first address of the data array
 // NumToWrite: the number of data to be written
 void BL24CXX::write(uint16_t WriteAddr, uint8_t *pBuffer, uint16_t NumToWrite) {
-  for (; NumToWrite; NumToWrite--, WriteAddr++)
-    writeOneByte(WriteAddr, *pBuffer++);
+  while (NumToWrite) {
+    uint16_t n = _MIN(NumToWrite, uint16_t(EE_PAGE_SIZE - WriteAddr % (EE_PAGE_SIZE)));
+    IIC::start();
+    if (EE_TYPE > BL24C16) {
+      IIC::send_byte(EEPROM_DEVICE_ADDRESS);      // Send write command
+      IIC::wait_ack();
+      IIC::send_byte(WriteAddr >> 8);             // Send high address
+    }
+    else
+      IIC::send_byte(EEPROM_DEVICE_ADDRESS + ((WriteAddr >> 8) << 1)); // Send device address 0xA0, write data
+
+    IIC::wait_ack();
+    IIC::send_byte(WriteAddr & 0xFF);             // Send low address
+    IIC::wait_ack();
+    WriteAddr += n;
+    NumToWrite -= n;
+    for (; n; n--) {
+      IIC::send_byte(*pBuffer++);                 // Up to the end of the page
+      IIC::wait_ack();
+    }
+    IIC::stop();                                  // Start the write cycle
+    delay(10);
+  }
 }
 
 #endif // IIC_BL24CXX_EEPROM
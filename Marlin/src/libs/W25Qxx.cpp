@@ -138,6 +138,9 @@ uint16_t W25QXXFlash::W25QXX_ReadID(void) {
 }
 
 void W25QXXFlash::SPI_FLASH_WriteEnable(void) {
+  /* Wait for an erase started without waiting, since the FLASH ignores other instructions until it ends */
+  SPI_FLASH_WaitForWriteEnd();
+
   /* Select the FLASH: Chip Select low */
   W25QXX_CS_L;
   /* Send "Write Enable" instruction */
@@ -174,7 +177,7 @@ void W25QXXFlash::SPI_FLASH_WaitForWriteEnd(void) {
   W25QXX_CS_H;
 }
 
-void W25QXXFlash::SPI_FLASH_SectorErase(uint32_t SectorAddr) {
+void W25QXXFlash::SPI_FLASH_SectorErase(uint32_t SectorAddr, const bool wait/*=true*/) {
   /* Send write enable instruction */
   SPI_FLASH_WriteEnable();
 
@@ -192,8 +195,8 @@ void W25QXXFlash::SPI_FLASH_SectorErase(uint32_t SectorAddr) {
   /* Deselect the FLASH: Chip Select high */
 
   W25QXX_CS_H;
-  /* Wait the end of Flash writing */
-  SPI_FLASH_WaitForWriteEnd();
+  /* Wait the end of Flash writing, or let the next instruction wait for it */
+  if (wait) SPI_FLASH_WaitForWriteEnd();
 }
 
 void W25QXXFlash::SPI_FLASH_BlockErase(uint32_t BlockAddr) {
@@ -358,6 +361,9 @@ void W25QXXFlash::SPI_FLASH_BufferWrite(uint8_t* pBuffer, uint32_t WriteAddr, ui
 * Return         : None
 *******************************************************************************/
 void W25QXXFlash::SPI_FLASH_BufferRead(uint8_t* pBuffer, uint32_t ReadAddr, uint16_t NumByteToRead) {
+  /* Wait for an erase started without waiting */
+  SPI_FLASH_WaitForWriteEnd();
+
   /* Select the FLASH: Chip Select low */
   W25QXX_CS_L;
 
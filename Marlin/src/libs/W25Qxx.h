@@ -59,7 +59,7 @@ public:
   static uint16_t W25QXX_ReadID(void);
   static void SPI_FLASH_WriteEnable(void);
   static void SPI_FLASH_WaitForWriteEnd(void);
-  static void SPI_FLASH_SectorErase(uint32_t SectorAddr);
+  static void SPI_FLASH_SectorErase(uint32_t SectorAddr, const bool wait=true);
   static void SPI_FLASH_BlockErase(uint32_t BlockAddr);
   static void SPI_FLASH_BulkErase(void);
   static void SPI_FLASH_PageWrite(uint8_t* pBuffer, uint32_t WriteAddr, uint16_t NumByteToWrite);
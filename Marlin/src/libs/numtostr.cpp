@@ -31,9 +31,11 @@ char conv[8] = { 0 };
 #define DIGIMOD(n, f) DIGIT((n)/(f) % 10)
 #define RJDIGIT(n, f) ((n) >= (f) ? DIGIMOD(n, f) : ' ')
 #define MINUSOR(n, alt) (n >= 0 ? (alt) : (n = -n, '-'))
-#define INTFLOAT(V,N) (((V) * 10 * pow(10, N) + ((V) < 0 ? -5: 5)) / 10)      // pow10?
+#define INTFLOAT(V,N) long((V) * ipow10f(N) + ((V) < 0 ? -0.5f : 0.5f))    // Single precision, no double math
 #define UINTFLOAT(V,N) INTFLOAT((V) < 0 ? -(V) : (V), N)
 
+static constexpr float ipow10f(const uint8_t n) { return n ? 10.0f * ipow10f(n - 1) : 1.0f; }
+
 // Convert a full-range unsigned 8bit int to a percentage
 const char* ui8tostr4pctrj(const uint8_t i) {
   const uint8_t n = ui8_to_percent(i);
@@ -402,3 +404,32 @@ const char* ftostr52sp(const float &f) {
   }
   return conv;
 }
+
+// Convert signed float to string with 0-6 decimal places and -12.345 format, like Print::print(float, places)
+const char* ftostrdp(const float &f, const uint8_t places) {
+  static char buf[19];                // -4294967040.123456
+  if (isnan(f)) return "nan";
+  if (isinf(f)) return "inf";
+  if (f > 4294967040.0f || f < -4294967040.0f) return "ovf";
+
+  static const uint32_t scales[] PROGMEM = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+  const uint8_t dp = _MIN(places, COUNT(scales) - 1);
+  const uint32_t scale = pgm_read_dword(&scales[dp]);
+  const bool neg = f < 0;
+  const float x = neg ? -f : f;
+  uint32_t whole = x;
+  // The fraction is exact, and so is scaling it to 32 bits. Round it once in integer math.
+  const uint32_t frac32 = (x - whole) * 4294967296.0f;
+  uint32_t frac = (uint64_t(frac32) * scale + 0x80000000UL) >> 32;
+  if (frac >= scale) { frac -= scale; whole++; }
+
+  char *p = &buf[sizeof(buf) - 1];
+  *p = '\0';
+  if (dp) {
+    LOOP_L_N(i, dp) { *--p = DIGIT(frac % 10); frac /= 10; }
+    *--p = '.';
+  }
+  do { *--p = DIGIT(whole % 10); whole /= 10; } while (whole);
+  if (neg) *--p = '-';
+  return p;
+}
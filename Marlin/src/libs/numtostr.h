@@ -109,6 +109,9 @@ const char* ftostr53sign(const float &f);
 // Convert unsigned float to string with 1234.5 format omitting trailing zeros
 const char* ftostr51rj(const float &x);
 
+// Convert signed float to string with 0-6 decimal places and -12.345 format, like Print::print(float, places)
+const char* ftostrdp(const float &x, const uint8_t places);
+
 #include "../core/macros.h"
 
 // Convert float to rj string with 123 or -12 format
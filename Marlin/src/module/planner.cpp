@@ -238,6 +238,11 @@ float Planner::previous_nominal_speed_sqr;
   volatile uint32_t Planner::block_buffer_runtime_us = 0;
 #endif
 
+#if ENABLED(GCODE_PARSE_AHEAD)
+  uint32_t Planner::stall_count, // = 0
+           Planner::stall_ms;    // = 0
+#endif
+
 /**
  * Class and Instance Methods
  */
@@ -636,6 +636,11 @@ class Planner {
     // Get count of movement slots free
     FORCE_INLINE static uint8_t moves_free() { return BLOCK_BUFFER_SIZE - 1 - movesplanned(); }
 
+    #if ENABLED(GCODE_PARSE_AHEAD)
+      static uint32_t stall_count,  // Times a move had to wait for a free block
+                      stall_ms;     // Total time spent waiting
+    #endif
+
     /**
      * Planner::get_next_free_block
      *
@@ -646,7 +651,16 @@ class Planner {
     FORCE_INLINE static block_t* get_next_free_block(uint8_t &next_buffer_head, const uint8_t count=1) {
 
       // Wait until there are enough slots free
-      while (moves_free() < count) { idle(); }
+      #if ENABLED(GCODE_PARSE_AHEAD)
+        if (moves_free() < count) {
+          const millis_t ms = millis();
+          do { idle(); queue.parse_ahead(); } while (moves_free() < count);
+          stall_count++;
+          stall_ms += millis() - ms;
+        }
+      #else
+        while (moves_free() < count) { idle(); }
+      #endif
 
       // Return the first available block
       next_buffer_head = next_block_index(block_buffer_head);
@@ -48,7 +48,7 @@
   #include "delta.h"
 #endif
 
-#if ENABLED(BABYSTEP_ZPROBE_OFFSET)
+#if EITHER(BABYSTEP_ZPROBE_OFFSET, PROBE_ON_THE_FLY)
   #include "planner.h"
 #endif
 
@@ -92,6 +92,10 @@ xyz_pos_t Probe::offset; // Initialized by settings.load()
   const xyz_pos_t &Probe::offset_xy = Probe::offset;
 #endif
 
+#if ENABLED(ADAPTIVE_PROBING)
+  uint8_t Probe::taps, Probe::rejected_taps;
+#endif
+
 #if ENABLED(Z_PROBE_SLED)
 
   #ifndef SLED_DOCKING_OFFSET
@@ -552,6 +556,45 @@ float Probe::run_z_probe(const bool sanity_check/*=true*/) {
     }
   #endif
 
+  #if ENABLED(ADAPTIVE_PROBING)
+
+    // Tap until the taps agree, up to a maximum number of taps
+    float probes[ADAPTIVE_PROBING_MAX_TAPS], measured_z = NAN;
+    for (taps = 0;;) {
+      // Probe downward slowly to find the bed
+      if (try_to_probe(PSTR("SLOW"), z_probe_low_point, MMM_TO_MMS(Z_PROBE_SPEED_SLOW),
+                       sanity_check, Z_CLEARANCE_MULTI_PROBE) ) return NAN;
+
+      TERN_(MEASURE_BACKLASH_WHEN_PROBING, backlash.measure_with_probe());
+
+      // Insert Z measurement into probes[]. Keep it sorted ascending.
+      const float z = current_position.z;
+      uint8_t i = taps++;
+      for (; i && probes[i - 1] > z; --i) probes[i] = probes[i - 1];
+      probes[i] = z;
+
+      // Reject outliers around the median and get the mean and deviation of the rest
+      const float median = (taps & 1) ? probes[taps / 2] : (probes[taps / 2 - 1] + probes[taps / 2]) * 0.5f;
+      #define GOOD_TAP(T) (ABS(probes[T] - median) <= ADAPTIVE_PROBING_OUTLIER)
+      float z_sum = 0, dev_sum = 0;
+      uint8_t good = 0;
+      LOOP_L_N(t, taps) if (GOOD_TAP(t)) { z_sum += probes[t]; good++; }
+      measured_z = good ? z_sum / good : median;
+      LOOP_L_N(t, taps) if (GOOD_TAP(t)) dev_sum += sq(probes[t] - measured_z);
+      rejected_taps = taps - good;
+      const float std_dev = good > 1 ? SQRT(dev_sum / (good - 1)) : 999;
+
+      if (DEBUGGING(LEVELING)) DEBUG_ECHOLNPAIR("Tap ", int(taps), " Z:", z, " Mean:", measured_z, " StdDev:", std_dev, " Rejected:", int(rejected_taps));
+
+      // Done when enough good taps agree, or out of taps
+      if ((good >= ADAPTIVE_PROBING_MIN_TAPS && std_dev <= ADAPTIVE_PROBING_STDDEV) || taps >= ADAPTIVE_PROBING_MAX_TAPS) break;
+
+      // Small Z raise before the next tap
+      do_blocking_move_to_z(z + Z_CLEARANCE_MULTI_PROBE, MMM_TO_MMS(Z_PROBE_SPEED_FAST));
+    }
+
+  #else // !ADAPTIVE_PROBING
+
   #if EXTRA_PROBING > 0
     float probes[TOTAL_PROBING];
   #endif
@@ -638,6 +681,8 @@ float Probe::run_z_probe(const bool sanity_check/*=true*/) {
 
   #endif
 
+  #endif // !ADAPTIVE_PROBING
+
   return measured_z;
 }
 
@@ -702,8 +747,11 @@ float Probe::probe_at_point(const float &rx, const float &ry, const ProbePtRaise
     else if (raise_after == PROBE_PT_STOW)
       if (stow()) measured_z = NAN;   // Error on stow?
 
-    if (verbose_level > 2)
-      SERIAL_ECHOLNPAIR("Bed X: ", LOGICAL_X_POSITION(rx), " Y: ", LOGICAL_Y_POSITION(ry), " Z: ", measured_z);
+    if (verbose_level > 2) {
+      SERIAL_ECHOPAIR("Bed X: ", LOGICAL_X_POSITION(rx), " Y: ", LOGICAL_Y_POSITION(ry), " Z: ", measured_z);
+      TERN_(ADAPTIVE_PROBING, SERIAL_ECHOPAIR(" Taps: ", int(taps), " Rejected: ", int(rejected_taps)));
+      SERIAL_EOL();
+    }
   }
 
   feedrate_mm_s = old_feedrate_mm_s;
@@ -719,6 +767,110 @@ float Probe::probe_at_point(const float &rx, const float &ry, const ProbePtRaise
   return measured_z;
 }
 
+#if ENABLED(PROBE_ON_THE_FLY)
+
+  float Probe::fly_ref_z = NAN;
+
+  /**
+   * Probe a grid point without stopping, raising and descending:
+   * - Go to hover over the last trigger height while moving to the run-up point
+   * - Dive diagonally through the point, reaching the last trigger height right over it
+   * - Take the trigger Z from the step counters and the trigger XY from the stopped steppers
+   *
+   * With no reference height, no trigger, or a trigger too far from the point
+   * fall back to a regular probe_at_point, which also sets the new reference.
+   * The dive gets the same bed heating wait and quiet probing as run_z_probe.
+   *
+   * @return The Z position of the bed at the given XY or NAN on error.
+   */
+  float Probe::fly_at_point(const xy_pos_t &pos, const uint8_t verbose_level/*=0*/) {
+    DEBUG_SECTION(log_fly, "Probe::fly_at_point", DEBUGGING(LEVELING));
+
+    #if BOTH(BLTOUCH, BLTOUCH_HS_MODE)
+      if (bltouch.triggered()) bltouch._reset();
+    #endif
+
+    if (!can_reach(pos)) {
+      if (DEBUGGING(LEVELING)) DEBUG_ECHOLNPGM("Position Not Reachable");
+      return NAN;
+    }
+
+    auto probe_normally = [&]{
+      // probe_at_point travels at the current height, which may be the last trigger
+      if (!isnan(fly_ref_z)) do_z_clearance(fly_ref_z + Z_CLEARANCE_BETWEEN_PROBES);
+      const float measured_z = probe_at_point(pos, PROBE_PT_RAISE, verbose_level);
+      fly_ref_z = measured_z - offset.z;
+      return measured_z;
+    };
+
+    const xy_pos_t npos = pos - offset_xy;  // The nozzle position over the point
+    xy_pos_t dir = npos - current_position;
+    const float dist = dir.magnitude();
+
+    // The first point, or one too close for a run-up
+    if (isnan(fly_ref_z) || dist < (PROBE_FLY_RUN_UP)) return probe_normally();
+
+    dir *= 1.0f / dist;
+
+    // Go to hover height and the run-up point in one move. After a regular probe this
+    // comes down from the clearance height, and a trigger on the way shows as a miss.
+    current_position.set(npos - dir * float(PROBE_FLY_RUN_UP), fly_ref_z + (PROBE_FLY_HOVER));
+    line_to_current_position(XY_PROBE_FEEDRATE_MM_S);
+
+    #if BOTH(HAS_HEATED_BED, WAIT_FOR_BED_HEATER)
+      thermalManager.wait_for_bed_heating();
+    #endif
+
+    #if QUIET_PROBING || (ENABLED(BLTOUCH) && DISABLED(BLTOUCH_HS_MODE))
+      planner.synchronize();
+    #endif
+
+    #if ENABLED(BLTOUCH) && DISABLED(BLTOUCH_HS_MODE)
+      if (bltouch.deploy()) return NAN; // DEPLOY in LOW SPEED MODE on every probe action
+    #endif
+
+    TERN_(QUIET_PROBING, set_probing_paused(true));
+
+    // Dive through the point at a feedrate that keeps Z at the slow probing speed
+    const float dive_ratio = HYPOT(PROBE_FLY_RUN_UP, PROBE_FLY_HOVER) / (PROBE_FLY_HOVER);
+    current_position.set(npos + dir * float(PROBE_FLY_RUN_UP), fly_ref_z - (PROBE_FLY_HOVER));
+    line_to_current_position(_MIN(MMM_TO_MMS(Z_PROBE_SPEED_SLOW) * dive_ratio, XY_PROBE_FEEDRATE_MM_S));
+    planner.synchronize();
+
+    const bool probe_triggered = TEST(endstops.trigger_state(), TERN(Z_MIN_PROBE_USES_Z_MIN_ENDSTOP_PIN, Z_MIN, Z_MIN_PROBE));
+    const float trigger_z = planner.triggered_position_mm(Z_AXIS);
+
+    TERN_(QUIET_PROBING, set_probing_paused(false));
+
+    #if ENABLED(BLTOUCH) && DISABLED(BLTOUCH_HS_MODE)
+      if (probe_triggered && bltouch.stow()) return NAN; // STOW in LOW SPEED MODE on trigger on every probe action
+    #endif
+
+    // Clear endstop flags
+    endstops.hit_on_purpose();
+
+    // Get XYZ where the steppers were interrupted
+    set_current_from_steppers_for_axis(ALL_AXES);
+    sync_plan_position();
+
+    const float miss = (npos - current_position).magnitude();
+    if (!probe_triggered || miss > (PROBE_FLY_TOLERANCE)) {
+      if (DEBUGGING(LEVELING)) DEBUG_ECHOLNPAIR("Fly miss. Triggered:", probe_triggered, " XY error:", miss);
+      do_blocking_move_to_z(current_position.z + Z_CLEARANCE_BETWEEN_PROBES, MMM_TO_MMS(Z_PROBE_SPEED_FAST));
+      return probe_normally();
+    }
+
+    fly_ref_z = trigger_z;
+
+    const float measured_z = trigger_z + offset.z;
+    if (verbose_level > 2)
+      SERIAL_ECHOLNPAIR("Bed X: ", LOGICAL_X_POSITION(pos.x), " Y: ", LOGICAL_Y_POSITION(pos.y), " Z: ", measured_z);
+
+    return measured_z;
+  }
+
+#endif // PROBE_ON_THE_FLY
+
 #if HAS_Z_SERVO_PROBE
 
   void Probe::servo_probe_init() {
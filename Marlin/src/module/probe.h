@@ -45,6 +45,10 @@ public:
 
     static xyz_pos_t offset;
 
+    #if ENABLED(ADAPTIVE_PROBING)
+      static uint8_t taps, rejected_taps; // Taps used for the last probed point
+    #endif
+
     static bool set_deployed(const bool deploy);
 
     #if IS_KINEMATIC
@@ -89,6 +93,12 @@ public:
       return probe_at_point(pos.x, pos.y, raise_after, verbose_level, probe_relative, sanity_check);
     }
 
+    #if ENABLED(PROBE_ON_THE_FLY)
+      // Forget the reference height so the next flown point is probed normally
+      static inline void fly_reset() { fly_ref_z = NAN; }
+      static float fly_at_point(const xy_pos_t &pos, const uint8_t verbose_level=0);
+    #endif
+
   #else
 
     static constexpr xyz_pos_t offset = xyz_pos_t({ 0, 0, 0 }); // See #16767
@@ -220,6 +230,10 @@ private:
   static bool probe_down_to_z(const float z, const feedRate_t fr_mm_s);
   static void do_z_raise(const float z_raise);
   static float run_z_probe(const bool sanity_check=true);
+
+  #if ENABLED(PROBE_ON_THE_FLY)
+    static float fly_ref_z;   // Nozzle Z of the last trigger, or NAN
+  #endif
 };
 
 extern Probe probe;
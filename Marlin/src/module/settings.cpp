@@ -152,6 +152,10 @@
   #include "../lcd/tft/touch.h"
 #endif
 
+#if ENABLED(GCODE_MACROS_IN_EEPROM)
+  #include "../feature/gcode_macros.h"
+#endif
+
 #pragma pack(push, 1) // No padding between variables
 
 typedef struct { uint16_t X, Y, Z, X2, Y2, Z2, Z3, Z4, E0, E1, E2, E3, E4, E5, E6, E7; } tmc_stepper_current_t;
@@ -453,6 +457,13 @@ typedef struct SettingsDataStruct {
     touch_calibration_t touch_calibration;
   #endif
 
+  //
+  // GCODE_MACROS_IN_EEPROM
+  //
+  #if ENABLED(GCODE_MACROS_IN_EEPROM)
+    char gcode_macros[GCODE_MACROS_SLOTS][GCODE_MACROS_SLOT_SIZE + 1]; // M810-M819
+  #endif
+
 } SettingsData;
 
 //static_assert(sizeof(SettingsData) <= MARLIN_EEPROM_SIZE, "EEPROM too small to contain SettingsData!");
@@ -506,6 +517,8 @@ void MarlinSettings::postprocess() {
 
   TERN_(HAS_CASE_LIGHT_BRIGHTNESS, caselight.update_brightness());
 
+  TERN_(GCODE_MACROS_IN_EEPROM, gcode_macros.refresh());
+
   // Refresh steps_to_mm with the reciprocal of axis_steps_per_mm
   // and init stepper.count[], planner.position[] with current_position
   planner.refresh_positioning();
@@ -1450,6 +1463,13 @@ void MarlinSettings::postprocess() {
       EEPROM_WRITE(touch.calibration);
     #endif
 
+    //
+    // G-code Macros
+    //
+    #if ENABLED(GCODE_MACROS_IN_EEPROM)
+      EEPROM_WRITE(gcode_macros.text);
+    #endif
+
     //
     // Validate CRC and Data Size
     //
@@ -2365,6 +2385,14 @@ void MarlinSettings::postprocess() {
         EEPROM_READ(touch.calibration);
       #endif
 
+      //
+      // G-code Macros
+      //
+      #if ENABLED(GCODE_MACROS_IN_EEPROM)
+        _FIELD_TEST(gcode_macros);
+        EEPROM_READ(gcode_macros.text);
+      #endif
+
       eeprom_error = size_error(eeprom_index - (EEPROM_OFFSET));
       if (eeprom_error) {
         DEBUG_ECHO_START();
@@ -2672,6 +2700,11 @@ void MarlinSettings::reset() {
   //
   TERN_(TOUCH_SCREEN_CALIBRATION, touch.calibration_reset());
 
+  //
+  // G-code Macros
+  //
+  TERN_(GCODE_MACROS_IN_EEPROM, gcode_macros.reset());
+
   //
   // Magnetic Parking Extruder
   //
@@ -3926,6 +3959,18 @@ void MarlinSettings::reset() {
         #endif
       );
     #endif
+
+    #if ENABLED(GCODE_MACROS_IN_EEPROM)
+      CONFIG_ECHO_HEADING("G-code macros:");
+      LOOP_L_N(i, GCODE_MACROS_SLOTS) {
+        const char *c = gcode_macros.text[i];
+        if (!*c) continue;
+        CONFIG_ECHO_START();
+        SERIAL_ECHOPAIR("  M", 810 + i, " ");
+        for (; *c; ++c) SERIAL_CHAR(*c == '\n' ? '|' : *c);
+        SERIAL_EOL();
+      }
+    #endif
   }
 
 #endif // !DISABLE_M503
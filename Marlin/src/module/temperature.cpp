@@ -3080,7 +3080,7 @@ void Temperature::tick() {
     millis_t Temperature::next_temp_report_ms;
 
     void Temperature::auto_report_temperatures() {
-      if (auto_report_temp_interval && ELAPSED(millis(), next_temp_report_ms)) {
+      if (auto_report_temp_interval && ELAPSED(millis(), next_temp_report_ms) && !SERIAL_TX_DEFER()) {
         next_temp_report_ms = millis() + 1000UL * auto_report_temp_interval;
         PORT_REDIRECT(SERIAL_BOTH);
         print_heater_states(active_extruder);
@@ -28,12 +28,20 @@
 bool SDIO_Init();
 bool SDIO_ReadBlock(uint32_t block, uint8_t *dst);
 bool SDIO_WriteBlock(uint32_t block, const uint8_t *src);
+#if ENABLED(SD_ASYNC_READ)
+  bool SDIO_ReadStart(uint32_t block, uint8_t *dst);  // Start reading a block in the background
+  int8_t SDIO_ReadDone();                             // 1 when the block is in, 0 while busy, -1 on error
+#endif
 
 class Sd2Card {
   public:
     bool init(uint8_t sckRateID = 0, uint8_t chipSelectPin = 0) { return SDIO_Init(); }
     bool readBlock(uint32_t block, uint8_t *dst) { return SDIO_ReadBlock(block, dst); }
     bool writeBlock(uint32_t block, const uint8_t *src) { return SDIO_WriteBlock(block, src); }
+    #if ENABLED(SD_ASYNC_READ)
+      bool readBlockStart(uint32_t block, uint8_t *dst) { return SDIO_ReadStart(block, dst); }
+      int8_t readBlockDone() { return SDIO_ReadDone(); }
+    #endif
 };
 
 #endif // SDIO_SUPPORT
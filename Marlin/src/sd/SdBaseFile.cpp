@@ -49,6 +49,17 @@ void (*SdBaseFile::dateTime_)(uint16_t* date, uint16_t* time) = 0;
 bool SdBaseFile::addCluster() {
   if (ENABLED(SDCARD_READONLY)) return false;
 
+  #if ENABLED(SD_WRITE_STREAM)
+    // Allocate ahead for files, so the FAT is written less often and the
+    // data blocks are consecutive. close() frees the clusters not used.
+    uint32_t c = curCluster_;
+    if (isFile() && vol_->allocContiguous(SD_WRITE_PREALLOCATE, &c)) {
+      curCluster_ = c;
+      flags_ |= F_FILE_PREALLOC;
+      preallocEnd_ = vol_->clusterStartBlock(c) + (uint32_t(SD_WRITE_PREALLOCATE) << vol_->clusterSizeShift_);
+    }
+    else
+  #endif
   if (!vol_->allocContiguous(1, &curCluster_)) return false;
 
   // if first cluster of file link to directory entry
@@ -77,11 +88,11 @@ bool SdBaseFile::addDirCluster() {
   vol_->cacheSetBlockNumber(block, true);
 
   // zero first block of cluster
-  memset(vol_->cacheBuffer_.data, 0, 512);
+  memset(vol_->cache()->data, 0, 512);
 
   // zero rest of cluster
   for (uint8_t i = 1; i < vol_->blocksPerCluster_; i++) {
-    if (!vol_->writeBlock(block + i, vol_->cacheBuffer_.data)) return false;
+    if (!vol_->writeBlock(block + i, vol_->cache()->data)) return false;
   }
   // Increase directory file size by cluster size
   fileSize_ += 512UL << vol_->clusterSizeShift_;
@@ -103,11 +114,40 @@ dir_t* SdBaseFile::cacheDirEntry(uint8_t action) {
  * Reasons for failure include no file is open or an I/O error.
  */
 bool SdBaseFile::close() {
-  bool rtn = sync();
+  bool rtn = TERN1(SD_WRITE_STREAM, freePreallocated()) && sync();
+  TERN_(SD_WRITE_STREAM, vol_->streamHint(0, 0));
   type_ = FAT_FILE_TYPE_CLOSED;
   return rtn;
 }
 
+#if ENABLED(SD_WRITE_STREAM)
+
+  /**
+   * Appending at 'block' of the preallocated clusters, so it and the blocks
+   * after it hold no data on the card. Let a stream starting there pre-erase
+   * them. Data already in the file, and other files, are never hinted.
+   */
+  void SdBaseFile::hintAppend(const uint32_t block) {
+    if ((flags_ & F_FILE_PREALLOC) && block < preallocEnd_ && block >= vol_->clusterStartBlock(curCluster_))
+      vol_->streamHint(block, preallocEnd_ - block);
+  }
+
+  // Free the clusters that addCluster() allocated past the end of the data
+  bool SdBaseFile::freePreallocated() {
+    if (!(flags_ & F_FILE_PREALLOC)) return true;
+    flags_ &= ~F_FILE_PREALLOC;
+
+    if (fileSize_) return truncate(fileSize_);
+
+    // truncate() does nothing to an empty file
+    if (!vol_->freeChain(firstCluster_)) return false;
+    firstCluster_ = curCluster_ = 0;
+    flags_ |= F_FILE_DIR_DIRTY;
+    return true;
+  }
+
+#endif
+
 /**
  * Check for contiguous file and return its raw block range.
  *
@@ -850,7 +890,7 @@ bool SdBaseFile::openParent(SdBaseFile* dir) {
   // first block of parent dir
   if (!vol_->cacheRawBlock(lbn, SdVolume::CACHE_FOR_READ)) return false;
 
-  p = &vol_->cacheBuffer_.dir[1];
+  p = &vol_->cache()->dir[1];
   // verify name for '../..'
   if (p->name[0] != '.' || p->name[1] != '.') return false;
   // '..' is pointer to first cluster of parent. open '../..' to find parent
@@ -1059,6 +1099,109 @@ int16_t SdBaseFile::read(void* buf, uint16_t nbyte) {
   return nbyte;
 }
 
+#if ENABLED(SD_READ_AHEAD)
+
+  // Get the card block at the current position, which must be at a
+  // block boundary, and move past it. False on a FAT read error.
+  bool SdBaseFile::nextBlock(uint32_t &block) {
+    if (type_ == FAT_FILE_TYPE_ROOT_FIXED)
+      block = vol_->rootDirStart() + (curPosition_ >> 9);
+    else {
+      const uint8_t blockOfCluster = vol_->blockOfCluster(curPosition_);
+      if (blockOfCluster == 0) {
+        // start of new cluster
+        if (curPosition_ == 0)
+          curCluster_ = firstCluster_;
+        else if (!vol_->fatGet(curCluster_, &curCluster_))
+          return false;
+      }
+      block = vol_->clusterStartBlock(curCluster_) + blockOfCluster;
+    }
+    curPosition_ += 512;
+    return true;
+  }
+
+  /**
+   * Read whole blocks of a file starting at the current position,
+   * which must be at a block boundary. Each run of blocks that are
+   * consecutive on the card is read with a single multi-block read.
+   *
+   * \param[out] dst Pointer to room for \a count blocks.
+   *
+   * \param[in] count Number of blocks to read.
+   *
+   * \return The number of bytes read, less than \a count * 512
+   * at the end of the file, or -1 for failure. On failure the file
+   * position is unchanged.
+   */
+  int16_t SdBaseFile::readBlocks(uint8_t* dst, const uint8_t count) {
+    if (!isOpen() || !(flags_ & O_READ) || (curPosition_ & 0x1FF)) return -1;
+
+    const uint32_t startPosition = curPosition_;
+    const uint16_t nbyte = _MIN(fileSize_ - curPosition_, uint32_t(count) << 9);
+
+    uint32_t runStart = 0;
+    uint8_t run = 0;
+    for (uint16_t done = 0; done < nbyte; done += 512) {
+      uint32_t block;  // raw device block number
+      if (!nextBlock(block)) goto FAIL;
+
+      // Read the previous run when this block doesn't follow it
+      if (run && block != runStart + run) {
+        if (!vol_->readBlocks(runStart, dst, run)) goto FAIL;
+        dst += uint16_t(run) << 9;
+        run = 0;
+      }
+      if (!run) runStart = block;
+      run++;
+    }
+    if (run && !vol_->readBlocks(runStart, dst, run)) goto FAIL;
+
+    curPosition_ = startPosition + nbyte;
+    return nbyte;
+
+    FAIL:
+    seekSet(startPosition);
+    return -1;
+  }
+
+  #if ENABLED(SD_ASYNC_READ)
+
+    /**
+     * Start reading the block at the current position in the background.
+     * A block that is in the volume's cache is copied right away.
+     *
+     * \param[out] dst Pointer to room for one block.
+     *
+     * \param[out] busy Set if the read has to be finished with SdVolume::readBlockDone().
+     *
+     * \return The number of bytes the block holds, 0 at the end of the file,
+     * or -1 for failure. On failure the file position is unchanged.
+     */
+    int16_t SdBaseFile::readBlockStart(uint8_t* dst, bool &busy) {
+      if (!isOpen() || !(flags_ & O_READ) || (curPosition_ & 0x1FF)) return -1;
+
+      const uint32_t startPosition = curPosition_;
+      const uint16_t nbyte = _MIN(fileSize_ - curPosition_, uint32_t(512));
+      if (!nbyte) return 0;
+
+      uint32_t block;
+      if (nextBlock(block)) {
+        const int8_t status = vol_->readBlockStart(block, dst);
+        if (status >= 0) {
+          busy = !status;
+          curPosition_ = startPosition + nbyte;
+          return nbyte;
+        }
+      }
+      seekSet(startPosition);
+      return -1;
+    }
+
+  #endif
+
+#endif // SD_READ_AHEAD
+
 /**
  * Read the next entry in a directory.
  *
@@ -1434,6 +1577,71 @@ bool SdBaseFile::seekSet(const uint32_t pos) {
   return true;
 }
 
+#if ENABLED(SD_FAST_SEEK)
+
+  /**
+   * Map the cluster chain of a file as a list of extents, the runs of
+   * consecutive clusters. A contiguous file has a single extent.
+   *
+   * \param[out] ext Array to receive the extents.
+   *
+   * \param[in] max Size of the array.
+   *
+   * \return The number of extents, or zero if the file is empty, it has
+   * more than \a max extents, the chain is shorter than the file size,
+   * or an I/O error occurred.
+   */
+  uint8_t SdBaseFile::mapExtents(fat_extent_t* ext, const uint8_t max) {
+    if (!isFile() || firstCluster_ == 0 || max == 0) return 0;
+
+    uint8_t count = 1;
+    uint32_t index = 0, c = firstCluster_;
+    ext[0].index = 0;
+    ext[0].cluster = c;
+    for (;;) {
+      uint32_t next;
+      if (!vol_->fatGet(c, &next)) return 0;
+      if (vol_->isEOC(next)) break;
+      index++;
+      if (next != c + 1) {
+        if (count >= max) return 0;
+        ext[count].index = index;
+        ext[count].cluster = next;
+        count++;
+      }
+      c = next;
+    }
+
+    // the chain must cover the whole file
+    if (fileSize_ && ((fileSize_ - 1) >> (vol_->clusterSizeShift_ + 9)) > index) return 0;
+
+    return count;
+  }
+
+  /**
+   * Set the file position using extents from mapExtents(),
+   * without reading the FAT. See seekSet().
+   */
+  bool SdBaseFile::seekExtents(const uint32_t pos, const fat_extent_t* ext, const uint8_t count) {
+    if (!isOpen() || pos > fileSize_ || count == 0) return false;
+
+    if (pos == 0) {
+      curCluster_ = curPosition_ = 0;   // set position to start of file
+      return true;
+    }
+
+    // cluster index of the last byte before pos, as in seekSet()
+    const uint32_t n = (pos - 1) >> (vol_->clusterSizeShift_ + 9);
+    uint8_t e = count - 1;
+    while (ext[e].index > n) e--;       // ext[0].index is 0
+
+    curCluster_ = ext[e].cluster + (n - ext[e].index);
+    curPosition_ = pos;
+    return true;
+  }
+
+#endif // SD_FAST_SEEK
+
 void SdBaseFile::setpos(filepos_t* pos) {
   curPosition_ = pos->position;
   curCluster_ = pos->cluster;
@@ -1471,7 +1679,7 @@ bool SdBaseFile::sync() {
     // clear directory dirty
     flags_ &= ~F_FILE_DIR_DIRTY;
   }
-  return vol_->cacheFlush();
+  return vol_->cacheFlush() && vol_->streamStop();
 
   FAIL:
   writeError = true;
@@ -1722,10 +1930,17 @@ int16_t SdBaseFile::write(const void* buf, uint16_t nbyte) {
         // invalidate cache if block is in cache
         vol_->cacheSetBlockNumber(0xFFFFFFFF, false);
       }
+      #if ENABLED(SD_WRITE_STREAM)
+        if (curPosition_ >= fileSize_) hintAppend(block);
+      #endif
       if (!vol_->writeBlock(block, src)) goto FAIL;
     }
     else {
       if (blockOffset == 0 && curPosition_ >= fileSize_) {
+        #if ENABLED(SD_WRITE_STREAM)
+          // The block before, still in the cache, is written out now
+          if (vol_->cacheBlockNumber() == block - 1) hintAppend(block - 1);
+        #endif
         // start of new block don't need to read into cache
         if (!vol_->cacheFlush()) goto FAIL;
         // set cache dirty and SD address of block
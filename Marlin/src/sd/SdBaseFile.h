@@ -49,6 +49,15 @@ struct filepos_t {
   filepos_t() : position(0), cluster(0) {}
 };
 
+/**
+ * \struct fat_extent_t
+ * \brief A run of consecutive clusters in a file
+ */
+struct fat_extent_t {
+  uint32_t index;     // index of the first cluster in the file
+  uint32_t cluster;   // its cluster number on the volume
+};
+
 // use the gnu style oflag in open()
 uint8_t const O_READ = 0x01,                    // open() oflag for reading
               O_RDONLY = O_READ,                // open() oflag - same as O_IN
@@ -301,6 +310,13 @@ class SdBaseFile {
   bool printName();
   int16_t read();
   int16_t read(void* buf, uint16_t nbyte);
+  #if ENABLED(SD_READ_AHEAD)
+    int16_t readBlocks(uint8_t* dst, const uint8_t count);
+  #endif
+  #if ENABLED(SD_ASYNC_READ)
+    int16_t readBlockStart(uint8_t* dst, bool &busy);
+    int8_t readBlockDone() { return vol_->readBlockDone(); }  // 0 while busy, 1 done, -1 failed
+  #endif
   int8_t readDir(dir_t* dir, char* longFilename);
   static bool remove(SdBaseFile* dirFile, const char* path);
   bool remove();
@@ -327,6 +343,10 @@ class SdBaseFile {
    */
   bool seekEnd(const int32_t offset = 0) { return seekSet(fileSize_ + offset); }
   bool seekSet(const uint32_t pos);
+  #if ENABLED(SD_FAST_SEEK)
+    uint8_t mapExtents(fat_extent_t* ext, const uint8_t max);
+    bool seekExtents(const uint32_t pos, const fat_extent_t* ext, const uint8_t count);
+  #endif
   bool sync();
   bool timestamp(SdBaseFile* file);
   bool timestamp(uint8_t flag, uint16_t year, uint8_t month, uint8_t day,
@@ -355,6 +375,7 @@ class SdBaseFile {
 
   // bits defined in flags_
   static uint8_t const F_OFLAG = (O_ACCMODE | O_APPEND | O_SYNC),   // should be 0x0F
+                       F_FILE_PREALLOC = 0x40,                      // clusters allocated past the data
                        F_FILE_DIR_DIRTY = 0x80;                     // sync of directory entry required
 
   // private data
@@ -368,6 +389,9 @@ class SdBaseFile {
   uint32_t  fileSize_;      // file size in bytes
   uint32_t  firstCluster_;  // first cluster of file
   SdVolume* vol_;           // volume where file is located
+  #if ENABLED(SD_WRITE_STREAM)
+    uint32_t preallocEnd_;  // block after the clusters allocated by the last addCluster()
+  #endif
 
   /**
    * EXPERIMENTAL - Don't use!
@@ -377,6 +401,13 @@ class SdBaseFile {
   // private functions
   bool addCluster();
   bool addDirCluster();
+  #if ENABLED(SD_WRITE_STREAM)
+    bool freePreallocated();
+    void hintAppend(const uint32_t block);
+  #endif
+  #if ENABLED(SD_READ_AHEAD)
+    bool nextBlock(uint32_t &block);
+  #endif
   dir_t* cacheDirEntry(uint8_t action);
   int8_t lsPrintNext(uint8_t flags, uint8_t indent);
   static bool make83Name(const char* str, uint8_t* name, const char** ptr);
@@ -37,11 +37,19 @@
 
 #if !USE_MULTIPLE_CARDS
   // raw block cache
-  uint32_t SdVolume::cacheBlockNumber_;  // current block number
-  cache_t  SdVolume::cacheBuffer_;       // 512 byte cache for Sd2Card
-  Sd2Card* SdVolume::sdCard_;            // pointer to SD card object
-  bool     SdVolume::cacheDirty_;        // cacheFlush() will write block if true
-  uint32_t SdVolume::cacheMirrorBlock_;  // mirror  block for second FAT
+  uint32_t SdVolume::cacheBlockNumber_[SD_CACHE_BLOCKS];  // block number in each entry
+  cache_t  SdVolume::cacheBuffer_[SD_CACHE_BLOCKS];       // 512 byte cache for Sd2Card
+  Sd2Card* SdVolume::sdCard_;                             // pointer to SD card object
+  bool     SdVolume::cacheDirty_[SD_CACHE_BLOCKS];        // cacheFlush() will write block if true
+  uint32_t SdVolume::cacheMirrorBlock_[SD_CACHE_BLOCKS];  // mirror  block for second FAT
+  uint8_t  SdVolume::cacheLru_[SD_CACHE_BLOCKS];          // entries, most recently used first
+  uint8_t  SdVolume::cacheIndex_;                         // current entry
+  #if ENABLED(SD_WRITE_STREAM)
+    uint32_t SdVolume::streamNext_,                       // next block of an open multi-block write
+             SdVolume::streamLast_,                       // last block written
+             SdVolume::streamFree_,                       // free blocks a new stream may pre-erase
+             SdVolume::streamFreeCount_;
+  #endif
 #endif  // USE_MULTIPLE_CARDS
 
 // find a contiguous group of clusters
@@ -118,34 +126,196 @@ bool SdVolume::allocContiguous(uint32_t count, uint32_t* curCluster) {
   return true;
 }
 
-bool SdVolume::cacheFlush() {
+// empty the cache
+void SdVolume::cacheInit() {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    cacheBlockNumber_[i] = 0xFFFFFFFF;
+    cacheDirty_[i] = false;
+    cacheMirrorBlock_[i] = 0;
+    cacheLru_[i] = i;
+  }
+  cacheIndex_ = 0;
+}
+
+// return the entry holding a block, or -1
+int8_t SdVolume::cacheFind(const uint32_t blockNumber) {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++)
+    if (cacheBlockNumber_[i] == blockNumber) return i;
+  return -1;
+}
+
+// make an entry current and most recently used
+void SdVolume::cacheUse(const uint8_t i) {
+  cacheIndex_ = i;
+  #if SD_CACHE_BLOCKS > 1
+    uint8_t n = 0;
+    while (cacheLru_[n] != i) n++;
+    for (; n; n--) cacheLru_[n] = cacheLru_[n - 1];
+    cacheLru_[0] = i;
+  #endif
+}
+
+// write an entry to the card if it's dirty
+bool SdVolume::cacheWrite(const uint8_t i) {
   #if DISABLED(SDCARD_READONLY)
-    if (cacheDirty_) {
-      if (!sdCard_->writeBlock(cacheBlockNumber_, cacheBuffer_.data))
+    if (cacheDirty_[i]) {
+      if (!cardWrite(cacheBlockNumber_[i], cacheBuffer_[i].data))
         return false;
 
       // mirror FAT tables
-      if (cacheMirrorBlock_) {
-        if (!sdCard_->writeBlock(cacheMirrorBlock_, cacheBuffer_.data))
+      if (cacheMirrorBlock_[i]) {
+        if (!cardWrite(cacheMirrorBlock_[i], cacheBuffer_[i].data))
           return false;
-        cacheMirrorBlock_ = 0;
+        cacheMirrorBlock_[i] = 0;
       }
-      cacheDirty_ = 0;
+      cacheDirty_[i] = false;
     }
+  #else
+    UNUSED(i);
   #endif
   return true;
 }
 
+// forget a cached block without writing it
+void SdVolume::cacheInvalidate(const uint32_t blockNumber) {
+  const int8_t i = cacheFind(blockNumber);
+  if (i >= 0) {
+    cacheBlockNumber_[i] = 0xFFFFFFFF;
+    cacheDirty_[i] = false;
+    cacheMirrorBlock_[i] = 0;
+  }
+}
+
+// write all dirty blocks to the card
+bool SdVolume::cacheFlush() {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++)
+    if (!cacheWrite(i)) return false;
+  return true;
+}
+
 bool SdVolume::cacheRawBlock(uint32_t blockNumber, bool dirty) {
-  if (cacheBlockNumber_ != blockNumber) {
-    if (!cacheFlush()) return false;
-    if (!sdCard_->readBlock(blockNumber, cacheBuffer_.data)) return false;
-    cacheBlockNumber_ = blockNumber;
+  int8_t i = cacheFind(blockNumber);
+  if (i < 0) {
+    i = cacheLru_[SD_CACHE_BLOCKS - 1];   // Reuse the least recently used entry
+    if (!cacheWrite(i)) return false;
+    cacheBlockNumber_[i] = 0xFFFFFFFF;
+    if (!streamStop() || !sdCard_->readBlock(blockNumber, cacheBuffer_[i].data)) return false;
+    cacheBlockNumber_[i] = blockNumber;
   }
-  if (dirty) cacheDirty_ = true;
+  cacheUse(i);
+  if (dirty) cacheDirty_[i] = true;
+  return true;
+}
+
+// read a block for a file, from the cache if it's there
+bool SdVolume::readBlock(uint32_t block, uint8_t* dst) {
+  const int8_t i = cacheFind(block);
+  if (i < 0) return streamStop() && sdCard_->readBlock(block, dst);
+  memcpy(dst, cacheBuffer_[i].data, 512);
   return true;
 }
 
+#if ENABLED(SD_READ_AHEAD)
+
+  /**
+   * Read consecutive blocks, with a multi-block read where the card supports it.
+   * A dirty cached block in the range is written first, so the data is current.
+   */
+  bool SdVolume::readBlocks(uint32_t block, uint8_t* dst, const uint8_t count) {
+    for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++)
+      if (WITHIN(cacheBlockNumber_[i], block, block + count - 1) && !cacheWrite(i)) return false;
+
+    if (!streamStop()) return false;
+
+    #if ENABLED(SDIO_SUPPORT) || IS_TEENSY_35_36 || IS_TEENSY_40_41
+      // No CMD18 through these drivers
+      for (uint8_t i = 0; i < count; ++i, dst += 512)
+        if (!sdCard_->readBlock(block + i, dst)) return false;
+      return true;
+    #else
+      if (count == 1) return sdCard_->readBlock(block, dst);
+      if (!sdCard_->readStart(block)) return false;
+      for (uint8_t i = 0; i < count; ++i, dst += 512)
+        if (!sdCard_->readData(dst)) { sdCard_->readStop(); return false; }
+      return sdCard_->readStop();
+    #endif
+  }
+
+  #if ENABLED(SD_ASYNC_READ)
+
+    /**
+     * Start reading a block in the background. A cached block is copied
+     * instead. 1 if the data is in already, 0 if the read was started
+     * (poll readBlockDone), or -1 on error.
+     */
+    int8_t SdVolume::readBlockStart(uint32_t block, uint8_t* dst) {
+      const int8_t i = cacheFind(block);
+      if (i >= 0) {
+        memcpy(dst, cacheBuffer_[i].data, 512);
+        return 1;
+      }
+      return (streamStop() && sdCard_->readBlockStart(block, dst)) ? 0 : -1;
+    }
+
+  #endif
+
+#endif
+
+#if ENABLED(SD_WRITE_STREAM)
+
+  /**
+   * Write a block to the card. A block that follows the last one written
+   * starts a multi-block write, and later blocks in sequence are added to it.
+   * The card can then program each block while the next one is being sent.
+   * A stream that starts in the free blocks hinted by the file being appended
+   * to pre-erases the rest of them. Any other stream pre-erases only itself.
+   */
+  bool SdVolume::cardWrite(const uint32_t block, const uint8_t* src) {
+    if (streamNext_) {
+      if (block == streamNext_) {
+        if (sdCard_->writeData(src)) {
+          streamLast_ = streamNext_++;
+          return true;
+        }
+        streamNext_ = 0;
+        sdCard_->writeStop();
+        return false;
+      }
+      streamNext_ = 0;                        // The hint stays for the next stream
+      if (!sdCard_->writeStop()) return false;
+    }
+
+    bool ok;
+    #if ENABLED(SDIO_SUPPORT) || IS_TEENSY_35_36 || IS_TEENSY_40_41
+      ok = sdCard_->writeBlock(block, src);   // No CMD25 through these drivers
+    #else
+      const uint32_t into = block - streamFree_,
+                     erase = into < streamFreeCount_ ? streamFreeCount_ - into : 1;
+      if (block == streamLast_ + 1 && sdCard_->writeStart(block, erase)) {
+        ok = sdCard_->writeData(src);
+        if (ok)
+          streamNext_ = block + 1;
+        else
+          sdCard_->writeStop();
+      }
+      else
+        ok = sdCard_->writeBlock(block, src);
+    #endif
+
+    streamLast_ = ok ? block : 0;
+    return ok;
+  }
+
+  // End the multi-block write, if one is open, and drop the hint
+  bool SdVolume::streamStop() {
+    streamFree_ = streamFreeCount_ = 0;
+    if (!streamNext_) return true;
+    streamNext_ = 0;
+    return sdCard_->writeStop();
+  }
+
+#endif // SD_WRITE_STREAM
+
 // return the size in bytes of a cluster chain
 bool SdVolume::chainSize(uint32_t cluster, uint32_t* size) {
   uint32_t s = 0;
@@ -167,13 +337,13 @@ bool SdVolume::fatGet(uint32_t cluster, uint32_t* value) {
     lba = fatStartBlock_ + (index >> 9);
     if (!cacheRawBlock(lba, CACHE_FOR_READ)) return false;
     index &= 0x1FF;
-    uint16_t tmp = cacheBuffer_.data[index];
+    uint16_t tmp = cache()->data[index];
     index++;
     if (index == 512) {
       if (!cacheRawBlock(lba + 1, CACHE_FOR_READ)) return false;
       index = 0;
     }
-    tmp |= cacheBuffer_.data[index] << 8;
+    tmp |= cache()->data[index] << 8;
     *value = cluster & 1 ? tmp >> 4 : tmp & 0xFFF;
     return true;
   }
@@ -185,10 +355,10 @@ bool SdVolume::fatGet(uint32_t cluster, uint32_t* value) {
   else
     return false;
 
-  if (lba != cacheBlockNumber_ && !cacheRawBlock(lba, CACHE_FOR_READ))
+  if (lba != cacheBlockNumber() && !cacheRawBlock(lba, CACHE_FOR_READ))
     return false;
 
-  *value = (fatType_ == 16) ? cacheBuffer_.fat16[cluster & 0xFF] : (cacheBuffer_.fat32[cluster & 0x7F] & FAT32MASK);
+  *value = (fatType_ == 16) ? cache()->fat16[cluster & 0xFF] : (cache()->fat32[cluster & 0x7F] & FAT32MASK);
   return true;
 }
 
@@ -209,26 +379,26 @@ bool SdVolume::fatPut(uint32_t cluster, uint32_t value) {
     lba = fatStartBlock_ + (index >> 9);
     if (!cacheRawBlock(lba, CACHE_FOR_WRITE)) return false;
     // mirror second FAT
-    if (fatCount_ > 1) cacheMirrorBlock_ = lba + blocksPerFat_;
+    if (fatCount_ > 1) cacheMirrorBlock_[cacheIndex_] = lba + blocksPerFat_;
     index &= 0x1FF;
     uint8_t tmp = value;
     if (cluster & 1) {
-      tmp = (cacheBuffer_.data[index] & 0xF) | tmp << 4;
+      tmp = (cache()->data[index] & 0xF) | tmp << 4;
     }
-    cacheBuffer_.data[index] = tmp;
+    cache()->data[index] = tmp;
     index++;
     if (index == 512) {
       lba++;
       index = 0;
       if (!cacheRawBlock(lba, CACHE_FOR_WRITE)) return false;
       // mirror second FAT
-      if (fatCount_ > 1) cacheMirrorBlock_ = lba + blocksPerFat_;
+      if (fatCount_ > 1) cacheMirrorBlock_[cacheIndex_] = lba + blocksPerFat_;
     }
     tmp = value >> 4;
     if (!(cluster & 1)) {
-      tmp = ((cacheBuffer_.data[index] & 0xF0)) | tmp >> 4;
+      tmp = ((cache()->data[index] & 0xF0)) | tmp >> 4;
     }
-    cacheBuffer_.data[index] = tmp;
+    cache()->data[index] = tmp;
     return true;
   }
 
@@ -243,12 +413,12 @@ bool SdVolume::fatPut(uint32_t cluster, uint32_t value) {
 
   // store entry
   if (fatType_ == 16)
-    cacheBuffer_.fat16[cluster & 0xFF] = value;
+    cache()->fat16[cluster & 0xFF] = value;
   else
-    cacheBuffer_.fat32[cluster & 0x7F] = value;
+    cache()->fat32[cluster & 0x7F] = value;
 
   // mirror second FAT
-  if (fatCount_ > 1) cacheMirrorBlock_ = lba + blocksPerFat_;
+  if (fatCount_ > 1) cacheMirrorBlock_[cacheIndex_] = lba + blocksPerFat_;
   return true;
 }
 
@@ -291,11 +461,11 @@ int32_t SdVolume::freeClusterCount() {
     NOMORE(n, todo);
     if (fatType_ == 16) {
       for (uint16_t i = 0; i < n; i++)
-        if (cacheBuffer_.fat16[i] == 0) free++;
+        if (cache()->fat16[i] == 0) free++;
     }
     else {
       for (uint16_t i = 0; i < n; i++)
-        if (cacheBuffer_.fat32[i] == 0) free++;
+        if (cache()->fat32[i] == 0) free++;
     }
     #ifdef ESP32
       // Needed to reset the idle task watchdog timer on ESP32 as reading the complete FAT may easily
@@ -331,22 +501,24 @@ bool SdVolume::init(Sd2Card* dev, uint8_t part) {
   sdCard_ = dev;
   fatType_ = 0;
   allocSearchStart_ = 2;
-  cacheDirty_ = 0;  // cacheFlush() will write block if true
-  cacheMirrorBlock_ = 0;
-  cacheBlockNumber_ = 0xFFFFFFFF;
+  cacheInit();
+  #if ENABLED(SD_WRITE_STREAM)
+    streamNext_ = streamLast_ = 0;
+    streamFree_ = streamFreeCount_ = 0;
+  #endif
 
   // if part == 0 assume super floppy with FAT boot sector in block zero
   // if part > 0 assume mbr volume with partition table
   if (part) {
     if (part > 4) return false;
     if (!cacheRawBlock(volumeStartBlock, CACHE_FOR_READ)) return false;
-    part_t* p = &cacheBuffer_.mbr.part[part - 1];
+    part_t* p = &cache()->mbr.part[part - 1];
     if ((p->boot & 0x7F) != 0  || p->totalSectors < 100 || p->firstSector == 0)
       return false; // not a valid partition
     volumeStartBlock = p->firstSector;
   }
   if (!cacheRawBlock(volumeStartBlock, CACHE_FOR_READ)) return false;
-  fbs = &cacheBuffer_.fbs32;
+  fbs = &cache()->fbs32;
   if (fbs->bytesPerSector != 512 ||
       fbs->fatCount == 0 ||
       fbs->reservedSectorCount == 0 ||
@@ -48,6 +48,10 @@
 #include "SdFatConfig.h"
 #include "SdFatStructs.h"
 
+#ifndef SD_CACHE_BLOCKS
+  #define SD_CACHE_BLOCKS 1
+#endif
+
 //==============================================================================
 // SdVolume class
 /**
@@ -79,8 +83,8 @@ class SdVolume {
    */
   cache_t* cacheClear() {
     if (!cacheFlush()) return 0;
-    cacheBlockNumber_ = 0xFFFFFFFF;
-    return &cacheBuffer_;
+    cacheBlockNumber_[cacheIndex_] = 0xFFFFFFFF;
+    return cache();
   }
 
   /**
@@ -138,18 +142,39 @@ class SdVolume {
   // value for dirty argument in cacheRawBlock to indicate write to cache
   static bool const CACHE_FOR_WRITE = true;
 
+  // The cache holds SD_CACHE_BLOCKS blocks. The most recently used one is
+  // the "current" block for cache(), cacheBlockNumber(), and cacheSetDirty().
+  // When a block is needed that isn't cached, the least recently used
+  // entry is written back (if dirty) and reused.
   #if USE_MULTIPLE_CARDS
-    cache_t cacheBuffer_;        // 512 byte cache for device blocks
-    uint32_t cacheBlockNumber_;  // Logical number of block in the cache
-    Sd2Card* sdCard_;            // Sd2Card object for cache
-    bool cacheDirty_;            // cacheFlush() will write block if true
-    uint32_t cacheMirrorBlock_;  // block number for mirror FAT
+    cache_t cacheBuffer_[SD_CACHE_BLOCKS];        // 512 byte cache for device blocks
+    uint32_t cacheBlockNumber_[SD_CACHE_BLOCKS];  // Logical number of block in each entry
+    Sd2Card* sdCard_;                             // Sd2Card object for cache
+    bool cacheDirty_[SD_CACHE_BLOCKS];            // cacheFlush() will write block if true
+    uint32_t cacheMirrorBlock_[SD_CACHE_BLOCKS];  // block number for mirror FAT
+    uint8_t cacheLru_[SD_CACHE_BLOCKS];           // Entries, most recently used first
+    uint8_t cacheIndex_;                          // The current entry
   #else
-    static cache_t cacheBuffer_;        // 512 byte cache for device blocks
-    static uint32_t cacheBlockNumber_;  // Logical number of block in the cache
-    static Sd2Card* sdCard_;            // Sd2Card object for cache
-    static bool cacheDirty_;            // cacheFlush() will write block if true
-    static uint32_t cacheMirrorBlock_;  // block number for mirror FAT
+    static cache_t cacheBuffer_[SD_CACHE_BLOCKS];        // 512 byte cache for device blocks
+    static uint32_t cacheBlockNumber_[SD_CACHE_BLOCKS];  // Logical number of block in each entry
+    static Sd2Card* sdCard_;                             // Sd2Card object for cache
+    static bool cacheDirty_[SD_CACHE_BLOCKS];            // cacheFlush() will write block if true
+    static uint32_t cacheMirrorBlock_[SD_CACHE_BLOCKS];  // block number for mirror FAT
+    static uint8_t cacheLru_[SD_CACHE_BLOCKS];           // Entries, most recently used first
+    static uint8_t cacheIndex_;                          // The current entry
+  #endif
+
+  // Sequential block writes are sent as one multi-block write (CMD25),
+  // which is left open until a write elsewhere or any other card access.
+  #if ENABLED(SD_WRITE_STREAM)
+    #if USE_MULTIPLE_CARDS
+      uint32_t streamNext_;     // Next block of the open multi-block write, or 0
+      uint32_t streamLast_;     // Last block written, to spot a sequential writer
+      uint32_t streamFree_;     // First of the free blocks a new stream may pre-erase (ACMD23)
+      uint32_t streamFreeCount_;
+    #else
+      static uint32_t streamNext_, streamLast_, streamFree_, streamFreeCount_;
+    #endif
   #endif
 
   uint32_t allocSearchStart_;   // start cluster for alloc search
@@ -169,23 +194,53 @@ class SdVolume {
   uint32_t clusterStartBlock(uint32_t cluster) const { return dataStartBlock_ + ((cluster - 2) << clusterSizeShift_); }
   uint32_t blockNumber(uint32_t cluster, uint32_t position) const { return clusterStartBlock(cluster) + blockOfCluster(position); }
 
-  cache_t* cache() { return &cacheBuffer_; }
-  uint32_t cacheBlockNumber() const { return cacheBlockNumber_; }
+  cache_t* cache() { return &cacheBuffer_[cacheIndex_]; }
+  uint32_t cacheBlockNumber() const { return cacheBlockNumber_[cacheIndex_]; }
 
   #if USE_MULTIPLE_CARDS
     bool cacheFlush();
     bool cacheRawBlock(uint32_t blockNumber, bool dirty);
+    void cacheInit();
+    int8_t cacheFind(const uint32_t blockNumber);
+    void cacheUse(const uint8_t i);
+    bool cacheWrite(const uint8_t i);
+    void cacheInvalidate(const uint32_t blockNumber);
   #else
     static bool cacheFlush();
     static bool cacheRawBlock(uint32_t blockNumber, bool dirty);
+    static void cacheInit();
+    static int8_t cacheFind(const uint32_t blockNumber);
+    static void cacheUse(const uint8_t i);
+    static bool cacheWrite(const uint8_t i);
+    static void cacheInvalidate(const uint32_t blockNumber);
+  #endif
+
+  #if ENABLED(SD_WRITE_STREAM)
+    #if USE_MULTIPLE_CARDS
+      bool cardWrite(const uint32_t block, const uint8_t* src);
+      bool streamStop();
+    #else
+      static bool cardWrite(const uint32_t block, const uint8_t* src);
+      static bool streamStop();
+    #endif
+    // Blocks with no data yet, written next by the file being appended to.
+    // A stream that starts in them pre-erases the rest. Cleared by streamStop().
+    void streamHint(const uint32_t block, const uint32_t count) { streamFree_ = block; streamFreeCount_ = count; }
+  #elif USE_MULTIPLE_CARDS
+    bool cardWrite(const uint32_t block, const uint8_t* src) { return sdCard_->writeBlock(block, src); }
+    bool streamStop() { return true; }
+  #else
+    static bool cardWrite(const uint32_t block, const uint8_t* src) { return sdCard_->writeBlock(block, src); }
+    static bool streamStop() { return true; }
   #endif
 
   // used by SdBaseFile write to assign cache to SD location
   void cacheSetBlockNumber(uint32_t blockNumber, bool dirty) {
-    cacheDirty_ = dirty;
-    cacheBlockNumber_  = blockNumber;
+    cacheInvalidate(blockNumber);   // Drop any other copy
+    cacheDirty_[cacheIndex_] = dirty;
+    cacheBlockNumber_[cacheIndex_] = blockNumber;
   }
-  void cacheSetDirty() { cacheDirty_ |= CACHE_FOR_WRITE; }
+  void cacheSetDirty() { cacheDirty_[cacheIndex_] |= CACHE_FOR_WRITE; }
   bool chainSize(uint32_t beginCluster, uint32_t* size);
   bool fatGet(uint32_t cluster, uint32_t* value);
   bool fatPut(uint32_t cluster, uint32_t value);
@@ -196,6 +251,16 @@ class SdVolume {
     if (fatType_ == 16) return cluster >= FAT16EOC_MIN;
     return  cluster >= FAT32EOC_MIN;
   }
-  bool readBlock(uint32_t block, uint8_t* dst) { return sdCard_->readBlock(block, dst); }
-  bool writeBlock(uint32_t block, const uint8_t* dst) { return sdCard_->writeBlock(block, dst); }
+  bool readBlock(uint32_t block, uint8_t* dst);
+  #if ENABLED(SD_READ_AHEAD)
+    bool readBlocks(uint32_t block, uint8_t* dst, const uint8_t count);
+  #endif
+  #if ENABLED(SD_ASYNC_READ)
+    int8_t readBlockStart(uint32_t block, uint8_t* dst);
+    int8_t readBlockDone() { return sdCard_->readBlockDone(); }
+  #endif
+  bool writeBlock(uint32_t block, const uint8_t* dst) {
+    cacheInvalidate(block);         // The card has newer data
+    return cardWrite(block, dst);
+  }
 };
@@ -124,6 +124,31 @@ char CardReader::proc_filenames[SD_PROCEDURE_DEPTH][MAXPATHNAMELENGTH];
 
 uint32_t CardReader::filesize, CardReader::sdpos;
 
+#if ENABLED(SD_READ_AHEAD)
+  uint8_t CardReader::ahead_buf[SD_READ_AHEAD_BLOCKS][512];
+  uint16_t CardReader::ahead_len[SD_READ_AHEAD_BLOCKS];
+  uint8_t CardReader::ahead_head, CardReader::ahead_count;
+  const uint8_t *CardReader::ahead_ptr, *CardReader::ahead_end;
+  uint32_t CardReader::ahead_next;
+  uint16_t CardReader::ahead_skip;
+#endif
+
+#if ENABLED(SD_ASYNC_READ)
+  bool CardReader::ahead_busy;
+  uint16_t CardReader::ahead_busy_len;
+  uint32_t CardReader::ahead_busy_pos, CardReader::ahead_busy_us;
+  sd_read_stats_t CardReader::read_stats;
+#endif
+
+#if ENABLED(SD_WRITE_STREAM)
+  millis_t CardReader::write_start_ms;
+#endif
+
+#if ENABLED(SD_FAST_SEEK)
+  fat_extent_t CardReader::extent[SD_SEEK_EXTENTS];
+  uint8_t CardReader::extent_count;
+#endif
+
 CardReader::CardReader() {
   #if ENABLED(SDCARD_SORT_ALPHA)
     sort_count = 0;
@@ -373,6 +398,8 @@ void CardReader::printFilename() {
 
 void CardReader::mount() {
   flag.mounted = false;
+  TERN_(SD_DIR_INDEX, dir_index.reset());
+  TERN_(SD_GCODE_INDEX, gcode_index.reset());
   if (root.isOpen()) root.close();
 
   if (!sd2card.init(SPI_SPEED, SDSS)
@@ -452,6 +479,8 @@ void CardReader::manage_media() {
 
 void CardReader::release() {
   endFilePrint();
+  TERN_(SD_DIR_INDEX, dir_index.reset());
+  TERN_(SD_GCODE_INDEX, gcode_index.reset());
   flag.mounted = false;
   flag.workDirIsRoot = true;
   #if ALL(SDCARD_SORT_ALPHA, SDSORT_USES_RAM, SDSORT_CACHE_NAMES)
@@ -479,7 +508,9 @@ void CardReader::endFilePrint(TERN_(SD_RESORT, const bool re_sort/*=false*/)) {
   TERN_(ADVANCED_PAUSE_FEATURE, did_pause_print = 0);
   TERN_(HAS_DWIN_LCD, HMI_flag.print_finish = flag.sdprinting);
   flag.sdprinting = flag.abort_sd_printing = false;
+  TERN_(SD_GCODE_INDEX, gcode_index.close());
   if (isFileOpen()) file.close();
+  TERN_(SD_FAST_SEEK, extent_count = 0);
   TERN_(SD_RESORT, if (re_sort) presort());
 }
 
@@ -579,6 +610,10 @@ void CardReader::openFileRead(char * const path, const uint8_t subcall_type/*=0*
   if (file.open(diveDir, fname, O_READ)) {
     filesize = file.fileSize();
     sdpos = 0;
+    TERN_(SD_READ_AHEAD, ahead_reset(0));
+    TERN_(SD_ASYNC_READ, read_stats = sd_read_stats_t());
+    TERN_(SD_FAST_SEEK, extent_count = file.mapExtents(extent, SD_SEEK_EXTENTS));
+    TERN_(SD_GCODE_INDEX, if (!file_subcall_ctr) gcode_index.open()); // Not for procedures
 
     PORT_REDIRECT(SERIAL_BOTH);
     SERIAL_ECHOLNPAIR(STR_SD_FILE_OPENED, fname, STR_SD_SIZE, filesize);
@@ -616,6 +651,8 @@ void CardReader::openFileWrite(char * const path) {
   #else
     if (file.open(diveDir, fname, O_CREAT | O_APPEND | O_WRITE | O_TRUNC)) {
       flag.saving = true;
+      TERN_(SD_WRITE_STREAM, write_start_ms = millis());
+      TERN_(SD_DIR_INDEX, dir_index.invalidate());
       selectFileByName(fname);
       TERN_(EMERGENCY_PARSER, emergency_parser.disable());
       echo_write_to_file(fname);
@@ -660,6 +697,7 @@ void CardReader::removeFile(const char * const name) {
     if (file.remove(curDir, fname)) {
       SERIAL_ECHOLNPAIR("File deleted:", fname);
       sdpos = 0;
+      TERN_(SD_DIR_INDEX, dir_index.invalidate());
       TERN_(SDCARD_SORT_ALPHA, presort());
     }
     else
@@ -734,8 +772,16 @@ void CardReader::beginautostart() {
 }
 
 void CardReader::closefile(const bool store_location/*=false*/) {
+  #if ENABLED(SD_WRITE_STREAM)
+    if (flag.saving && !flag.logging && TERN1(BINARY_FILE_TRANSFER, !flag.binary_mode)) {
+      const millis_t ms = _MAX(millis() - write_start_ms, 1UL);
+      SERIAL_ECHOLNPAIR("Wrote ", file.fileSize(), " bytes in ", ms, "ms, ", file.fileSize() / ms, " KB/s");
+    }
+  #endif
   file.sync();
   file.close();
+  TERN_(SD_FAST_SEEK, extent_count = 0);  // The map belongs to the closed file
+  TERN_(SD_DIR_INDEX, if (flag.saving) dir_index.invalidate()); // The size and date changed
   flag.saving = flag.logging = false;
   sdpos = 0;
   TERN_(EMERGENCY_PARSER, emergency_parser.enable());
@@ -758,6 +804,9 @@ void CardReader::selectFileByIndex(const uint16_t nr) {
       return;
     }
   #endif
+  #if ENABLED(SD_DIR_INDEX)
+    if (dir_index.ready() && dir_index.get(nr, false)) return;
+  #endif
   workDir.rewind();
   selectByIndex(workDir, nr);
 }
@@ -775,11 +824,17 @@ void CardReader::selectFileByName(const char * const match) {
         return;
       }
   #endif
+  #if ENABLED(SD_DIR_INDEX)
+    if (dir_index.ready() && dir_index.find(match)) return;
+  #endif
   workDir.rewind();
   selectByName(workDir, match);
 }
 
 uint16_t CardReader::countFilesInWorkDir() {
+  #if ENABLED(SD_DIR_INDEX)
+    if (dir_index.ready()) return dir_index.count();
+  #endif
   workDir.rewind();
   return countItems(workDir);
 }
@@ -872,6 +927,7 @@ const char* CardReader::diveToFile(const bool update_cwd, SdFile*& diveDir, cons
     workDir = *diveDir;
     DEBUG_ECHOLNPAIR("diveToFile: final workDir = ", hex_address((void*)diveDir));
     flag.workDirIsRoot = (workDirDepth == 0);
+    TERN_(SD_DIR_INDEX, dir_index.changed_dir());
     TERN_(SDCARD_SORT_ALPHA, presort());
   }
 
@@ -887,6 +943,7 @@ void CardReader::cd(const char * relpath) {
     flag.workDirIsRoot = false;
     if (workDirDepth < MAX_DIR_DEPTH)
       workDirParents[workDirDepth++] = workDir;
+    TERN_(SD_DIR_INDEX, dir_index.changed_dir());
     TERN_(SDCARD_SORT_ALPHA, presort());
   }
   else {
@@ -898,6 +955,7 @@ void CardReader::cd(const char * relpath) {
 int8_t CardReader::cdup() {
   if (workDirDepth > 0) {                                               // At least 1 dir has been saved
     workDir = --workDirDepth ? workDirParents[workDirDepth - 1] : root; // Use parent, or root if none
+    TERN_(SD_DIR_INDEX, dir_index.changed_dir());
     TERN_(SDCARD_SORT_ALPHA, presort());
   }
   if (!workDirDepth) flag.workDirIsRoot = true;
@@ -907,6 +965,7 @@ int8_t CardReader::cdup() {
 void CardReader::cdroot() {
   workDir = root;
   flag.workDirIsRoot = true;
+  TERN_(SD_DIR_INDEX, dir_index.changed_dir());
   TERN_(SDCARD_SORT_ALPHA, presort());
 }
 
@@ -916,6 +975,9 @@ void CardReader::cdroot() {
    * Get the name of a file in the working directory by sort-index
    */
   void CardReader::getfilename_sorted(const uint16_t nr) {
+    #if ENABLED(SD_DIR_INDEX)
+      if (dir_index.ready() && dir_index.get(nr, TERN1(SDSORT_GCODE, sort_alpha))) return;
+    #endif
     selectFileByIndex(TERN1(SDSORT_GCODE, sort_alpha) && (nr < sort_count)
       ? sort_order[nr] : nr);
   }
@@ -965,6 +1027,9 @@ void CardReader::cdroot() {
     // Sorting may be turned off
     if (TERN0(SDSORT_GCODE, !sort_alpha)) return;
 
+    // The on-card index has its own sort order
+    if (TERN0(SD_DIR_INDEX, dir_index.ready())) return;
+
     // If there are files, sort up to the limit
     uint16_t fileCnt = countFilesInWorkDir();
     if (fileCnt > 0) {
@@ -1143,6 +1208,9 @@ void CardReader::cdroot() {
 
 uint16_t CardReader::get_num_Files() {
   if (!isMounted()) return 0;
+  #if ENABLED(SD_DIR_INDEX)
+    if (dir_index.ready()) return dir_index.count();
+  #endif
   return (
     #if ALL(SDCARD_SORT_ALPHA, SDSORT_USES_RAM, SDSORT_CACHE_NAMES)
       nrFiles // no need to access the SD card for filenames
@@ -1152,6 +1220,128 @@ uint16_t CardReader::get_num_Files() {
   );
 }
 
+#if ENABLED(SD_READ_AHEAD)
+
+  /**
+   * Fill free blocks of the read-ahead ring, up to the end of the buffer,
+   * with one read. This is done when the ring is half empty, so there are
+   * always whole lines ready and the card is accessed a few blocks at a time.
+   */
+  void CardReader::ahead_fill() {
+    uint8_t tail = ahead_head + ahead_count;
+    if (tail >= SD_READ_AHEAD_BLOCKS) tail -= SD_READ_AHEAD_BLOCKS;
+    const uint8_t n = _MIN(SD_READ_AHEAD_BLOCKS - ahead_count, SD_READ_AHEAD_BLOCKS - tail);
+    if (!n) return;
+
+    const int16_t got = file.readBlocks(ahead_buf[tail], n);
+    for (int16_t left = got; left > 0; left -= 512) {   // Nothing at EOF, or on error
+      ahead_len[tail++] = _MIN(left, 512);
+      ahead_count++;
+    }
+  }
+
+  /**
+   * Get a byte when the head block is used up: move to the next block,
+   * reading more blocks when needed. -1 at the end of the file or on error.
+   */
+  int16_t CardReader::ahead_get() {
+    if (ahead_ptr) {                                    // Done with the head block
+      if (++ahead_head >= SD_READ_AHEAD_BLOCKS) ahead_head = 0;
+      ahead_count--;
+      ahead_ptr = ahead_end = nullptr;
+    }
+
+    #if ENABLED(SD_ASYNC_READ)
+      ahead_poll();
+      if (!ahead_count && ahead_busy) {                 // Nothing ready, so wait for the read
+        const uint32_t us = micros();
+        read_stats.waits++;
+        do ahead_poll(); while (!ahead_count && ahead_busy);
+        read_stats.wait_us += micros() - us;
+      }
+    #else
+      if (ahead_count <= (SD_READ_AHEAD_BLOCKS) / 2) ahead_fill();
+    #endif
+
+    sdpos = ahead_next;
+    if (!ahead_count) return -1;
+
+    const uint8_t * const b = ahead_buf[ahead_head];
+    ahead_ptr = b + ahead_skip;
+    ahead_end = b + ahead_len[ahead_head];
+    ahead_skip = 0;
+    if (ahead_ptr >= ahead_end) return -1;              // Seek to the end
+
+    ahead_next++;
+    return *ahead_ptr++;
+  }
+
+  #if ENABLED(SD_ASYNC_READ)
+
+    /**
+     * Keep the next free block of the ring being read in the background.
+     * Take in a finished read and start the next one. A failed read is
+     * done again the blocking way, with the driver's retries.
+     */
+    void CardReader::ahead_poll() {
+      uint8_t tail = ahead_head + ahead_count;
+      if (tail >= SD_READ_AHEAD_BLOCKS) tail -= SD_READ_AHEAD_BLOCKS;
+
+      if (ahead_busy) {
+        const int8_t status = file.readBlockDone();
+        if (!status) return;
+        ahead_busy = false;
+
+        const uint32_t us = micros() - ahead_busy_us;
+        read_stats.reads++;
+        read_stats.read_us += us;
+        NOLESS(read_stats.max_us, us);
+
+        if (status < 0) {
+          file.seekSet(ahead_busy_pos);
+          if (file.readBlocks(ahead_buf[tail], 1) <= 0) return;   // ahead_get reports the error
+        }
+        ahead_len[tail] = ahead_busy_len;
+        ahead_count++;
+        if (++tail >= SD_READ_AHEAD_BLOCKS) tail = 0;
+      }
+
+      while (ahead_count < SD_READ_AHEAD_BLOCKS) {
+        const uint32_t pos = file.curPosition();
+        bool busy = false;
+        const int16_t got = file.readBlockStart(ahead_buf[tail], busy);
+        if (got <= 0) return;                             // End of file, or error
+        if (busy) {
+          ahead_busy = true;
+          ahead_busy_len = got;
+          ahead_busy_pos = pos;
+          ahead_busy_us = micros();
+          return;
+        }
+        ahead_len[tail] = got;                            // Copied from the block cache
+        ahead_count++;
+        if (++tail >= SD_READ_AHEAD_BLOCKS) tail = 0;
+      }
+    }
+
+    // Let a background read finish before the ring is reused
+    void CardReader::ahead_cancel() {
+      if (!ahead_busy) return;
+      while (!file.readBlockDone()) { /* wait */ }
+      ahead_busy = false;
+    }
+
+    void CardReader::report_read_stats() {
+      SERIAL_ECHOPAIR("SD reads:", read_stats.reads);
+      if (read_stats.reads)
+        SERIAL_ECHOPAIR(" avg:", read_stats.read_us / read_stats.reads, "us max:", read_stats.max_us, "us");
+      SERIAL_ECHOLNPAIR(" waits:", read_stats.waits, " wait:", read_stats.wait_us / 1000, "ms");
+    }
+
+  #endif // SD_ASYNC_READ
+
+#endif // SD_READ_AHEAD
+
 //
 // Return from procedure or close out the Print Job
 //
@@ -1180,7 +1370,7 @@ void CardReader::fileHasFinished() {
 
   void CardReader::auto_report_sd_status() {
     millis_t current_ms = millis();
-    if (auto_report_sd_interval && ELAPSED(current_ms, next_sd_report_ms)) {
+    if (auto_report_sd_interval && ELAPSED(current_ms, next_sd_report_ms) && !SERIAL_TX_DEFER()) {
       next_sd_report_ms = current_ms + 1000UL * auto_report_sd_interval;
       PORT_REDIRECT(auto_report_port);
       report_status();
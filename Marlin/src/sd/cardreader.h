@@ -43,6 +43,14 @@
 
 #include "SdFile.h"
 
+#if ENABLED(SD_DIR_INDEX)
+  #include "dirindex.h"
+#endif
+
+#if ENABLED(SD_GCODE_INDEX)
+  #include "gcodeindex.h"
+#endif
+
 typedef struct {
   bool saving:1,
        logging:1,
@@ -57,6 +65,13 @@ typedef struct {
     ;
 } card_flags_t;
 
+#if ENABLED(SD_ASYNC_READ)
+  typedef struct {
+    uint32_t reads, read_us, max_us;  // Background reads and their times
+    uint32_t waits, wait_us;          // Times the printer had to wait for a block
+  } sd_read_stats_t;
+#endif
+
 class CardReader {
 public:
   static card_flags_t flag;                         // Flags (above)
@@ -126,13 +141,25 @@ public:
   static void startFileprint();
   static void endFilePrint(TERN_(SD_RESORT, const bool re_sort=false));
   static void report_status();
+  #if ENABLED(SD_ASYNC_READ)
+    static void ahead_poll();                         // Take in and start background reads. Call often while printing.
+    static void report_read_stats();
+  #endif
   static inline void pauseSDPrint() { flag.sdprinting = false; }
   static inline bool isPaused() { return isFileOpen() && !flag.sdprinting; }
   static inline bool isPrinting() { return flag.sdprinting; }
   #if HAS_PRINT_PROGRESS_PERMYRIAD
-    static inline uint16_t permyriadDone() { return (isFileOpen() && filesize) ? sdpos / ((filesize + 9999) / 10000) : 0; }
+    static inline uint16_t permyriadDone() {
+      if (!isFileOpen() || !filesize) return 0;
+      TERN_(SD_GCODE_INDEX, if (gcode_index.ready()) return gcode_index.permyriad()); // By estimated time
+      return sdpos / ((filesize + 9999) / 10000);
+    }
   #endif
-  static inline uint8_t percentDone() { return (isFileOpen() && filesize) ? sdpos / ((filesize + 99) / 100) : 0; }
+  static inline uint8_t percentDone() {
+    if (!isFileOpen() || !filesize) return 0;
+    TERN_(SD_GCODE_INDEX, if (gcode_index.ready()) return gcode_index.permyriad() / 100); // By estimated time
+    return sdpos / ((filesize + 99) / 100);
+  }
 
   // Helper for open and remove
   static const char* diveToFile(const bool update_cwd, SdFile*& curDir, const char * const path, const bool echo=false);
@@ -142,7 +169,7 @@ public:
     static void getfilename_sorted(const uint16_t nr);
     #if ENABLED(SDSORT_GCODE)
       FORCE_INLINE static void setSortOn(bool b) { sort_alpha = b; presort(); }
-      FORCE_INLINE static void setSortFolders(int i) { sort_folders = i; presort(); }
+      FORCE_INLINE static void setSortFolders(int i) { sort_folders = i; TERN_(SD_DIR_INDEX, dir_index.changed_dir()); presort(); }
       //FORCE_INLINE static void setSortReverse(bool b) { sort_reverse = b; }
     #endif
   #else
@@ -159,9 +186,28 @@ public:
   static inline uint32_t getIndex() { return sdpos; }
   static inline uint32_t getFileSize() { return filesize; }
   static inline bool eof() { return sdpos >= filesize; }
-  static inline void setIndex(const uint32_t index) { sdpos = index; file.seekSet(index); }
+  static inline void setIndex(const uint32_t index) {
+    sdpos = index;
+    #if ENABLED(SD_READ_AHEAD)
+      ahead_reset(index);
+      const uint32_t pos = index & ~0x1FFUL;  // Read-ahead starts at the block
+    #else
+      const uint32_t pos = index;
+    #endif
+    #if ENABLED(SD_FAST_SEEK)
+      if (extent_count) { file.seekExtents(pos, extent, extent_count); return; }
+    #endif
+    file.seekSet(pos);
+  }
   static inline char* getWorkDirName() { workDir.getDosName(filename); return filename; }
-  static inline int16_t get() { sdpos = file.curPosition(); return (int16_t)file.read(); }
+  static inline int16_t get() {
+    #if ENABLED(SD_READ_AHEAD)
+      if (ahead_ptr < ahead_end) { sdpos = ahead_next++; return *ahead_ptr++; }
+      return ahead_get();
+    #else
+      sdpos = file.curPosition(); return (int16_t)file.read();
+    #endif
+  }
   static inline int16_t read(void* buf, uint16_t nbyte) { return file.isOpen() ? file.read(buf, nbyte) : -1; }
   static inline int16_t write(void* buf, uint16_t nbyte) { return file.isOpen() ? file.write(buf, nbyte) : -1; }
 
@@ -178,6 +224,9 @@ public:
   #endif
 
 private:
+  TERN_(SD_DIR_INDEX, friend class DirIndex);
+  TERN_(SD_GCODE_INDEX, friend class GCodeIndex);
+
   //
   // Working directory and parents
   //
@@ -246,6 +295,48 @@ private:
 
   static uint32_t filesize, sdpos;
 
+  //
+  // Read-ahead ring for the printed file
+  //
+  #if ENABLED(SD_READ_AHEAD)
+    alignas(4) static uint8_t ahead_buf[SD_READ_AHEAD_BLOCKS][512];  // Aligned for DMA
+    static uint16_t ahead_len[SD_READ_AHEAD_BLOCKS];  // Bytes in each block
+    static uint8_t ahead_head, ahead_count;           // Block being read, blocks filled
+    static const uint8_t *ahead_ptr, *ahead_end;      // Next byte and end of the head block
+    static uint32_t ahead_next;                       // File position of the next byte
+    static uint16_t ahead_skip;                       // Bytes to skip in the first block after a seek
+
+    static inline void ahead_reset(const uint32_t index) {
+      TERN_(SD_ASYNC_READ, ahead_cancel());
+      ahead_head = ahead_count = 0;
+      ahead_ptr = ahead_end = nullptr;
+      ahead_next = index;
+      ahead_skip = index & 0x1FF;
+    }
+    static void ahead_fill();
+    static int16_t ahead_get();
+  #endif
+
+  #if ENABLED(SD_ASYNC_READ)
+    static bool ahead_busy;                           // A block is being read into the tail
+    static uint16_t ahead_busy_len;                   // Bytes in that block
+    static uint32_t ahead_busy_pos, ahead_busy_us;    // Its file position, and when the read started
+    static sd_read_stats_t read_stats;                // For 'M27 L'
+    static void ahead_cancel();
+  #endif
+
+  #if ENABLED(SD_WRITE_STREAM)
+    static millis_t write_start_ms;                   // For the M29 speed report
+  #endif
+
+  //
+  // Cluster map of the printed file
+  //
+  #if ENABLED(SD_FAST_SEEK)
+    static fat_extent_t extent[SD_SEEK_EXTENTS];
+    static uint8_t extent_count;                      // 0 to seek through the FAT
+  #endif
+
   //
   // Procedure calls to other files
   //
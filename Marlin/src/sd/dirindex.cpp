@@ -0,0 +1,277 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../inc/MarlinConfigPre.h"
+
+#if ENABLED(SD_DIR_INDEX)
+
+#include "dirindex.h"
+#include "cardreader.h"
+#include "../libs/crc16.h"
+
+DirIndex dir_index;
+
+SdFile DirIndex::file;
+dir_index_header_t DirIndex::slot[SD_DIR_INDEX_DIRS];
+uint8_t DirIndex::cur;
+bool DirIndex::active, DirIndex::stale;
+uint16_t DirIndex::verified;
+
+#define DIR_INDEX_MAGIC 0x58444E01UL      // "\1NDX"
+#define DIR_INDEX_ENTRY_SIZE 128
+
+static_assert(sizeof(dir_index_entry_t) <= DIR_INDEX_ENTRY_SIZE, "LONG_FILENAME_LENGTH is too long for SD_DIR_INDEX.");
+
+/**
+ * Each slot is one block for the header, the order table
+ * rounded up to whole blocks, and then the entries.
+ */
+constexpr uint32_t order_offset = 512,
+                   entry_offset = order_offset + ((SD_DIR_INDEX_LIMIT) * 2UL + 511) / 512 * 512,
+                   slot_size = entry_offset + (SD_DIR_INDEX_LIMIT) * uint32_t(DIR_INDEX_ENTRY_SIZE),
+                   index_size = slot_size * (SD_DIR_INDEX_DIRS);
+
+static inline uint32_t slot_pos(const uint8_t s) { return s * slot_size; }
+static inline uint32_t order_pos(const uint8_t s, const uint16_t nr) { return slot_pos(s) + order_offset + nr * 2UL; }
+static inline uint32_t entry_pos(const uint8_t s, const uint16_t nr) { return slot_pos(s) + entry_offset + nr * uint32_t(DIR_INDEX_ENTRY_SIZE); }
+
+void DirIndex::reset() {
+  if (file.isOpen()) file.close();
+  verified = 0;
+  active = false;
+  stale = true;
+}
+
+/**
+ * Open the index file, creating it if needed, and read the slot headers.
+ * A file of the wrong size (from other settings) is replaced.
+ */
+bool DirIndex::open() {
+  if (file.isOpen()) return true;
+
+  SdFile root = card.getroot();
+  if (file.open(&root, SD_DIR_INDEX_FILE, O_RDWR)) {
+    if (file.fileSize() == index_size) {
+      LOOP_L_N(s, SD_DIR_INDEX_DIRS) {
+        if (!file.seekSet(slot_pos(s)) || file.read(&slot[s], sizeof(slot[s])) != int16_t(sizeof(slot[s]))) {
+          file.close();
+          return false;
+        }
+        if (slot[s].magic != DIR_INDEX_MAGIC) slot[s].magic = slot[s].seq = 0;
+      }
+      return true;
+    }
+    if (!file.remove()) { file.close(); return false; }
+  }
+
+  // Allocate the whole file now so every slot can be written in place
+  if (!file.createContiguous(&root, SD_DIR_INDEX_FILE, index_size)) return false;
+
+  ZERO(slot);
+  LOOP_L_N(s, SD_DIR_INDEX_DIRS)
+    if (!file.seekSet(slot_pos(s)) || file.write(&slot[s], sizeof(slot[s])) != int16_t(sizeof(slot[s]))) {
+      file.close();
+      return false;
+    }
+  return file.sync();
+}
+
+/**
+ * Count the listed items in a folder and make their signature.
+ * With a slot given, also store the items in it, in folder order.
+ * Fails if there are more than SD_DIR_INDEX_LIMIT items.
+ */
+bool DirIndex::scan(SdFile dir, uint16_t &count, uint16_t &signature, const uint8_t s/*=0xFF*/) {
+  dir_t p;
+  dir_index_entry_t e;
+  count = signature = 0;
+  dir.rewind();
+  while (dir.readDir(&p, e.longFilename) > 0) {
+    if (!card.is_dir_or_gcode(p)) continue;
+    if (count >= SD_DIR_INDEX_LIMIT) return false;
+    crc16(&signature, &p, sizeof(p));
+    crc16(&signature, e.longFilename, strlen(e.longFilename));
+    if (s < SD_DIR_INDEX_DIRS) {
+      SdBaseFile::dirName(p, e.filename);
+      e.isDir = DIR_IS_SUBDIR(&p);
+      if (!file.seekSet(entry_pos(s, count)) || file.write(&e, sizeof(e)) != int16_t(sizeof(e))) return false;
+    }
+    count++;
+  }
+  return true;
+}
+
+bool DirIndex::read_entry(const uint8_t s, const uint16_t nr, dir_index_entry_t &e) {
+  return file.seekSet(entry_pos(s, nr)) && file.read(&e, sizeof(e)) == int16_t(sizeof(e));
+}
+
+#if ENABLED(SDCARD_SORT_ALPHA)
+
+  #if HAS_FOLDER_SORTING
+    #define FOLDER_ORDER TERN(SDSORT_GCODE, card.sort_folders, FOLDER_SORTING)
+  #else
+    #define FOLDER_ORDER 0
+  #endif
+
+  // Compare items the same way as CardReader::presort()
+  static int compare(const dir_index_entry_t &a, const dir_index_entry_t &b, const int8_t folders) {
+    if (folders && a.isDir != b.isDir) return a.isDir == (folders > 0) ? 1 : -1;
+    return strcasecmp(a.longFilename[0] ? a.longFilename : a.filename,
+                      b.longFilename[0] ? b.longFilename : b.filename);
+  }
+
+  /**
+   * Sort the items of a slot by binary insertion into a static order
+   * table. Only the item being inserted is held in RAM. The others are
+   * read back from the index, so most compares are served by the
+   * volume's block cache.
+   */
+  bool DirIndex::sort(const uint8_t s) {
+    const uint16_t n = slot[s].count;
+    if (n == 0) return true;
+
+    const int8_t folders = FOLDER_ORDER;
+    static uint16_t order[SD_DIR_INDEX_LIMIT];
+    dir_index_entry_t key, e;
+    for (uint16_t i = 0; i < n; i++) {
+      if (!read_entry(s, i, key)) return false;
+      uint16_t lo = 0, hi = i;
+      while (lo < hi) {
+        const uint16_t mid = (lo + hi) / 2;
+        if (!read_entry(s, order[mid], e)) return false;
+        if (compare(e, key, folders) > 0) hi = mid; else lo = mid + 1;
+      }
+      for (uint16_t j = i; j > lo; j--) order[j] = order[j - 1];
+      order[lo] = i;
+    }
+
+    if (!file.seekSet(order_pos(s, 0)) || file.write(order, n * 2) != int16_t(n * 2)) return false;
+    slot[s].folders = folders;
+    slot[s].sorted = true;
+    return true;
+  }
+
+#endif // SDCARD_SORT_ALPHA
+
+/**
+ * Make the slot for a folder current, checking it against
+ * the folder the first time and indexing it if it changed.
+ */
+bool DirIndex::select(SdFile &dir) {
+  if (!open()) return false;
+
+  // Find the folder's slot, and the oldest one to reuse
+  const uint32_t cluster = dir.firstCluster();
+  int8_t s = -1;
+  uint8_t oldest = 0;
+  uint32_t last = 0;
+  LOOP_L_N(i, SD_DIR_INDEX_DIRS) {
+    if (slot[i].magic == DIR_INDEX_MAGIC && slot[i].cluster == cluster) s = i;
+    if (slot[i].seq < slot[oldest].seq) oldest = i;
+    NOLESS(last, slot[i].seq);
+  }
+
+  bool write_header = false;
+
+  if (s < 0 || !TEST(verified, s)) {
+    uint16_t count, signature;
+    bool rebuild = s < 0;
+    if (!rebuild) {
+      if (!scan(dir, count, signature)) return false;
+      rebuild = count != slot[s].count || signature != slot[s].signature;
+    }
+    if (rebuild) {
+      // Index the folder in its old slot, or in the oldest one
+      if (s < 0) s = oldest;
+      dir_index_header_t &h = slot[s];
+      if (h.magic) {
+        h.magic = 0;    // Unused until the entries are stored
+        if (!file.seekSet(slot_pos(s)) || file.write(&h, sizeof(h)) != int16_t(sizeof(h)) || !file.sync()) return false;
+      }
+      if (!scan(dir, count, signature, s)) return false;
+      h.magic = DIR_INDEX_MAGIC;
+      h.cluster = cluster;
+      h.seq = last + 1;
+      h.signature = signature;
+      h.count = count;
+      h.sorted = false;
+      write_header = true;
+    }
+  }
+
+  #if ENABLED(SDCARD_SORT_ALPHA)
+    if (!slot[s].sorted || slot[s].folders != FOLDER_ORDER) {
+      if (!sort(s)) return false;
+      write_header = true;
+    }
+  #endif
+
+  if (write_header) {
+    if (!file.seekSet(slot_pos(s)) || file.write(&slot[s], sizeof(slot[s])) != int16_t(sizeof(slot[s])) || !file.sync())
+      return false;
+  }
+
+  SBI(verified, s);
+  cur = s;
+  return true;
+}
+
+bool DirIndex::ready() {
+  if (stale) {
+    stale = false;
+    active = card.isMounted() && select(card.workDir);
+  }
+  return active;
+}
+
+// Get item nr into the CardReader, by sorted or folder order
+bool DirIndex::get(uint16_t nr, const bool sorted) {
+  if (nr >= count()) return false;
+  #if ENABLED(SDCARD_SORT_ALPHA)
+    if (sorted && (!file.seekSet(order_pos(cur, nr)) || file.read(&nr, 2) != 2)) return false;
+  #else
+    UNUSED(sorted);
+  #endif
+  dir_index_entry_t e;
+  if (!read_entry(cur, nr, e)) return false;
+  strcpy(card.filename, e.filename);
+  strcpy(card.longFilename, e.longFilename);
+  card.flag.filenameIsDir = e.isDir;
+  return true;
+}
+
+// Get an item into the CardReader by DOS name
+bool DirIndex::find(const char * const match) {
+  dir_index_entry_t e;
+  for (uint16_t nr = 0; nr < count(); nr++) {
+    if (!read_entry(cur, nr, e)) return false;
+    if (strcasecmp(match, e.filename) == 0) {
+      strcpy(card.filename, e.filename);
+      strcpy(card.longFilename, e.longFilename);
+      card.flag.filenameIsDir = e.isDir;
+      return true;
+    }
+  }
+  return false;
+}
+
+#endif // SD_DIR_INDEX
@@ -0,0 +1,87 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * sd/dirindex.h - Persistent folder index for SD menus
+ *
+ * Listed items of recently browsed folders are kept in a file on the card,
+ * with their short and long names and the sorted order. Menus then count,
+ * sort, and fetch items with a couple of small reads instead of scanning
+ * the folder for every line drawn.
+ *
+ * Each folder is identified by its first cluster and checked against a
+ * CRC of its listed entries the first time it's used after a mount, or
+ * after a file is written or deleted. It is re-indexed when it changed.
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#include "SdFile.h"
+
+#define SD_DIR_INDEX_FILE "DIRINDEX.BIN"
+
+// Stored at the start of each folder slot
+typedef struct {
+  uint32_t magic;       // DIR_INDEX_MAGIC, so an unused slot is ignored
+  uint32_t cluster;     // First cluster of the folder
+  uint32_t seq;         // Build sequence, to reuse the oldest slot
+  uint16_t signature;   // CRC16 of the listed entries and long names
+  uint16_t count;       // Number of listed items
+  int8_t folders;       // Folder sorting when the order was made
+  bool sorted;          // The order table is valid
+} dir_index_header_t;
+
+// One listed item. Four fit in a block.
+typedef struct {
+  char filename[FILENAME_LENGTH];
+  bool isDir;
+  char longFilename[LONG_FILENAME_LENGTH];
+} dir_index_entry_t;
+
+class DirIndex {
+public:
+  static void reset();                          // Forget everything. Call on mount and release.
+  static inline void invalidate() { verified = 0; stale = true; } // Something changed on the card
+  static inline void changed_dir() { stale = true; }              // A new working directory
+
+  static bool ready();                          // Index the working directory if needed. True if usable.
+
+  static inline uint16_t count() { return slot[cur].count; }
+  static bool get(uint16_t nr, const bool sorted);
+  static bool find(const char * const match);
+
+private:
+  static SdFile file;
+  static dir_index_header_t slot[SD_DIR_INDEX_DIRS];
+  static uint8_t cur;                           // Slot of the working directory
+  static bool active, stale;
+  static uint16_t verified;                     // Slots checked since the last change, one bit each
+
+  static bool open();
+  static bool scan(SdFile dir, uint16_t &count, uint16_t &signature, const uint8_t s=0xFF);
+  static bool sort(const uint8_t s);
+  static bool select(SdFile &dir);
+  static bool read_entry(const uint8_t s, const uint16_t nr, dir_index_entry_t &e);
+};
+
+extern DirIndex dir_index;
@@ -0,0 +1,369 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../inc/MarlinConfigPre.h"
+
+#if ENABLED(SD_GCODE_INDEX)
+
+#include "gcodeindex.h"
+#include "cardreader.h"
+#include "../libs/crc16.h"
+#include "../module/planner.h"
+
+GCodeIndex gcode_index;
+
+SdFile GCodeIndex::file, GCodeIndex::scan_file;
+gcode_index_header_t GCodeIndex::head;
+bool GCodeIndex::active;
+gcode_scan_state_t GCodeIndex::st;
+uint32_t GCodeIndex::scan_pos, GCodeIndex::line_start;
+float GCodeIndex::time_frac;
+uint8_t GCodeIndex::line_len;
+bool GCodeIndex::in_comment;
+uint16_t GCodeIndex::unsaved;
+millis_t GCodeIndex::next_scan_ms;
+char GCodeIndex::line[96];
+bool GCodeIndex::located;
+uint32_t GCodeIndex::from_offset, GCodeIndex::to_offset, GCodeIndex::from_time, GCodeIndex::to_time;
+
+#define GCODE_INDEX_MAGIC 0x58444C01UL      // "\1LDX"
+#define GCODE_INDEX_LAYER_SIZE 32
+#define GCODE_INDEX_SAVE_BLOCKS 64          // Save the scan state every 32K of the file
+#define GCODE_INDEX_SCAN_MS 10              // Time between blocks while printing
+#define GCODE_INDEX_MIN_LAYER 0.04f         // (mm) Smallest Z change that starts a layer
+
+static_assert(sizeof(gcode_index_header_t) <= 512, "gcode_index_header_t is too big.");
+static_assert(sizeof(gcode_index_layer_t) <= GCODE_INDEX_LAYER_SIZE, "gcode_index_layer_t is too big.");
+
+constexpr uint32_t index_size = 512 + (SD_GCODE_INDEX_LAYERS) * uint32_t(GCODE_INDEX_LAYER_SIZE);
+
+static inline uint32_t layer_pos(const uint16_t nr) { return 512 + nr * uint32_t(GCODE_INDEX_LAYER_SIZE); }
+
+void GCodeIndex::reset() {
+  if (file.isOpen()) file.close();
+  active = false;
+}
+
+/**
+ * Open the index file, creating it if needed, and read the header.
+ * A file of the wrong size (from other settings) is replaced.
+ */
+bool GCodeIndex::open_index() {
+  if (file.isOpen()) return true;
+
+  SdFile root = card.getroot();
+  if (file.open(&root, SD_GCODE_INDEX_FILE, O_RDWR)) {
+    if (file.fileSize() == index_size) {
+      if (file.seekSet(0) && file.read(&head, sizeof(head)) == int16_t(sizeof(head))) return true;
+      file.close();
+      return false;
+    }
+    if (!file.remove()) { file.close(); return false; }
+  }
+
+  // Allocate the whole file now so layers can be written in place
+  if (!file.createContiguous(&root, SD_GCODE_INDEX_FILE, index_size)) return false;
+
+  head.magic = 0;
+  return file.seekSet(0) && file.write(&head, sizeof(head)) == int16_t(sizeof(head)) && file.sync();
+}
+
+bool GCodeIndex::save_header() {
+  unsaved = 0;
+  head.scanned = line_start;
+  head.state = st;
+  return file.seekSet(0) && file.write(&head, sizeof(head)) == int16_t(sizeof(head)) && file.sync();
+}
+
+/**
+ * Take up the index of the file just opened for printing, or start
+ * a new one. The scan reads a copy of the file, so the print's own
+ * position is left alone.
+ */
+void GCodeIndex::open() {
+  active = located = false;
+  if (!open_index()) return;
+
+  scan_file = card.file;
+
+  // Identify the file by its first block
+  uint16_t signature = 0;
+  uint8_t buf[64];
+  if (!scan_file.seekSet(0)) return;
+  for (uint16_t n = 0; n < 512;) {
+    const int16_t len = scan_file.read(buf, sizeof(buf));
+    if (len < 0) return;
+    if (len == 0) break;
+    crc16(&signature, buf, len);
+    n += len;
+  }
+
+  const uint32_t cluster = card.file.firstCluster(), size = card.getFileSize();
+  if (head.magic != GCODE_INDEX_MAGIC || head.cluster != cluster || head.size != size || head.signature != signature) {
+    memset(&head, 0, sizeof(head));
+    head.magic = GCODE_INDEX_MAGIC;
+    head.cluster = cluster;
+    head.size = size;
+    head.signature = signature;
+    head.state.feedrate = MMM_TO_MMS(1500);
+    head.state.layer_z = -1;
+    line_start = 0;
+    st = head.state;
+    if (!save_header()) return;
+  }
+
+  st = head.state;
+  scan_pos = line_start = head.scanned;
+  if (!head.complete && !scan_file.seekSet(scan_pos)) return;
+  line_len = 0;
+  in_comment = false;
+  time_frac = 0;
+  unsaved = 0;
+  active = true;
+}
+
+// Keep the scan state, to carry on when the file is opened again
+void GCodeIndex::close() {
+  if (active && !head.complete && unsaved) save_header();
+  active = false;
+}
+
+bool GCodeIndex::layer(const uint16_t nr, gcode_index_layer_t &l) {
+  return active && nr < head.layers
+      && file.seekSet(layer_pos(nr)) && file.read(&l, sizeof(l)) == int16_t(sizeof(l));
+}
+
+void GCodeIndex::add_time(const float ms) {
+  time_frac += ms;
+  const uint32_t whole = time_frac;
+  st.time += whole;
+  time_frac -= whole;
+}
+
+void GCodeIndex::add_layer() {
+  st.layer_z = st.pos[Z_AXIS];
+  if (head.layers >= SD_GCODE_INDEX_LAYERS) return;   // Progress carries on from the last one
+  st.next.z = st.layer_z;
+  if (file.seekSet(layer_pos(head.layers)) && file.write(&st.next, sizeof(st.next)) == int16_t(sizeof(st.next)))
+    head.layers++;
+}
+
+// Get the next word of a line. Stops at a checksum.
+static bool next_word(const char *&p, char &letter, float &value) {
+  while (*p == ' ' || *p == '\t') p++;
+  letter = toupper(*p);
+  if (!letter || letter == '*') return false;
+  char *end;
+  value = strtof(++p, &end);
+  p = end;
+  return true;
+}
+
+/**
+ * Follow the position, feedrate, E and time through a line. A layer
+ * starts with the line that last moved Z, once there is extrusion at
+ * the new height. Arcs are timed by their chord, and moves by their
+ * feedrate, limited by the axis maximums. Moves without extrusion
+ * start and end at a stop, so they also take their acceleration time.
+ */
+void GCodeIndex::scan_line() {
+  line[line_len] = '\0';
+
+  char code = 0;
+  int16_t num = -1;
+  float v[XYZE] = { 0 }, feedrate = 0, dwell = 0;
+  uint8_t seen = 0;
+
+  const char *p = line;
+  char letter;
+  float value;
+  while (next_word(p, letter, value)) {
+    switch (letter) {
+      case 'G': case 'M': if (!code) { code = letter; num = value; } break;
+      case 'X': v[X_AXIS] = value; SBI(seen, X_AXIS); break;
+      case 'Y': v[Y_AXIS] = value; SBI(seen, Y_AXIS); break;
+      case 'Z': v[Z_AXIS] = value; SBI(seen, Z_AXIS); break;
+      case 'E': v[E_AXIS] = value; SBI(seen, E_AXIS); break;
+      case 'F': feedrate = value; break;
+      case 'P': dwell = value; break;
+      case 'S': dwell = value * 1000; break;
+    }
+  }
+
+  if (code == 'M') {
+    if (num == 82) st.relative_e = false;
+    else if (num == 83) st.relative_e = true;
+    return;
+  }
+  if (code != 'G') return;
+
+  switch (num) {
+    case 0: case 1: case 2: case 3: break;
+    case 4: add_time(dwell); return;
+    case 28: LOOP_XYZ(i) if (!seen || TEST(seen, i)) st.pos[i] = 0; return;
+    case 90: st.relative_xyz = st.relative_e = false; return;
+    case 91: st.relative_xyz = st.relative_e = true; return;
+    case 92: LOOP_XYZE(i) if (!seen || TEST(seen, i)) st.pos[i] = v[i]; return;
+    default: return;
+  }
+
+  // The state before a Z move, in case it starts a layer
+  if (TEST(seen, Z_AXIS)) {
+    st.next.offset = line_start;
+    st.next.e = st.pos[E_AXIS];
+    st.next.filament = st.filament;
+    st.next.time = st.time;
+    st.next.relative_e = st.relative_e;
+  }
+
+  float d[XYZE];
+  LOOP_XYZE(i) {
+    d[i] = TEST(seen, i) ? ((i == E_AXIS ? st.relative_e : st.relative_xyz) ? v[i] : v[i] - st.pos[i]) : 0;
+    st.pos[i] += d[i];
+  }
+  if (feedrate > 0) st.feedrate = MMM_TO_MMS(feedrate);
+
+  const float xyz = SQRT(sq(d[X_AXIS]) + sq(d[Y_AXIS]) + sq(d[Z_AXIS])),
+              len = xyz ?: ABS(d[E_AXIS]);
+  const bool extruding = xyz && d[E_AXIS] > 0;
+
+  if (len) {
+    float rate = st.feedrate;
+    LOOP_XYZE(i) if (d[i]) NOMORE(rate, planner.settings.max_feedrate_mm_s[i] * len / ABS(d[i]));
+    float t = len / rate;
+    if (!extruding) {
+      const float accel = xyz ? planner.settings.travel_acceleration : planner.settings.retract_acceleration;
+      t = len * accel >= sq(rate) ? t + rate / accel : 2 * SQRT(len / accel);
+    }
+    add_time(t * 1000);
+  }
+
+  if (d[E_AXIS] > 0) st.filament += d[E_AXIS];
+
+  if (extruding && ABS(st.pos[Z_AXIS] - st.layer_z) >= GCODE_INDEX_MIN_LAYER) add_layer();
+}
+
+/**
+ * With the scan done, find the layers on either side of the print
+ * position. Usually that's the next pair, but after a seek it takes
+ * a binary search of the index.
+ */
+void GCodeIndex::track() {
+  const uint32_t pos = card.getIndex();
+  if (located_at(pos)) return;
+
+  gcode_index_layer_t l;
+  int16_t lo = -1, hi = head.layers;  // The last layer at or before pos is in [lo, hi)
+  while (hi - lo > 1) {
+    const int16_t mid = (lo + hi) / 2;
+    if (!layer(mid, l)) return;
+    if (l.offset <= pos) lo = mid; else hi = mid;
+  }
+
+  if (lo < 0) from_offset = from_time = 0;
+  else {
+    if (!layer(lo, l)) return;
+    from_offset = l.offset;
+    from_time = l.time;
+  }
+  if (hi < head.layers) {
+    if (!layer(hi, l)) return;
+    to_offset = l.offset;
+    to_time = l.time;
+  }
+  else {
+    to_offset = head.size;
+    to_time = head.state.time;
+  }
+  located = true;
+}
+
+uint16_t GCodeIndex::permyriad() {
+  const uint32_t pos = card.getIndex();
+  // Until track() finds the layers (after the scan or a seek) go by bytes
+  if (!located_at(pos) || !head.state.time)
+    return head.size ? _MIN(10000U, pos / ((head.size + 9999) / 10000)) : 0;
+  float t = from_time;
+  if (pos >= to_offset)
+    t = to_time;
+  else if (pos > from_offset)
+    t += float(to_time - from_time) * (pos - from_offset) / (to_offset - from_offset);
+  return _MIN(10000U, uint32_t(t * 10000 / head.state.time));
+}
+
+void GCodeIndex::report() {
+  if (!active) return SERIAL_ECHOLNPGM("No index.");
+  SERIAL_ECHOPAIR("Index layers:", head.layers);
+  if (!head.complete)
+    SERIAL_ECHOLNPAIR(" scanned:", scan_pos, "/", head.size);
+  else {
+    const uint16_t done = permyriad();
+    SERIAL_ECHOLNPAIR(" time:", head.state.time / 1000, "s filament:", head.state.filament, "mm done:", done / 100, ".", done / 10 % 10, "%");
+  }
+}
+
+/**
+ * Scan a block of the file, at most every GCODE_INDEX_SCAN_MS while
+ * printing, so the print's own reads come first. Once it's done,
+ * keep up with the print position.
+ */
+void GCodeIndex::task() {
+  if (!active) return;
+  if (head.complete) return track();
+
+  const millis_t ms = millis();
+  if (card.isPrinting()) {
+    if (PENDING(ms, next_scan_ms)) return;
+    next_scan_ms = ms + GCODE_INDEX_SCAN_MS;
+  }
+
+  char buf[64];
+  for (uint16_t n = 0; n < 512; n += sizeof(buf)) {
+    const int16_t len = scan_file.read(buf, sizeof(buf));
+    if (len < 0) { active = false; return; }          // Try again when the file is next opened
+    if (len == 0) {
+      if (line_len) scan_line();                      // No newline at the end
+      line_start = scan_pos;
+      head.complete = true;
+      if (!save_header()) active = false;
+      return;
+    }
+    LOOP_L_N(i, len) {
+      const char c = buf[i];
+      scan_pos++;
+      if (c == '\n' || c == '\r') {
+        if (line_len) scan_line();
+        line_len = 0;
+        in_comment = false;
+        line_start = scan_pos;
+      }
+      else if (c == ';' || c == '(')
+        in_comment = true;
+      else if (!in_comment && line_len < sizeof(line) - 1)
+        line[line_len++] = c;
+    }
+  }
+
+  if (++unsaved >= GCODE_INDEX_SAVE_BLOCKS && !save_header()) active = false;
+}
+
+#endif // SD_GCODE_INDEX
@@ -0,0 +1,122 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * sd/gcodeindex.h - Layer index of the printed file
+ *
+ * When a file is opened for printing it is scanned in the background, a
+ * block at a time from idle(), while the print goes on. The start of each
+ * layer is recorded in a file on the card with the E position, filament
+ * used and estimated print time up to that point.
+ *
+ * With the scan done, progress is reported by estimated time instead of
+ * file position, and 'M26 L' seeks straight to the start of a layer.
+ *
+ * The index is kept for the last file opened, identified by its first
+ * cluster, size and a CRC of its first block. A scan cut short, by closing
+ * the file or by a power loss, carries on from where it stopped.
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#include "SdFile.h"
+
+#define SD_GCODE_INDEX_FILE "GINDEX.BIN"
+
+// Where a layer starts in the file, and the state there
+typedef struct {
+  uint32_t offset;      // Start of the line moving to the layer
+  float z;              // Layer height
+  float e;              // E position in the file's own coordinates
+  float filament;       // Filament extruded before the layer (mm)
+  uint32_t time;        // Estimated print time before the layer (ms)
+  bool relative_e;      // The file uses relative E (M83) here
+} gcode_index_layer_t;
+
+// The scanner's state at the start of a line, kept to carry on after a reopen
+typedef struct {
+  float pos[XYZE];      // Position in the file's coordinates
+  float feedrate;       // (mm/s)
+  float layer_z;        // Height of the last recorded layer
+  float filament;       // Filament extruded so far (mm)
+  uint32_t time;        // Estimated time so far (ms)
+  bool relative_xyz, relative_e;
+  gcode_index_layer_t next; // The layer the last Z move may be starting
+} gcode_scan_state_t;
+
+// Stored in the first block of the index file
+typedef struct {
+  uint32_t magic;       // GCODE_INDEX_MAGIC, so an unused file is ignored
+  uint32_t cluster;     // First cluster of the indexed file
+  uint32_t size;        // Its size
+  uint16_t signature;   // CRC16 of its first block
+  uint16_t layers;      // Layers recorded
+  uint32_t scanned;     // Scan position, at the start of a line
+  bool complete;        // Scanned to the end
+  gcode_scan_state_t state;
+} gcode_index_header_t;
+
+class GCodeIndex {
+public:
+  static void reset();                          // Forget everything. Call on mount and release.
+  static void open();                           // Begin with the file just opened for printing
+  static void close();                          // The printed file is closed. Save the scan state.
+  static void task();                           // Scan a block, or follow the print. Call from idle().
+
+  static inline bool ready() { return active && head.complete; }
+  static inline uint16_t layers() { return active ? head.layers : 0; }
+  static bool layer(const uint16_t nr, gcode_index_layer_t &l);
+
+  static uint16_t permyriad();                  // Progress by estimated time. Only when ready().
+  static inline uint32_t total_time() { return head.state.time; }
+  static void report();                         // For 'M27 I'
+
+private:
+  static SdFile file, scan_file;
+  static gcode_index_header_t head;
+  static bool active;                           // The header belongs to the open file
+  static gcode_scan_state_t st;                 // Scanner state at line_start
+  static uint32_t scan_pos, line_start;
+  static float time_frac;                       // Milliseconds not yet added to st.time
+  static uint8_t line_len;
+  static bool in_comment;
+  static uint16_t unsaved;                      // Blocks scanned since the header was saved
+  static millis_t next_scan_ms;
+  static char line[96];                         // The line being scanned, without comments
+
+  // The layers on either side of the print position, for permyriad()
+  static bool located;
+  static uint32_t from_offset, to_offset, from_time, to_time;
+  static inline bool located_at(const uint32_t pos) {
+    return located && pos >= from_offset && (pos < to_offset || to_offset >= head.size);
+  }
+
+  static bool open_index();
+  static bool save_header();
+  static void add_layer();
+  static void scan_line();
+  static void add_time(const float ms);
+  static void track();
+};
+
+extern GCodeIndex gcode_index;
@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+#
+# binary_transfer.py
+#
+# Host side of BINARY_FILE_TRANSFER ('M28 B1') with BINARY_STREAM_WINDOW.
+#
+# Up to 'window' packets are sent ahead of the "ok"s, which are cumulative.
+# On "rs<n>" only packet n is sent again, since the firmware keeps the packets
+# that arrived after it. If no "ok" comes for a while the oldest one is resent.
+# Firmware without BINARY_STREAM_WINDOW reports no window and gets one at a time.
+#
+# Usage:
+#   binary_transfer.py send <port> <file> [name] [baud] [compress]
+#     Upload a file to the SD card. Needs pyserial, and heatshrink2 to compress.
+#     A port of '-' talks over stdin and stdout, as binary_stream_test does.
+#
+#   binary_transfer.py loopback [kbytes] [baud] [latency_us] [error_rate]
+#     Send through a model of the firmware receiver (RX buffer, packet slots,
+#     decode and SD write time) and print the effective KB/s for each window.
+#
+
+from __future__ import print_function
+import sys, os, struct, time, random
+from collections import deque
+
+TOKEN = 0xB5AD
+CONTROL, FILE_TRANSFER = 0, 1
+SYNC, CLOSE = 1, 2                                      # ProtocolControl
+PFT_QUERY, PFT_OPEN, PFT_CLOSE, PFT_WRITE, PFT_ABORT = range(5)
+
+def fletcher(cs, value):
+    low = ((cs & 0xFF) + value) % 255
+    return ((((cs >> 8) + low) % 255) << 8) | low
+
+def build_packet(sync, protocol, ptype, payload=b''):
+    head = struct.pack('<BBH', sync & 0xFF, (protocol << 4) | ptype, len(payload))
+    cs = 0
+    for b in bytearray(head): cs = fletcher(cs, b)
+    head += struct.pack('<H', cs)
+    for b in bytearray(head[4:]): cs = fletcher(cs, b)  # The full checksum includes the header checksum
+    out = struct.pack('<H', TOKEN) + head
+    if payload:
+        for b in bytearray(payload): cs = fletcher(cs, b)
+        out += payload + struct.pack('<H', cs)
+    return out
+
+class Sender:
+    """Windowed sender. Call send() to queue packets, poll() to get the bytes
+    to put on the wire, and line() with each line from the firmware."""
+
+    def __init__(self, window=1, timeout=0.5):
+        self.window = window
+        self.timeout = timeout
+        self.sync = 0                                   # Next sync id to use
+        self.todo = deque()                             # (protocol, type, payload) not sent yet
+        self.unacked = deque()                          # [sync, packet] in flight
+        self.resend = deque()                           # Packets asked for again
+        self.progress = 0
+        self.resends = 0
+        self.pft = deque()                              # PFT:... replies
+        self.synced = False
+        self.max_size = 0
+        self.failed = None
+
+    def send(self, protocol, ptype, payload=b''):
+        self.todo.append((protocol, ptype, payload))
+
+    def idle(self):
+        return not self.todo and not self.unacked
+
+    def poll(self, now):
+        if not self.unacked: self.progress = now
+        elif now - self.progress > self.timeout:        # Lost "ok", or a lost packet and "rs"
+            self.progress = now
+            self.resend.append(self.unacked[0][1])
+        out = []
+        while self.resend:
+            out.append(self.resend.popleft())
+            self.resends += 1
+        while self.todo and len(self.unacked) < self.window:
+            p = build_packet(self.sync, *self.todo.popleft())
+            self.unacked.append([self.sync, p])
+            self.sync = (self.sync + 1) & 0xFF
+            out.append(p)
+        return out
+
+    def _offset(self, n):
+        if not self.unacked: return None
+        off = (n - self.unacked[0][0]) & 0xFF
+        return off if off < len(self.unacked) else None
+
+    def line(self, text, now):
+        text = text.strip()
+        if text.startswith('ok'):
+            off = self._offset(int(text[2:]))
+            if off is not None:
+                for _ in range(off + 1): self.unacked.popleft()
+                self.progress = now
+        elif text.startswith('rs'):
+            off = self._offset(int(text[2:]))
+            if off is not None and self.unacked[off][1] not in self.resend:
+                self.resend.append(self.unacked[off][1])
+        elif text.startswith('ss'):
+            f = text[2:].split(',')
+            self.sync, self.max_size = int(f[0]), int(f[1])
+            self.window = int(f[3]) if len(f) > 3 else 1
+            self.synced = True
+        elif text.startswith('fe'):
+            self.failed = 'fatal stream error'
+        elif text.startswith('PFT:'):
+            self.pft.append(text[4:])
+
+#
+# Firmware model for the loopback test. Mirrors BinaryStream::receive().
+#
+
+class Receiver:
+    def __init__(self, window, buffer_size, reply):
+        self.window = window
+        self.buffer_size = buffer_size
+        self.reply = reply
+        self.sync = 0
+        self.slot = [None] * window                     # (meta, size) when ready
+        self.hole_reported = False
+        self.retries = 0
+        self.state = 'WAIT'
+        self.raw = bytearray()
+        self.received = []                              # (meta, payload) in dispatch order
+
+    def hole(self):
+        i = self.sync
+        while ((i - self.sync) & 0xFF) < self.window and self.slot[i % self.window]: i = (i + 1) & 0xFF
+        return i
+
+    def ready(self):
+        return self.slot[self.sync % self.window] is not None
+
+    def dispatch(self):
+        s = self.sync % self.window
+        meta, payload = self.slot[s]
+        self.reply('ok%d' % self.sync)
+        self.slot[s] = None
+        self.hole_reported = False
+        self.retries = 0
+        self.sync = (self.sync + 1) & 0xFF
+        self.received.append((meta, payload))
+        return meta, payload
+
+    def resend(self):
+        self.retries += 1
+        self.hole_reported = True
+        self.reply('rs%d' % self.hole())
+
+    def feed(self, b):
+        self.raw.append(b)
+        if self.state == 'WAIT':
+            if len(self.raw) >= 2 and struct.unpack('<H', bytes(self.raw[-2:]))[0] == TOKEN:
+                self.raw = bytearray(); self.state = 'HEADER'
+            return
+        if self.state == 'HEADER':
+            if len(self.raw) < 6: return
+            sync, meta, size, hcs = struct.unpack('<BBHH', bytes(self.raw))
+            cs = 0
+            for c in self.raw[:4]: cs = fletcher(cs, c)
+            if cs != hcs:
+                self.state = 'WAIT'; self.raw = bytearray(); self.resend(); return
+            for c in self.raw[4:]: cs = fletcher(cs, c)
+            self.cs, self.id, self.meta, self.size = cs, sync, meta, size
+            self.raw = bytearray()
+            if meta >> 4 == CONTROL and meta & 0xF == SYNC:
+                self.reply('ss%d,%d,0.%d.0%s' % (self.sync, self.buffer_size, 2 if self.window > 1 else 1, ',%d' % self.window if self.window > 1 else ''))
+                self.state = 'WAIT'; return
+            ahead, behind = (sync - self.sync) & 0xFF, (self.sync - sync) & 0xFF
+            self.state = 'WAIT'
+            if ahead < self.window:
+                if self.slot[sync % self.window] is None:
+                    if size: self.state = 'DATA'
+                    else: self.process(b'')
+            elif behind and behind <= self.window:
+                self.reply('ok%d' % sync)
+            elif not self.retries:
+                self.resend()
+            return
+        if self.state == 'DATA':
+            if len(self.raw) > self.buffer_size and len(self.raw) <= self.size:
+                self.reply('fe%d' % self.id); self.state = 'WAIT'; return
+            if len(self.raw) < self.size + 2: return
+            payload, fcs = bytes(self.raw[:self.size]), struct.unpack('<H', bytes(self.raw[self.size:]))[0]
+            cs = self.cs
+            for c in bytearray(payload): cs = fletcher(cs, c)
+            self.raw = bytearray(); self.state = 'WAIT'
+            if cs != fcs: self.resend()
+            else: self.process(payload)
+
+    def process(self, payload):
+        self.slot[self.id % self.window] = (self.meta, payload)
+        if not self.hole_reported and ((self.hole() - self.sync) & 0xFF) < ((self.id - self.sync) & 0xFF):
+            self.hole_reported = True
+            self.reply('rs%d' % self.hole())
+
+# Firmware timings
+RX_BUFFER_SIZE = 128
+MAX_CMD_SIZE = 96
+LOOP_US = 200                                           # Rest of the main loop between receive() calls
+DECODE_US_PER_BYTE = 1.5                                # heatshrink decode and copy
+BLOCK_WRITE_US = 1200                                   # One 512-byte SD block
+OPEN_CLOSE_US = 20000
+STEP_US = 5
+
+def loopback(data, window, baud, latency_us, error_rate, seed=1):
+    rng = random.Random(seed)
+    byte_us = 10.0 * 1000000 / baud
+    t = 0.0
+    to_fw = deque()                                     # (arrival, byte)
+    to_host = deque()                                   # (arrival, line)
+    rx = deque()
+    overruns = 0
+    fw = Receiver(window, MAX_CMD_SIZE, lambda s: to_host.append((t + latency_us, s)))
+    host = Sender(1, timeout=(20000 + 2 * latency_us) / 1e6)
+    wire_free = 0.0
+    busy_until = 0.0
+    written = 0
+
+    host.send(CONTROL, SYNC)
+    host.send(FILE_TRANSFER, PFT_OPEN, b'\0\0TEST.GCO\0')
+    chunks = [data[i:i + MAX_CMD_SIZE] for i in range(0, len(data), MAX_CMD_SIZE)]
+    phase = 'sync'
+    while True:
+        # Host
+        while to_host and to_host[0][0] <= t:
+            host.line(to_host.popleft()[1], t / 1e6)
+        if phase == 'sync' and host.synced:
+            # The SYNC packet has no sync id, so don't wait for an "ok"
+            host.unacked.clear(); phase = 'open'
+        if phase == 'open' and host.pft:
+            if host.pft.popleft() != 'success': raise RuntimeError('open failed')
+            for c in chunks: host.send(FILE_TRANSFER, PFT_WRITE, c)
+            host.send(FILE_TRANSFER, PFT_CLOSE)
+            phase = 'write'; start = t
+        if phase == 'write' and host.pft:
+            if host.pft.popleft() != 'success': raise RuntimeError('write failed')
+            return len(data) * 1000.0 / (t - start), host.resends, overruns
+        if host.failed: raise RuntimeError(host.failed)
+        for p in host.poll(t / 1e6):
+            for b in bytearray(p):
+                wire_free = max(wire_free, t) + byte_us
+                if rng.random() < error_rate: b ^= 1 << rng.randrange(8)
+                to_fw.append((wire_free + latency_us, b))
+        # Firmware: serial interrupt fills the RX buffer
+        while to_fw and to_fw[0][0] <= t:
+            b = to_fw.popleft()[1]
+            if len(rx) < RX_BUFFER_SIZE: rx.append(b)
+            else: overruns += 1
+        # Firmware: receive()
+        if busy_until <= t:
+            if fw.ready() and not rx:
+                meta, payload = fw.dispatch()
+                cost = 0
+                if meta == (FILE_TRANSFER << 4 | PFT_WRITE):
+                    cost = DECODE_US_PER_BYTE * len(payload)
+                    cost += BLOCK_WRITE_US * ((written + len(payload)) // 512 - written // 512)
+                    written += len(payload)
+                elif meta >> 4 == FILE_TRANSFER and meta & 0xF in (PFT_OPEN, PFT_CLOSE):
+                    cost = OPEN_CLOSE_US
+                    to_host.append((t + cost + latency_us, 'PFT:success'))
+                busy_until = t + cost
+            elif rx:
+                while rx: fw.feed(rx.popleft())
+            elif fw.state == 'WAIT':
+                busy_until = t + LOOP_US
+        t += STEP_US
+        if t > 600e6: raise RuntimeError('transfer stalled')
+
+class Pipe:
+    """stdin and stdout in place of a serial port, for a firmware built for the host."""
+    def __init__(self):
+        self.rx, self.tx = sys.stdin.fileno(), sys.stdout.fileno()
+        os.set_blocking(self.rx, False)
+
+    def write(self, data):
+        while data: data = data[os.write(self.tx, data):]
+
+    def read(self, n):
+        try: return os.read(self.rx, n)
+        except BlockingIOError: return b''
+
+def send(port, path, name, baud, compress):
+    data = open(path, 'rb').read()
+    if port == '-':
+        ser, out = Pipe(), sys.stderr
+    else:
+        import serial
+        ser, out = serial.Serial(port, baud, timeout=0), sys.stdout
+    host = Sender()
+    buf = b''
+    def pump(until=None):
+        nonlocal buf
+        while True:
+            now = time.monotonic()
+            for p in host.poll(now): ser.write(p)
+            buf += ser.read(256)
+            while b'\n' in buf:
+                text, buf = buf.split(b'\n', 1)
+                host.line(text.decode('ascii', 'replace'), now)
+            if host.failed: raise RuntimeError(host.failed)
+            if until(): return
+            time.sleep(0.0005)
+
+    ser.write(b'M28 B1\n')
+    time.sleep(0.1)
+    host.send(CONTROL, SYNC)
+    pump(lambda: host.synced)
+    host.unacked.clear()
+    print('window %d, packet %d bytes' % (host.window, host.max_size), file=out)
+
+    if compress:
+        import heatshrink2
+        host.send(FILE_TRANSFER, PFT_QUERY)
+        pump(lambda: host.pft)
+        f = host.pft.popleft().split(':')[-1].split(',')
+        data = heatshrink2.compress(data, window_sz2=int(f[1]), lookahead_sz2=int(f[2]))
+
+    host.send(FILE_TRANSFER, PFT_OPEN, struct.pack('BB', 0, 1 if compress else 0) + name.encode() + b'\0')
+    pump(lambda: host.pft)
+    if host.pft.popleft() != 'success': raise RuntimeError('open failed')
+
+    start = time.monotonic()
+    size = host.max_size
+    for i in range(0, len(data), size): host.send(FILE_TRANSFER, PFT_WRITE, data[i:i + size])
+    host.send(FILE_TRANSFER, PFT_CLOSE)
+    pump(lambda: host.pft)
+    result = host.pft.popleft()
+    secs = time.monotonic() - start
+    host.send(CONTROL, CLOSE)
+    pump(lambda: host.idle())
+    print('%s: %d bytes in %.2f s, %.1f KB/s, %d resent' % (result, os.path.getsize(path), secs, os.path.getsize(path) / 1024.0 / secs, host.resends), file=out)
+    return 0 if result == 'success' else 1
+
+def main(argv):
+    if len(argv) > 2 and argv[1] == 'send':
+        name = argv[4] if len(argv) > 4 else os.path.basename(argv[3]).upper()
+        baud = int(argv[5]) if len(argv) > 5 else 250000
+        return send(argv[2], argv[3], name, baud, len(argv) > 6 and argv[6] != '0')
+    if len(argv) > 1 and argv[1] == 'loopback':
+        kbytes     = int(argv[2]) if len(argv) > 2 else 32
+        baud       = int(argv[3]) if len(argv) > 3 else 250000
+        latency_us = int(argv[4]) if len(argv) > 4 else 1000
+        error_rate = float(argv[5]) if len(argv) > 5 else 0.0
+        data = bytes(bytearray(random.Random(0).randrange(256) for _ in range(kbytes * 1024)))
+        print('%d KB, %d baud, latency %d us, byte error rate %g' % (kbytes, baud, latency_us, error_rate))
+        print('%8s %10s %8s %9s' % ('window', 'KB/s', 'resent', 'overruns'))
+        for window in (1, 2, 4, 8):
+            rate, resent, overruns = loopback(data, window, baud, latency_us, error_rate)
+            print('%8d %10.2f %8d %9d' % (window, rate, resent, overruns))
+        return 0
+    print(__doc__ or open(__file__).read().split('\n\n')[0])
+    return 1
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+#
+# gcode_to_binary.py
+#
+# Encode G-code lines as BINARY_GCODE frames for Marlin.
+# See Marlin/src/feature/binary_gcode.h for the frame format.
+#
+# Lines that can't be framed (comments, strings, file names, etc.)
+# are passed through as text, so the output is always printable.
+#
+# Usage:
+#   gcode_to_binary.py input.gcode output.gco   Encode a file for SD printing
+#   gcode_to_binary.py --verify input.gcode     Check that every line round-trips
+#
+# From a host, frame single lines with encode_line(line, line_number).
+#
+
+from __future__ import print_function
+import re, sys
+
+SYNC = 0xA5
+MAX_DECIMALS = 6
+MAX_MANTISSA = (1 << 28) - 1
+
+# Commands whose parameters are strings, never framed
+STRING_CODES = { ('M', 23), ('M', 28), ('M', 30), ('M', 32), ('M', 117), ('M', 118), ('M', 928) }
+
+PARAM_RE = re.compile(r'([A-Z])([-+]?(?:\d+\.?\d*|\.\d+))?$')
+
+def crc16(data, crc=0):
+    # CCITT, as in Marlin/src/libs/crc16.cpp
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+def varint(v):
+    out = bytearray()
+    while True:
+        b = v & 0x7F
+        v >>= 7
+        if v:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return out
+
+def strip_comments(line):
+    line = line.split(';', 1)[0]
+    line = re.sub(r'\([^)]*\)', '', line)
+    return line.strip()
+
+def split_params(text):
+    # Split "G1X10Y-2.5 E.3" into ['G1', 'X10', 'Y-2.5', 'E.3']
+    return re.findall(r'[A-Z][^A-Z]*', text.replace(' ', ''))
+
+def number_to_fixed(num):
+    sign = -1 if num.startswith('-') else 1
+    num = num.lstrip('+-')
+    ipart, _, fpart = num.partition('.')
+    if len(fpart) > MAX_DECIMALS: return None
+    mantissa = int((ipart or '0') + fpart)
+    if mantissa > MAX_MANTISSA: return None
+    return sign * mantissa, len(fpart)
+
+def encode_line(line, line_number=None):
+    """ Return the binary frame for a line, or None to send it as text. """
+    text = strip_comments(line)
+    if not text or text != text.upper(): return None
+    words = split_params(text)
+    if not words: return None
+
+    head = re.match(r'([GMT])(\d+)(?:\.(\d))?$', words[0])
+    if not head: return None
+    letter, code, sub = head.group(1), int(head.group(2)), int(head.group(3) or 0)
+    if (letter, code) in STRING_CODES: return None
+
+    mask, values = 0, {}
+    for w in words[1:]:
+        m = PARAM_RE.match(w)
+        if not m or m.group(1) == 'N': return None
+        bit = ord(m.group(1)) - ord('A')
+        if mask & (1 << bit): return None       # Repeated parameter
+        mask |= 1 << bit
+        if m.group(2) is None:
+            values[bit] = 7
+        else:
+            fixed = number_to_fixed(m.group(2))
+            if fixed is None: return None
+            mant, dec = fixed
+            zz = (mant << 1) ^ (mant >> 31) if mant >= 0 else ((-mant) << 1) - 1
+            values[bit] = (zz << 3) | dec
+
+    payload = bytearray([ord(letter) | (0x80 if line_number is not None else 0)])
+    if line_number is not None: payload += varint(line_number)
+    payload += varint(code * 10 + sub)
+    payload += bytes(bytearray([(mask >> s) & 0xFF for s in (0, 8, 16, 24)]))
+    for bit in sorted(values): payload += varint(values[bit])
+    if len(payload) > 255: return None
+
+    body = bytearray([len(payload)]) + payload
+    crc = crc16(body)
+    return bytes(bytearray([SYNC]) + body + bytearray([crc & 0xFF, crc >> 8]))
+
+def decode_frame(frame):
+    """ Expand a frame to text, the same way the firmware does. """
+    if frame[0] != SYNC: raise ValueError('no sync')
+    length = frame[1]
+    body = frame[1:2 + length]
+    crc = frame[2 + length] | (frame[3 + length] << 8)
+    if crc16(body) != crc: raise ValueError('bad crc')
+    p = bytearray(frame[2:2 + length])
+    pos = [0]
+
+    def get_varint():
+        v, shift = 0, 0
+        while True:
+            b = p[pos[0]]; pos[0] += 1
+            v |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80: return v
+
+    letter = p[0]; pos[0] = 1
+    out = ''
+    if letter & 0x80: out = 'N%d ' % get_varint()
+    code = get_varint()
+    out += chr(letter & 0x7F) + str(code // 10)
+    if code % 10: out += '.%d' % (code % 10)
+    mask = p[pos[0]] | (p[pos[0] + 1] << 8) | (p[pos[0] + 2] << 16) | (p[pos[0] + 3] << 24)
+    pos[0] += 4
+    for bit in range(26):
+        if not mask & (1 << bit): continue
+        v = get_varint()
+        out += ' ' + chr(ord('A') + bit)
+        if (v & 7) == 7: continue
+        dec, zz = v & 7, v >> 3
+        mant = (zz >> 1) ^ -(zz & 1)
+        s = str(abs(mant)).rjust(dec + 1, '0')
+        out += ('-' if mant < 0 else '') + (s[:-dec] + '.' + s[-dec:] if dec else s)
+    if letter & 0x80:
+        cs = 0
+        for ch in out: cs ^= ord(ch)
+        out += '*%d' % cs
+    return out
+
+def normalize(line):
+    """ The text a line is expected to expand to. Parameters come out in letter order. """
+    words = split_params(strip_comments(line))
+    out = [words[0]]
+    for w in sorted(words[1:]):
+        m = PARAM_RE.match(w)
+        if m.group(2) is None:
+            out.append(m.group(1))
+        else:
+            mant, dec = number_to_fixed(m.group(2))
+            s = str(abs(mant)).rjust(dec + 1, '0')
+            out.append(m.group(1) + ('-' if mant < 0 else '') + (s[:-dec] + '.' + s[-dec:] if dec else s))
+    head = re.match(r'([GMT])(\d+)(?:\.(\d))?$', out[0])
+    out[0] = head.group(1) + str(int(head.group(2))) + ('.' + head.group(3) if head.group(3) and head.group(3) != '0' else '')
+    return ' '.join(out)
+
+def main(argv):
+    if len(argv) == 3 and argv[1] == '--verify':
+        text_bytes = bin_bytes = framed = 0
+        with open(argv[2]) as f:
+            for n, line in enumerate(f, 1):
+                frame = encode_line(line)
+                text_bytes += len(line)
+                if frame is None:
+                    bin_bytes += len(line)
+                    continue
+                framed += 1
+                bin_bytes += len(frame)
+                if decode_frame(frame) != normalize(line):
+                    print('Line %d: "%s" != "%s"' % (n, decode_frame(frame), normalize(line)))
+                    return 1
+        print('%d lines framed, %d -> %d bytes' % (framed, text_bytes, bin_bytes))
+        return 0
+
+    if len(argv) == 3:
+        with open(argv[1]) as fin, open(argv[2], 'wb') as fout:
+            for line in fin:
+                frame = encode_line(line)
+                if frame is not None:
+                    fout.write(frame)
+                elif strip_comments(line):
+                    fout.write((strip_comments(line) + '\n').encode())
+        return 0
+
+    print('Usage: gcode_to_binary.py input.gcode output.gco | --verify input.gcode')
+    return 2
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
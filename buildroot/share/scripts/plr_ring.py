@@ -0,0 +1,274 @@
+#!/usr/bin/env python3
+#
+# plr_ring.py
+#
+# Format model and dump reader for POWER_LOSS_RING_W25QXX / POWER_LOSS_RING_BL24CXX.
+#
+# This is a Python model of the ring format and of the order in which
+# feature/powerloss.cpp writes and erases sectors. It doesn't run the firmware
+# code, so a change to one must be made to the other by hand.
+#
+# 'test' runs the model on a RAM flash emulator: NOR flash only clears bits
+# when programming, an erase sets a sector to 0xFF and may be cut short, and
+# power is cut at random points. After every cut the ring must load the last
+# completed save, or the one being written when it was cut. A save must never
+# program bytes that weren't erased, nor erase a sector itself.
+#
+# 'dump' lists the sectors of a ring read from the board (e.g. from an M993
+# flash backup), with the snapshot generation and number of good records.
+#
+# Usage:
+#   plr_ring.py test [seed] [jobs] [eeprom]
+#   plr_ring.py dump <file> <info_size> <record_size> [addr] [sectors] [sector_size]
+#
+# 'info_size' and 'record_size' are sizeof(job_recovery_info_t) and
+# sizeof(job_recovery_record_t) in the firmware build.
+#
+
+from __future__ import print_function
+import random
+import struct
+import sys
+
+RECORD_SIZE = 64
+HEADER = struct.Struct('<HHI')                  # crc, size, gen
+RECORD = struct.Struct('<HHI')                  # crc, feedrate, gen, then the rest
+PAYLOAD = RECORD_SIZE - RECORD.size
+GEN_NONE = 0xFFFFFFFF
+
+def crc16(data, crc=0):
+    for b in bytearray(data):
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+class PowerCut(Exception):
+    pass
+
+class Flash:
+    """RAM emulator. Writes past 'budget' bytes are lost."""
+    def __init__(self, size, eeprom):
+        self.eeprom = eeprom
+        self.mem = bytearray(random.getrandbits(8) for _ in range(size))
+        self.budget = -1
+        self.programs = self.erases = self.dirty = 0
+
+    def read(self, addr, n):
+        return bytes(self.mem[addr:addr + n])
+
+    def program(self, addr, data):
+        self.programs += 1
+        for i, b in enumerate(bytearray(data)):
+            if self.budget == 0: raise PowerCut()
+            if self.budget > 0: self.budget -= 1
+            if self.eeprom: self.mem[addr + i] = b
+            else:
+                if b & ~self.mem[addr + i]: self.dirty += 1   # A bit that needed an erase
+                self.mem[addr + i] &= b
+
+    def erase(self, addr, n):
+        if self.eeprom: return                  # Bytes are simply overwritten
+        self.erases += 1
+        if self.budget == 0: raise PowerCut()
+        if self.budget > 0 and random.random() < 0.25:
+            for i in range(n): self.mem[addr + i] |= random.getrandbits(8)
+            raise PowerCut()
+        self.mem[addr:addr + n] = b'\xFF' * n
+
+class Ring:
+    """The ring format of feature/powerloss.cpp, with the info as bytes."""
+    def __init__(self, flash, info_size, addr, sectors, sector_size, record_bytes=RECORD_SIZE):
+        self.f, self.info_size, self.record_bytes = flash, info_size, record_bytes
+        self.addr, self.sectors, self.sector_size = addr, sectors, sector_size
+        self.records_pos = (HEADER.size + info_size + RECORD_SIZE - 1) // RECORD_SIZE * RECORD_SIZE
+        self.records = (sector_size - self.records_pos) // RECORD_SIZE
+        assert self.records >= 2, "info too big for a sector"
+        self.count = None                       # None before the first save of a job
+        self.saving = False
+        self.sector = self.gen = 0
+        self.base = None
+
+    def sector_addr(self, s): return self.addr + s * self.sector_size
+    def next_sector(self, s): return (s + 1) % self.sectors
+
+    def erase_next(self):
+        assert not self.saving, "a save erased a sector"
+        self.f.erase(self.sector_addr(self.next_sector(self.sector)), self.sector_size)
+    def record_addr(self, s, nr): return self.sector_addr(s) + self.records_pos + nr * RECORD_SIZE
+
+    def check(self, s):
+        a = self.sector_addr(s)
+        crc, size, gen = HEADER.unpack(self.f.read(a, HEADER.size))
+        ok = size == self.info_size and crc == crc16(self.f.read(a + 2, HEADER.size - 2 + self.info_size))
+        return ok, size, gen
+
+    def scan(self):
+        found, found_gen, newest = -1, 0, 0
+        for s in range(self.sectors):
+            ok, size, gen = self.check(s)
+            if ok:
+                if found < 0 or gen > found_gen: found, found_gen = s, gen
+            elif size and size != self.info_size:
+                continue
+            if gen != GEN_NONE: newest = max(newest, gen)
+        return found, newest
+
+    def exists(self):
+        return self.scan()[0] >= 0
+
+    def read_record(self, s, nr):
+        raw = self.f.read(self.record_addr(s, nr), self.record_bytes)
+        crc, feedrate, gen = RECORD.unpack(raw[:RECORD.size])
+        return crc == crc16(raw[2:]), gen, raw[RECORD.size:]
+
+    def prepare(self):
+        """Job start: follow on from the ring and erase the first snapshot's sector."""
+        s, self.gen = self.scan()
+        self.sector = self.sectors - 1 if s < 0 else s
+        self.count = self.records               # The next save starts the next sector
+        self.erase_next()
+
+    def write(self, base, payload):
+        """Save an info made of 'base' bytes (rarely changing) and a record payload."""
+        if self.count is not None and self.count < self.records and base == self.base:
+            rec = RECORD.pack(0, 0, self.gen)[2:] + payload
+            self.f.program(self.record_addr(self.sector, self.count), struct.pack('<H', crc16(rec)) + rec)
+            self.count += 1
+            return True
+
+        if self.count is None: self.prepare()   # Saved with no prepare, as by M413 W
+
+        self.sector = self.next_sector(self.sector)
+        a = self.sector_addr(self.sector)
+        info = base + payload
+        head = HEADER.pack(0, self.info_size, self.gen + 1)[2:]
+        self.saving = True
+        self.f.program(a, struct.pack('<H', crc16(head + info)) + head)
+        self.f.program(a + HEADER.size, info)
+        self.saving = False
+
+        ok, _, gen = self.check(self.sector)
+        self.erase_next()                       # Get the next sector ready
+        self.gen += 1
+        if not ok or gen != self.gen:
+            self.count = self.records           # Go on to the next sector
+            return False
+        self.count, self.base = 0, base
+        return True
+
+    def load(self):
+        self.count = None
+        s, _ = self.scan()
+        if s < 0: return None
+        _, _, gen = self.check(s)
+        a = self.sector_addr(s) + HEADER.size
+        info = self.f.read(a, self.info_size)
+        base, payload = info[:-PAYLOAD], info[-PAYLOAD:]
+        nr = 0
+        while nr < self.records:
+            ok, rgen, p = self.read_record(s, nr)
+            if not ok or rgen != gen: break
+            payload = p
+            nr += 1
+        return base + payload
+
+    def purge(self):
+        for s in range(self.sectors):
+            if self.check(s)[0]:
+                self.f.program(self.sector_addr(s) + 2, b'\0\0')
+        self.count = None
+
+def test(seed, jobs, eeprom):
+    random.seed(seed)
+    info_size = 96
+    if eeprom: sectors, sector_size, addr, size = 2, 512, 1024, 2048
+    else: sectors, sector_size, addr, size = 16, 4096, 0, 16 * 4096
+    flash = Flash(size, eeprom)
+    fails = cuts = exact = torn = 0
+    base = bytes(info_size - PAYLOAD)
+    for job in range(jobs):
+        ring = Ring(flash, info_size, addr, sectors, sector_size)   # Reboot
+        if random.random() < 0.8:
+            try:
+                ring.prepare()                  # M24
+            except PowerCut:
+                pass
+        last = None
+        steps = random.randint(1, 3 * ring.records * sectors)
+        cut_at = random.randrange(steps) if random.random() < 0.7 else -1
+        for k in range(steps):
+            if random.random() < 0.05: base = bytes(random.getrandbits(8) for _ in range(len(base)))
+            cur = base + bytes(random.getrandbits(8) for _ in range(PAYLOAD))
+            if k == cut_at:
+                flash.budget = random.randrange(700)
+                cuts += 1
+            try:
+                ring.write(cur[:-PAYLOAD], cur[-PAYLOAD:])
+            except PowerCut:
+                pass
+            if flash.budget < 0:
+                last = cur
+                continue
+            flash.budget = -1
+            got = Ring(flash, info_size, addr, sectors, sector_size).load()
+            if got == cur: exact += 1
+            elif last is None or got == last: torn += 1     # An older job may show if the first save was lost
+            else:
+                fails += 1
+                print("FAIL job %d step %d" % (job, k))
+            last = None
+            break
+        if last is not None:
+            ring = Ring(flash, info_size, addr, sectors, sector_size)
+            if ring.load() != last:
+                fails += 1
+                print("FAIL reload job %d" % job)
+            if random.random() < 0.5:
+                ring.purge()
+                if ring.exists():
+                    fails += 1
+                    print("FAIL purge job %d" % job)
+    if flash.dirty:
+        fails += 1
+        print("FAIL %d bytes programmed without an erase" % flash.dirty)
+    print("%s: fails=%d cuts=%d exact=%d torn=%d programs=%d erases=%d" % (
+        'eeprom' if eeprom else 'flash', fails, cuts, exact, torn, flash.programs, flash.erases))
+    return fails
+
+def dump(path, info_size, record_bytes, addr, sectors, sector_size):
+    with open(path, 'rb') as f: data = f.read()
+    flash = Flash(0, False)
+    flash.mem = bytearray(data)
+    ring = Ring(flash, info_size, addr, sectors, sector_size, record_bytes)
+    newest, _ = ring.scan()
+    for s in range(sectors):
+        ok, size, gen = ring.check(s)
+        if size == 0xFFFF and gen == GEN_NONE:
+            print("%2d  erased" % s)
+            continue
+        nr = 0
+        while ok and nr < ring.records:
+            rok, rgen, _ = ring.read_record(s, nr)
+            if not rok or rgen != gen: break
+            nr += 1
+        state = 'good' if ok else 'purged' if size == 0 else 'bad'
+        print("%2d  gen %-10d %-6s records %d%s" % (s, gen, state, nr, '  <- newest' if s == newest else ''))
+
+def main(argv):
+    if len(argv) > 1 and argv[1] == 'test':
+        seed = int(argv[2]) if len(argv) > 2 else 1
+        jobs = int(argv[3]) if len(argv) > 3 else 100
+        eeprom = len(argv) > 4 and argv[4] == 'eeprom'
+        return 1 if test(seed, jobs, eeprom) else 0
+    if len(argv) > 4 and argv[1] == 'dump':
+        num = lambda i, d: int(argv[i], 0) if len(argv) > i else d
+        dump(argv[2], int(argv[3], 0), int(argv[4], 0), num(5, 0), num(6, 16), num(7, 4096))
+        return 0
+    print("Usage: plr_ring.py test [seed] [jobs] [eeprom]")
+    print("       plr_ring.py dump <file> <info_size> <record_size> [addr] [sectors] [sector_size]")
+    return 2
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+#
+# serial_credit_sim.py
+#
+# Compare "ok" ping-pong against CREDIT_FLOW_CONTROL (M577 S1) streaming.
+#
+# A step-by-step model of the firmware side (RX buffer, command queue,
+# per-command service time) and a host on a link with a given one-way
+# latency, e.g. USB polling, a network bridge, or a WiFi module.
+#
+# Usage:
+#   serial_credit_sim.py [line_bytes] [service_us] [bufsize] [window]
+#
+# Prints lines per second for each latency. Set 'window' to CREDIT_WINDOW.
+#
+
+from __future__ import print_function
+import sys
+from collections import deque
+
+BAUD = 250000
+RX_BUFFER_SIZE = 128
+STEP_US = 10
+LINES = 2000
+
+def simulate(latency_us, line_bytes, service_us, bufsize, window, credit):
+    byte_us = 10.0 * 1000000 / BAUD             # 8N1
+    to_fw = deque()                             # (arrival_time, bytes) on the wire
+    to_host = deque()                           # (arrival_time, credit or None for ok)
+    rx = 0                                      # Bytes in the firmware RX buffer
+    partial = 0                                 # Bytes of the line being read
+    queue = 0                                   # Commands in the firmware queue
+    busy_until = 0
+    sent = done = 0
+    in_flight = 0                               # Host's idea of unacknowledged bytes/lines
+    wire_free = 0
+    t = 0
+    while done < LINES:
+        # Host: receive acknowledgements
+        while to_host and to_host[0][0] <= t:
+            c = to_host.popleft()[1]
+            in_flight -= c if credit else 1
+        # Host: send while the window (or the single ok slot) allows
+        while sent < LINES and wire_free <= t and (in_flight + line_bytes <= window if credit else in_flight == 0):
+            wire_free = max(wire_free, t) + line_bytes * byte_us
+            to_fw.append((wire_free + latency_us, line_bytes))
+            in_flight += line_bytes if credit else 1
+            sent += 1
+        # Firmware: bytes arriving
+        while to_fw and to_fw[0][0] <= t:
+            rx += to_fw.popleft()[1]
+            if rx > RX_BUFFER_SIZE: raise RuntimeError('RX overrun, window too large')
+        # Firmware: get_serial_commands reads only while the queue has room
+        read = 0
+        while rx and queue < bufsize:
+            rx -= 1; read += 1; partial += 1
+            if partial == line_bytes:
+                partial = 0; queue += 1
+                if not credit: to_host.append((t + latency_us, None))
+        if credit and read: to_host.append((t + latency_us, read))
+        # Firmware: execute
+        if queue and busy_until <= t:
+            queue -= 1; done += 1
+            busy_until = t + service_us
+        t += STEP_US
+    return LINES * 1000000.0 / t
+
+def main(argv):
+    line_bytes = int(argv[1]) if len(argv) > 1 else 24
+    service_us = int(argv[2]) if len(argv) > 2 else 500
+    bufsize    = int(argv[3]) if len(argv) > 3 else 4
+    window     = int(argv[4]) if len(argv) > 4 else 127
+    print('line %d bytes, service %d us, BUFSIZE %d, window %d' % (line_bytes, service_us, bufsize, window))
+    print('%10s %12s %12s' % ('latency', 'ok lines/s', 'credit lines/s'))
+    for latency_ms in (0, 1, 2, 5, 10, 20):
+        lat = latency_ms * 1000
+        ok = simulate(lat, line_bytes, service_us, bufsize, window, False)
+        cr = simulate(lat, line_bytes, service_us, bufsize, window, True)
+        print('%8d ms %12.0f %12.0f' % (latency_ms, ok, cr))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
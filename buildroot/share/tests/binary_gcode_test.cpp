@@ -0,0 +1,162 @@
+/**
+ * Host test - binary_gcode_test.cpp
+ *
+ * binary_gcode_test.gcode goes through gcode_to_binary.py, as a file for SD
+ * printing and as numbered lines from a host. The frames are expanded by
+ * BinaryGCode a byte at a time, as the queue feeds them, and every command
+ * must parse the same as its text line: the same code, and the same value
+ * for each parameter.
+ *
+ * The lines the script leaves as text come through as text. A frame with
+ * any one bit flipped is rejected, and expands when it is sent again.
+ *
+ * config: opt_enable BINARY_GCODE
+ * config: opt_enable BINARY_GCODE PREPARSED_GCODE_VALUES
+ * config: opt_enable BINARY_GCODE; opt_disable FASTER_GCODE_PARSER
+ * sources: feature/binary_gcode.cpp gcode/parser.cpp libs/crc16.cpp
+ * input: python3 ../scripts/gcode_to_binary.py binary_gcode_test.gcode "$srcdir/../test.gco" && cat binary_gcode_test.gcode && echo @@@@ && cat "$srcdir/../test.gco" && echo @@@@ && python3 -c "import sys; sys.path.insert(0, '../scripts'); import gcode_to_binary as g; sys.stdout.buffer.write(b''.join(g.encode_line(l, n) or b'' for n, l in enumerate(open('binary_gcode_test.gcode'), 1)))"
+ */
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iterator>
+
+#include "gcode/parser.h"
+#include "feature/binary_gcode.h"
+
+static int failures;
+#define CHECK(C, V...) do{ if (!(C)) { failures++; printf("FAIL %s:%d %s ", __FILE__, __LINE__, #C); printf(V); printf("\n"); } }while(0)
+
+// What the parser made of a line
+struct parsed_t {
+  char letter;
+  int codenum, subcode;
+  struct { bool seen, has_value; float f; int32_t l; } param[26];
+  bool operator==(const parsed_t &o) const {
+    if (letter != o.letter || codenum != o.codenum || subcode != o.subcode) return false;
+    for (uint8_t i = 0; i < 26; i++) {
+      const auto &a = param[i], &b = o.param[i];
+      if (a.seen != b.seen || a.has_value != b.has_value) return false;
+      if (a.has_value && (a.f != b.f || a.l != b.l)) return false;
+    }
+    return true;
+  }
+};
+
+static parsed_t parse(std::string line) {
+  parsed_t p;
+  memset(&p, 0, sizeof(p));
+  std::vector<char> buf(line.begin(), line.end());
+  buf.push_back('\0');
+  parser.parse(buf.data());
+  p.letter = parser.command_letter;
+  p.codenum = parser.codenum;
+  p.subcode = TERN0(USE_GCODE_SUBCODES, parser.subcode);
+  if (p.letter == '?') return p;    // Not a command, and the parameters are left from the last one
+  for (uint8_t i = 0; i < 26; i++) {
+    auto &v = p.param[i];
+    if (i == 'N' - 'A' || !(v.seen = parser.seen('A' + i))) continue;
+    if ((v.has_value = parser.has_value())) { v.f = parser.value_float(); v.l = parser.value_long(); }
+  }
+  return p;
+}
+
+// A text line as the queue passes it to the parser
+static std::string text_command(std::string line) {
+  line = line.substr(0, line.find(';'));
+  while (!line.empty() && (line.back() == ' ' || line.back() == '\r')) line.pop_back();
+  return line;
+}
+
+// Lines gcode_to_binary.py drops from a file: those with only comments
+static bool has_command(std::string line) {
+  line = text_command(line);
+  for (size_t i; (i = line.find('(')) != std::string::npos; )
+    line.erase(i, line.find(')', i) == std::string::npos ? std::string::npos : line.find(')', i) - i + 1);
+  return line.find_first_not_of(' ') != std::string::npos;
+}
+
+// Expand the frame at 'pos', as the queue does, leaving 'pos' after it
+static BinaryGCode::Status expand(BinaryGCode &frame, const std::string &in, size_t &pos, std::string &out) {
+  char buf[MAX_CMD_SIZE];
+  int ind = 0;
+  BinaryGCode::Status s = BinaryGCode::BGC_MORE;
+  while (pos < in.size() && s == BinaryGCode::BGC_MORE)
+    s = frame.feed(uint8_t(in[pos++]), buf, ind);
+  out.assign(buf, ind);
+  return s;
+}
+
+int main() {
+  const std::string in((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+
+  // The text lines
+  size_t pos = in.find("@@@@\n");
+  CHECK(pos != std::string::npos, "no text");
+  if (failures) return 1;
+  std::vector<std::string> lines;
+  for (size_t i = 0, e; i < pos; i = e + 1) {
+    e = in.find('\n', i);
+    lines.push_back(in.substr(i, e - i));
+  }
+  pos += 5;
+
+  // The file, with a frame or a text line for each command
+  BinaryGCode frame;
+  uint32_t framed = 0, text = 0, bytes = 0;
+  std::vector<bool> was_framed(lines.size());
+  const size_t file_start = pos;
+  for (size_t n = 0; n < lines.size(); n++) {
+    if (!has_command(lines[n])) continue;
+    const std::string want = text_command(lines[n]);
+    std::string got;
+    if (uint8_t(in[pos]) == BinaryGCode::SYNC) {
+      const size_t start = pos;
+      CHECK(expand(frame, in, pos, got) == BinaryGCode::BGC_DONE, "line %u \"%s\" didn't expand", unsigned(n + 1), want.c_str());
+      framed++;
+      was_framed[n] = true;
+
+      // Flip one bit of the frame. No part of it may expand, and sent again it must.
+      std::string bad = in.substr(start, pos - start), again;
+      const size_t bit = rand() % (bad.size() * 8);
+      bad[bit / 8] ^= 1 << (bit % 8);
+      for (size_t p = 0; p < bad.size();)
+        CHECK(expand(frame, bad, p, again) != BinaryGCode::BGC_DONE, "line %u with bit %u flipped gave \"%s\"", unsigned(n + 1), unsigned(bit), again.c_str());
+      frame.reset();
+      size_t p = start;
+      CHECK(expand(frame, in, p, again) == BinaryGCode::BGC_DONE && again == got, "line %u sent again gave \"%s\"", unsigned(n + 1), again.c_str());
+    }
+    else {
+      const size_t e = in.find('\n', pos);
+      got = in.substr(pos, e - pos);
+      pos = e + 1;
+      text++;
+    }
+    CHECK(parse(got) == parse(want), "line %u \"%s\" parsed as \"%s\"", unsigned(n + 1), want.c_str(), got.c_str());
+  }
+  bytes = pos - file_start;
+  CHECK(in.compare(pos, 5, "@@@@\n") == 0, "the file goes on after the last line");
+  pos += 5;
+
+  // Numbered frames from a host, for the lines that frame
+  uint32_t numbered = 0;
+  for (size_t n = 0; n < lines.size(); n++) {
+    if (!was_framed[n]) continue;
+    std::string got;
+    CHECK(expand(frame, in, pos, got) == BinaryGCode::BGC_DONE, "numbered line %u didn't expand", unsigned(n + 1));
+    const std::string head = "N" + std::to_string(n + 1) + " ";
+    const size_t star = got.rfind('*');
+    uint8_t cs = 0;
+    for (size_t i = 0; i < star && star != std::string::npos; i++) cs ^= got[i];
+    CHECK(got.compare(0, head.size(), head) == 0 && star != std::string::npos && got.substr(star + 1) == std::to_string(cs),
+          "numbered line %u expanded to \"%s\"", unsigned(n + 1), got.c_str());
+    CHECK(parse(got) == parse(text_command(lines[n])), "numbered line %u \"%s\" parsed as \"%s\"", unsigned(n + 1), lines[n].c_str(), got.c_str());
+    numbered++;
+  }
+  CHECK(pos == in.size(), "%u bytes after the numbered frames", unsigned(in.size() - pos));
+  CHECK(numbered > 200, "only %u numbered frames", numbered);
+
+  printf("  %u lines framed, %u as text, %u bytes\n", framed, text, bytes);
+  printf("%s\n", failures ? "FAILED" : "passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,299 @@
+;
+; Lines for binary_gcode_test.cpp: each one is framed by gcode_to_binary.py, or
+; passed through as text, and must parse the same either way.
+;
+M73 P0 R12
+M140 S60
+M104 S200 T0
+M190 S60
+M109 R215.5
+G28 ; home all axes
+G29 L10 R190 F10 B190
+G21
+G90
+M82
+G92 E0
+G1 Z2.0 F3000
+G1 X0.1 Y20 Z0.3 F5000.0
+G1 X0.1 Y200.0 Z0.3 F1500.0 E15
+G1 X.4 Y+200 E-.5
+G1 X-0 Y-0.000 Z0.000001
+G1 X-12.5 Y-0.25 E-1.234567
+G1 E-1.2345678
+G1 X268435455 Y-268435455
+G1 X268435456
+G1 X007 Y00.50 F0010
+G1 E3.
+G0 F9000 X10Y10
+G0X1Y2Z3
+G1 X1 Y2 X3
+M106 S255
+M106 P1 S127.5
+M107
+M400
+M204 P500 R1000 T500
+M205 X8.00 Y8.00 Z0.40 E5.00
+M220 S100
+M221 S95
+M82
+M84 X Y E
+M851 Z-1.25
+M500
+M117 Printing...
+M118 E1 done
+M23 /FOLDER/FILE.GCO
+M28 NEW.GCO
+G1 X10 (a paren comment) Y20
+g1 x10 y20
+T0
+T1
+T0 S1
+G29.1
+G38.2 Z-10 F100
+G5 I0 J10 P5 Q-5 X10 Y10
+G2 X10 Y10 I5 J5 E1.5 F1200
+G3 X0 Y0 R5
+G10
+G11
+G92.1
+M900 K0.06
+M593 F40.7 D0.1
+M201 X500 Y500 Z100 E5000
+M203 X500 Y500 Z20 E100
+M92 E93.000
+M290 Z0.01
+M290 Z-0.005
+M355 S1 P255
+M600 X0 Y0 Z10 E-2 L-50 U-50
+M17
+M18 S30
+M114
+M105
+M115
+M119
+M420 S1 Z10
+M422 S1 X20 Y20
+G4 P500
+G4 S1.5
+M0 Click to resume
+T2 A B C D
+G1 A1 B2 C3 D4 H5 I6 J7 K8 L9 O10 P11 Q12 R13 S14 T15 U16 V17 W18
+G1 X1 Y
+G1 XYZ
+G1 N5 X1
+;LAYER:1
+G0 F9000 X46.996 Y66.688
+G1 X99.963 Y102.202 E0.03007
+G1 X100.191 Y106.649 E0.29461
+G1 F1500 E-0.50539
+G1 F1500 E0.29461
+G1 X96.455 Y101.744 E0.51382
+G1 X100.989 Y98.760 E0.53827
+G1 X97.108 Y95.356 E0.54430 F1200
+G1 X94.376 Y95.036 E0.76283
+G1 X97.502 Y93.029 E0.93562 F1200
+G1 X94.794 Y91.323 E1.00882
+G1 X94.062 Y87.020 E1.15184
+G1 X96.085 Y82.929 E1.17056
+G1 F1500 E0.37056
+G1 F1500 E1.17056
+G1 X94.931 Y79.864 E1.18147 F2400
+G1 X99.449 Y79.781 E1.46780
+G1 X99.701 Y79.868 E1.53544
+G1 X96.653 Y83.367 E1.68839
+G1 X98.115 Y79.744 E1.76271 F1200
+G0 F9000 X0.253 Y188.042
+G1 X101.660 Y82.521 E1.88776
+G1 X106.442 Y81.861 E2.16982
+G1 X106.464 Y84.673 E2.20875
+G1 X108.268 Y83.338 E2.23668
+G1 X111.984 Y87.175 E2.25116
+G1 X112.283 Y85.393 E2.31735
+G1 X113.834 Y81.953 E2.50325 F2400
+G1 X108.889 Y85.246 E2.57929
+;TYPE:WALL-OUTER
+G0 F9000 X194.278 Y110.644
+G1 X112.538 Y87.770 E2.60168
+G1 X112.568 Y83.429 E2.65709
+G1 X110.038 Y81.613 E2.87159
+G1 X114.883 Y82.821 E2.98113 F2400
+G1 F1500 E2.18113
+G1 F1500 E2.98113
+G1 X110.960 Y84.636 E3.17278
+G1 X106.491 Y86.065 E3.43867
+G1 X110.183 Y84.109 E3.63589
+G1 X105.572 Y83.566 E3.80197
+G1 X108.990 Y80.707 E3.89263
+G1 F1500 E3.09263
+G1 F1500 E3.89263
+G1 X111.796 Y77.089 E4.18232
+G1 X113.764 Y74.465 E4.39131
+G1 F1500 E3.59131
+G1 F1500 E4.39131
+G1 X111.200 Y75.561 E4.39277
+G1 X113.871 Y73.376 E4.43255
+G1 X112.509 Y74.052 E4.60159
+G1 X110.067 Y76.167 E4.87255
+G1 X110.318 Y80.077 E4.98635
+G1 X106.257 Y84.878 E4.99497
+G1 X109.766 Y85.645 E5.07890
+G1 X109.232 Y84.833 E5.08408
+G1 X107.920 Y80.454 E5.24961 F1800
+G1 X109.802 Y76.671 E5.47170
+G1 X110.127 Y73.295 E5.70880
+G1 X113.456 Y73.864 E5.92071
+G1 X113.950 Y72.715 E5.97558
+G1 Z0.76 F600
+G1 X117.596 Y67.956 E6.21839
+G1 X115.936 Y68.203 E6.49210
+G1 X120.380 Y67.493 E6.51975
+G1 X117.594 Y67.134 E6.72082
+G1 X115.430 Y69.957 E6.82373
+G1 F1500 E6.02373
+G1 F1500 E6.82373
+G1 X113.661 Y74.073 E6.96239 F1200
+G0 F9000 X213.709 Y78.457
+G1 X116.319 Y78.735 E7.02690
+G1 X111.782 Y77.559 E7.15241
+G1 F1500 E6.35241
+G1 F1500 E7.15241
+G1 X113.964 Y75.676 E7.20154
+G1 X117.274 Y75.174 E7.45438
+G1 X115.252 Y77.048 E7.72969
+G1 X111.175 Y74.131 E8.01177
+G1 X110.640 Y69.903 E8.03132
+G1 X110.438 Y65.585 E8.32708
+G1 X114.274 Y65.652 E8.46203
+G1 X119.186 Y68.691 E8.59873
+G1 F1500 E7.79873
+G1 F1500 E8.59873
+G1 X116.244 Y71.303 E8.72991
+G1 X116.635 Y73.634 E8.82236
+G1 X112.356 Y70.477 E9.07203 F1200
+G1 X108.837 Y73.213 E9.07526
+G0 F9000 X131.777 Y186.054
+G0 F9000 X22.416 Y138.969
+G1 X103.940 Y72.898 E9.31343
+G1 X99.022 Y74.075 E9.47436
+G1 X99.864 Y73.888 E9.63916
+G1 X102.776 Y69.106 E9.87446
+G1 X99.951 Y67.189 E9.99393
+G0 F9000 X64.710 Y100.479
+G1 X100.251 Y62.879 E10.16151
+G1 X100.824 Y65.936 E10.27546
+G1 X98.268 Y63.668 E10.50612
+G1 X95.438 Y66.009 E10.70117
+G1 X93.288 Y68.034 E10.96568
+G1 X89.737 Y65.531 E11.01760
+G1 X90.317 Y62.495 E11.14104
+G1 F1500 E10.34104
+G1 F1500 E11.14104
+G1 X92.358 Y66.438 E11.42564
+G1 X91.155 Y66.315 E11.60715
+G1 X91.281 Y68.710 E11.61134
+G1 X91.294 Y69.257 E11.85804
+G1 X87.200 Y67.599 E11.87626
+G1 X85.778 Y71.706 E12.01702
+G1 X90.556 Y75.230 E12.28848
+G1 X87.102 Y78.663 E12.57544
+G1 X88.353 Y81.365 E12.84801
+G1 Z1.26 F600
+G1 X88.775 Y78.622 E13.05972
+G0 F9000 X78.904 Y161.695
+G1 X87.014 Y77.814 E13.26652
+G0 F9000 X43.299 Y90.997
+G1 X83.818 Y75.837 E13.30903 F1800
+G1 X79.411 Y75.180 E13.40975
+G1 X81.118 Y77.510 E13.46664
+G1 F1500 E12.66664
+G1 F1500 E13.46664
+G1 X83.740 Y80.258 E13.68927
+G1 X79.211 Y81.965 E13.97662
+G1 X84.005 Y81.705 E14.20476
+;TYPE:WALL-OUTER
+G1 X87.820 Y84.018 E14.46267 F1800
+G1 X83.055 Y84.971 E14.48596
+G1 X85.120 Y82.191 E14.49473
+G1 X80.699 Y82.436 E14.73995
+G1 X80.845 Y81.104 E15.02357
+G1 X81.964 Y84.169 E15.08464
+G1 X83.351 Y83.403 E15.24687
+G1 X79.338 Y81.791 E15.29126
+G1 X80.560 Y85.125 E15.41241
+G0 F9000 X170.495 Y189.482
+G1 X77.773 Y87.759 E15.67971
+G1 X82.613 Y84.765 E15.87544
+G1 X86.772 Y84.768 E15.92404
+G1 X86.849 Y83.521 E16.17308
+G1 X87.845 Y79.234 E16.22679
+G1 X86.460 Y82.469 E16.49422
+G1 X83.832 Y78.285 E16.64195
+G1 X79.604 Y73.803 E16.76652
+G1 X81.512 Y76.386 E17.01576
+G1 X85.930 Y72.073 E17.19845
+G0 F9000 X58.545 Y150.620
+G1 X82.020 Y67.576 E17.38063
+G1 Z1.61 F600
+G1 X82.372 Y63.384 E17.47982
+G1 X84.862 Y63.028 E17.71544
+G1 X82.234 Y64.825 E17.75675 F2400
+G1 X80.448 Y62.937 E17.96174
+G1 X81.759 Y62.117 E17.97084
+G1 X81.499 Y64.081 E18.05254
+G1 X81.694 Y59.438 E18.17547
+G1 X86.113 Y56.820 E18.27578
+G1 X85.775 Y57.271 E18.27621
+G1 X84.666 Y54.443 E18.32941
+G1 F1500 E17.52941
+G1 F1500 E18.32941
+G1 X88.456 Y57.748 E18.33111
+G1 X92.520 Y55.255 E18.49140
+G1 X96.225 Y51.279 E18.54996
+G1 X96.495 Y55.027 E18.55454
+;TYPE:WALL-OUTER
+G1 X100.056 Y53.492 E18.60152
+G1 X97.957 Y56.248 E18.89259
+G1 X101.269 Y58.105 E19.00158
+G1 X98.216 Y60.315 E19.11427
+G1 X97.698 Y61.835 E19.14218
+G1 X102.489 Y59.702 E19.27644
+G1 X97.742 Y62.914 E19.44159
+G1 X101.820 Y66.023 E19.64677
+G1 X105.618 Y63.349 E19.88475
+G1 X102.178 Y63.331 E19.94151
+G1 X99.987 Y64.147 E20.19604
+G0 F9000 X34.870 Y194.662
+G1 X96.760 Y68.804 E20.23945
+G1 X98.917 Y68.796 E20.36388
+G0 F9000 X1.647 Y163.720
+G1 X97.119 Y71.657 E20.49101
+G1 F1500 E19.69101
+G1 F1500 E20.49101
+G1 X94.528 Y68.047 E20.60037
+G1 X97.871 Y69.112 E20.66771
+G1 X94.587 Y66.813 E20.96291
+G1 X89.860 Y63.502 E20.99942 F1800
+G1 X92.636 Y65.630 E21.13079
+G1 X89.897 Y70.598 E21.13237
+G1 X93.014 Y65.614 E21.38398
+G1 X96.866 Y65.489 E21.67368
+G1 X98.038 Y70.109 E21.86500
+G1 X98.557 Y67.555 E22.16372
+G1 X101.280 Y71.142 E22.35047
+G0 F9000 X46.396 Y104.115
+;TYPE:WALL-OUTER
+G1 F1500 E21.55047
+G1 F1500 E22.35047
+G1 X103.941 Y75.539 E22.56754
+G1 X101.446 Y75.284 E22.56893 F1800
+G1 X105.824 Y79.124 E22.78923
+G1 X106.732 Y81.697 E22.82079
+G1 X105.832 Y78.937 E23.11342
+G1 X107.850 Y78.585 E23.29569
+G1 X111.726 Y78.015 E23.45529
+G1 X107.640 Y77.024 E23.55029
+G1 X111.389 Y77.265 E23.76175
+G1 X115.198 Y75.114 E23.89642
+G1 X111.361 Y79.299 E24.16231 F2400
+M84
+M73 P100 R0
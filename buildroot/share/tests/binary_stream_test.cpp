@@ -0,0 +1,152 @@
+/**
+ * Host test - binary_stream_test.cpp
+ *
+ * binary_transfer.py uploads a file to BinaryStream::receive() over a pipe,
+ * as it would over a serial port, and the file written must be the one sent.
+ *
+ * The upload is made twice: on a clean line, and on one that drops bytes and
+ * flips bits on the way to Marlin, so lost packets are asked for again and,
+ * with BINARY_STREAM_WINDOW, the packets after them are kept.
+ *
+ * Time in Marlin moves 1ms for each wait on the pipe, so packet timeouts
+ * come at about the rate they would on the board.
+ *
+ * config: opt_enable BINARY_FILE_TRANSFER
+ * config: opt_enable BINARY_FILE_TRANSFER; opt_set BINARY_STREAM_WINDOW 4
+ * sources: feature/binary_stream.cpp libs/heatshrink/heatshrink_decoder.cpp core/serial.cpp
+ */
+#include <string>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define private public
+#include "sd/cardreader.h"
+#undef private
+#include "feature/binary_stream.h"
+
+static int failures;
+#define CHECK(C, V...) do{ if (!(C)) { failures++; printf("FAIL %s:%d %s ", __FILE__, __LINE__, #C); printf(V); printf("\n"); } }while(0)
+
+// The file being written, in place of the SD card
+static std::string written, written_name;
+static uint32_t opens, closes;
+
+// What binary_stream.h needs from the SD card
+card_flags_t CardReader::flag;
+SdFile CardReader::file;
+char CardReader::filename[FILENAME_LENGTH];
+#if HAS_MULTI_SERIAL
+  int8_t CardReader::transfer_port_index;
+#endif
+void CardReader::mount() { flag.mounted = true; }
+void CardReader::release() { flag.mounted = false; }
+void CardReader::openFileWrite(char * const path) {
+  written.clear();
+  written_name = path;
+  file.type_ = FAT_FILE_TYPE_NORMAL;
+  opens++;
+}
+void CardReader::closefile(const bool) { file.type_ = FAT_FILE_TYPE_CLOSED; closes++; }
+void CardReader::removeFile(const char * const) { written_name.clear(); }
+int16_t SdFile::write(const void *buf, uint16_t nbyte) { written.append((const char*)buf, nbyte); return nbyte; }
+bool SdBaseFile::close() { type_ = FAT_FILE_TYPE_CLOSED; return true; }
+
+// The host, and the line to it
+static int to_host, from_host;
+static uint32_t drop_one_in, flip_one_in, dropped, flipped;
+
+// Pass on what Marlin sent, and fetch what the host sends, or wait 1ms for it
+static void exchange() {
+  const std::string out = Serial.take();
+  for (size_t i = 0; i < out.size();) {
+    const ssize_t n = write(to_host, out.data() + i, out.size() - i);
+    if (n <= 0) break;
+    i += n;
+  }
+  pollfd p = { from_host, POLLIN, 0 };
+  char buf[256];
+  ssize_t n = 0;
+  if (poll(&p, 1, 1) > 0) n = read(from_host, buf, sizeof(buf));
+  if (n <= 0) { delay(1); return; }
+  std::string in;
+  for (ssize_t i = 0; i < n; i++) {
+    if (drop_one_in && !(rand() % drop_one_in)) { dropped++; continue; }
+    if (flip_one_in && !(rand() % flip_one_in)) { buf[i] ^= 1 << (rand() % 8); flipped++; }
+    in += buf[i];
+  }
+  Serial.rx.erase(0, Serial.rx_pos);
+  Serial.rx_pos = 0;
+  Serial.rx += in;
+}
+
+// Upload 'data' with binary_transfer.py, returning its exit status
+static int upload(const std::string &data) {
+  char path[] = "/tmp/binary_stream_test_XXXXXX";
+  const int fd = mkstemp(path);
+  CHECK(write(fd, data.data(), data.size()) == ssize_t(data.size()), "can't write %s", path);
+  close(fd);
+
+  std::string script = __FILE__;
+  script = script.substr(0, script.rfind('/') + 1) + "../scripts/binary_transfer.py";
+
+  int down[2], up[2];
+  if (pipe(down) || pipe(up)) return -1;
+  const pid_t pid = fork();
+  if (!pid) {
+    dup2(down[0], 0);
+    dup2(up[1], 1);
+    close(down[1]); close(up[0]);
+    execlp("python3", "python3", script.c_str(), "send", "-", path, "TEST.GCO", (char*)nullptr);
+    _exit(127);
+  }
+  close(down[0]); close(up[1]);
+  to_host = down[1];
+  from_host = up[0];
+
+  // The host asks for binary mode as a G-code line
+  Serial.rx.clear(); Serial.rx_pos = 0;
+  Serial.on_empty = exchange;
+  for (millis_t end = millis() + 5000; Serial.rx.find("M28 B1\n") == std::string::npos && PENDING(millis(), end);) exchange();
+  CHECK(Serial.rx.find("M28 B1\n") != std::string::npos, "no M28 B1 from the host");
+  Serial.rx_pos = Serial.rx.find("M28 B1\n") + 7;
+  card.flag.binary_mode = true;
+
+  // Receive, as the queue does, until the host closes the stream
+  char buffer[MAX_CMD_SIZE];
+  for (millis_t end = millis() + 600000UL; card.flag.binary_mode && PENDING(millis(), end);)
+    binaryStream[0].receive(buffer);
+  CHECK(!card.flag.binary_mode, "the host never closed the stream");
+
+  // Let the host see the last "ok" and finish
+  Serial.on_empty = nullptr;
+  exchange();
+  close(to_host);
+  int status;
+  waitpid(pid, &status, 0);
+  close(from_host);
+  unlink(path);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+int main() {
+  std::string data;
+  srand(46);
+  for (uint32_t i = 0; i < 24 * 1024; i++) data += char(rand());
+
+  printf("  window %u, packet %u bytes\n", unsigned(BinaryStream::WINDOW), unsigned(MAX_CMD_SIZE));
+  for (const uint32_t noise : { 0, 1500 }) {
+    drop_one_in = flip_one_in = noise;
+    dropped = flipped = opens = closes = 0;
+    binaryStream[0].reset();
+    const millis_t start = millis();
+    CHECK(upload(data) == 0, "binary_transfer.py failed");
+    CHECK(written == data, "%u bytes written of %u sent", unsigned(written.size()), unsigned(data.size()));
+    CHECK(written_name == "TEST.GCO", "written to \"%s\"", written_name.c_str());
+    CHECK(opens == 1 && closes == 1, "%u opens and %u closes", opens, closes);
+    printf("  %u bytes in %u ms with %u bytes dropped and %u flipped\n", unsigned(data.size()), unsigned(millis() - start), dropped, flipped);
+  }
+
+  printf("%s\n", failures ? "FAILED" : "passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * Host test - dispatch_test.cpp
+ *
+ * GCODE_DISPATCH_TABLE runs the same handler as the process_parsed_command()
+ * switch for every G and M code. gcode.cpp is preprocessed with and without
+ * the option, and each case of the switch is compared with the table entry
+ * for its code: the call it makes (through the small wrappers the table uses
+ * for codes that share a function), and whether it sends its own "ok".
+ *
+ * Codes in only one of them, and cases that fall through, are failures.
+ *
+ * config:
+ * config: opt_enable ARC_SUPPORT BEZIER_CURVE_SUPPORT FWRETRACT FWRETRACT_AUTORETRACT NOZZLE_CLEAN_FEATURE NOZZLE_PARK_FEATURE CNC_WORKSPACE_PLANES INCH_MODE_SUPPORT CNC_COORDINATE_SYSTEMS G38_PROBE_TARGET G38_PROBE_AWAY DIRECT_PIN_CONTROL PINS_DEBUGGING LCD_SET_PROGRESS_MANUALLY HOST_KEEPALIVE_FEATURE PHOTO_GCODE BABYSTEPPING GCODE_MACROS TEMPERATURE_UNITS_SUPPORT M114_DETAIL REPETIER_GCODE_M360 BAUD_RATE_GCODE CREDIT_FLOW_CONTROL PASSWORD_FEATURE; opt_add DEBUG_GCODE_PARSER
+ * config: opt_enable EMERGENCY_PARSER HOST_PROMPT_SUPPORT FASTER_GCODE_PARSER GCODE_PARSE_AHEAD SD_GCODE_INDEX; opt_add G0_FEEDRATE 3000
+ * input: for o in "" -DGCODE_DISPATCH_TABLE; do $CXX $CXXFLAGS -I"$srcdir" -E -P $o "$srcdir/gcode/gcode.cpp"; echo "@@@@"; done
+ */
+#include <string>
+#include <map>
+#include <regex>
+#include <iostream>
+#include <iterator>
+
+static int failures;
+#define CHECK(C, V...) do{ if (!(C)) { failures++; printf("FAIL %s:%d %s ", __FILE__, __LINE__, #C); printf(V); printf("\n"); } }while(0)
+
+// The text of the braces that open at or after 'from', without them
+static std::string braced(const std::string &s, size_t from) {
+  size_t start = s.find('{', from), i = start;
+  if (start == std::string::npos) return "";
+  for (int depth = 0; i < s.size(); i++) {
+    const char c = s[i];
+    if (c == '"' || c == '\'') {                // Skip strings and chars
+      for (i++; i < s.size() && s[i] != c; i++) if (s[i] == '\\') i++;
+    }
+    else if (c == '{') depth++;
+    else if (c == '}' && !--depth) break;
+  }
+  return s.substr(start + 1, i - start - 1);
+}
+
+// A handler body, as the code it runs for one code number
+static std::string normal(std::string b, const int code) {
+  b = std::regex_replace(b, std::regex("parser\\.codenum"), std::to_string(code));
+  b = std::regex_replace(b, std::regex("\\s+"), "");
+  b = std::regex_replace(b, std::regex("\\(void\\(0\\)\\);"), "");  // NOOP
+  std::smatch m;
+  while (std::regex_search(b, m, std::regex("\\b(\\d+)==(\\d+)\\b")))
+    b = m.prefix().str() + (m[1] == m[2] ? "true" : "false") + m.suffix().str();
+  return b;
+}
+
+typedef std::map<int, std::string> handlers_t;
+
+// The top-level cases of the switch on parser.codenum for a command letter
+static handlers_t switch_cases(const std::string &src, const char letter) {
+  handlers_t cases;
+  std::smatch m;
+  const std::string body = src.substr(src.find("void GcodeSuite::process_parsed_command("));
+  if (!std::regex_search(body, m, std::regex(std::string("case\\s*'") + letter + "'\\s*:\\s*switch\\s*\\(\\s*parser\\.codenum\\s*\\)"))) {
+    CHECK(false, "no %c switch", letter);
+    return cases;
+  }
+  const std::string block = braced(body, m.position(0));
+
+  // Split it at the labels outside any braces
+  std::vector<int> labels;
+  std::string arm;
+  const auto end_arm = [&]{
+    std::string a = std::regex_replace(arm, std::regex("^\\s+|\\s+$"), "");
+    if (a.empty()) return;                      // Labels stacked on one body
+    if (std::regex_search(a, std::regex("break\\s*;$")))
+      a = std::regex_replace(a, std::regex("break\\s*;$"), "");
+    else if (!std::regex_search(a, std::regex("return\\s*;$")))
+      a += "/* falls through */";
+    for (const int c : labels) {
+      CHECK(!cases.count(c), "%c%d has two cases", letter, c);
+      cases[c] = normal(a, c);
+    }
+    labels.clear();
+    arm.clear();
+  };
+  const std::regex label("^(case\\s+(\\d+)|default)\\s*:");
+  for (size_t i = 0, depth = 0; i < block.size(); i++) {
+    const char c = block[i];
+    if (!depth && (i == 0 || !isalnum(block[i - 1]) && block[i - 1] != '_')) {
+      std::smatch l;
+      const std::string rest = block.substr(i, 32);
+      if (std::regex_search(rest, l, label)) {
+        end_arm();
+        if (l[2].matched) labels.push_back(std::stoi(l[2]));
+        i += l.length(0) - 1;
+        continue;
+      }
+    }
+    if (c == '{') depth++;
+    if (c == '}') depth--;
+    arm += c;
+  }
+  end_arm();
+  return cases;
+}
+
+// The entries of the dispatch table for a command letter
+static handlers_t table_entries(const std::string &src, const char letter) {
+  handlers_t entries;
+  const size_t at = src.find(std::string("dispatch_t ") + char(tolower(letter)) + "_table[]");
+  if (at == std::string::npos) { CHECK(false, "no %c table", letter); return entries; }
+  const std::string table = braced(src, at);
+  const std::regex entry("\\{\\s*(\\d+)\\s*,\\s*&\\s*(\\w+)::(\\w+)\\s*,\\s*(\\w+)\\s*\\}");
+  for (std::sregex_iterator e(table.begin(), table.end(), entry), none; e != none; ++e) {
+    const int code = std::stoi((*e)[1]);
+    const std::string cls = (*e)[2], fn = (*e)[3];
+    std::string body;
+    if (cls == "GCodeParser")
+      body = "parser." + fn + "();";
+    else {
+      // A wrapper defined with the table, or the handler itself
+      std::smatch w;
+      if (std::regex_search(src, w, std::regex("void\\s+GcodeSuite::" + fn + "\\s*\\(\\s*\\)\\s*\\{")))
+        body = braced(src, w.position(0));
+      else
+        body = fn + "();";
+    }
+    if ((*e)[4] == "GC_NO_OK") body += "return;";
+    CHECK(!entries.count(code), "%c%d has two entries", letter, code);
+    entries[code] = normal(body, code);
+  }
+  return entries;
+}
+
+int main() {
+  const std::string in((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+  const size_t mark = in.find("@@@@");
+  CHECK(mark != std::string::npos && in.find("@@@@", mark + 4) != std::string::npos, "expected gcode.cpp twice");
+  if (failures) return 1;
+  const std::string with_switch = in.substr(0, mark), with_table = in.substr(mark + 4);
+
+  for (const char letter : { 'G', 'M' }) {
+    const handlers_t cases = switch_cases(with_switch, letter), entries = table_entries(with_table, letter);
+    CHECK(cases.size() > 5, "only %u %c cases found", unsigned(cases.size()), letter);
+    for (const auto &c : cases) {
+      const auto e = entries.find(c.first);
+      CHECK(e != entries.end(), "%c%d is in the switch (%s) but not the table", letter, c.first, c.second.c_str());
+      if (e != entries.end())
+        CHECK(e->second == c.second, "%c%d runs %s in the switch but %s from the table", letter, c.first, c.second.c_str(), e->second.c_str());
+    }
+    for (const auto &e : entries)
+      CHECK(cases.count(e.first), "%c%d is in the table (%s) but not the switch", letter, e.first, e.second.c_str());
+    printf("  %u %c codes\n", unsigned(entries.size()), letter);
+  }
+
+  printf("%s\n", failures ? "FAILED" : "passed");
+  return failures ? 1 : 0;
+}
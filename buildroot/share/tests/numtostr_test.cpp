@@ -0,0 +1,111 @@
+/**
+ * Host test - numtostr_test.cpp
+ *
+ * ftostrdp(), which SERIAL_ECHOPAIR uses for floats, against the printFloat()
+ * of the Arduino core it replaced, for random values and 0-6 places. Each
+ * string is the nearest to the value, with ties rounded away from zero, where
+ * printFloat() is a unit off on some of them. nan, inf and ovf are as before.
+ *
+ * Then the time per value of each, and of snprintf(), in ns on the host.
+ * The host has a double FPU, so this understates the gain on an MCU that
+ * does double math in software.
+ *
+ * sources: libs/numtostr.cpp
+ */
+#include <string>
+#include <chrono>
+
+#include "libs/numtostr.h"
+#include "core/macros.h"
+
+static int failures;
+#define CHECK(C, V...) do{ if (!(C)) { failures++; printf("FAIL %s:%d %s ", __FILE__, __LINE__, #C); printf(V); printf("\n"); } }while(0)
+
+// Print::printFloat() of the Arduino cores, as a string
+static std::string print_float(double number, uint8_t digits) {
+  if (isnan(number)) return "nan";
+  if (isinf(number)) return "inf";
+  if (number > 4294967040.0 || number < -4294967040.0) return "ovf";
+  std::string s;
+  if (number < 0.0) { s += '-'; number = -number; }
+  double rounding = 0.5;
+  for (uint8_t i = 0; i < digits; ++i) rounding /= 10.0;
+  number += rounding;
+  const unsigned long int_part = (unsigned long)number;
+  double remainder = number - (double)int_part;
+  s += std::to_string(int_part);
+  if (digits > 0) s += '.';
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    const int to_print = int(remainder);
+    s += char('0' + to_print);
+    remainder -= to_print;
+  }
+  return s;
+}
+
+// A random float, over the range that gets reported
+static float value() {
+  const float m = float(rand()) / RAND_MAX;
+  switch (rand() % 5) {
+    case 0:  return (rand() % 2 ? -1 : 1) * m;                              // Offsets
+    case 1:  return (rand() % 2 ? -1 : 1) * m * 500;                        // Positions and temperatures
+    case 2:  return float(rand() % 100000) / 1000 * (rand() % 2 ? -1 : 1);  // Exact to 3 places in text
+    case 3:  return float(rand() % 20000) / 16;                             // Ties, exact in binary
+    default: return ldexpf(m, rand() % 40 - 8);                             // Anything up to overflow
+  }
+}
+
+// The digits after the point
+static uint8_t places_of(const std::string &s) {
+  const size_t dot = s.find('.');
+  return dot == std::string::npos ? 0 : s.size() - dot - 1;
+}
+
+static void test_values() {
+  uint32_t same = 0, ties = 0;
+  for (uint32_t n = 0; n < 500000; n++) {
+    const float f = n < 4 ? (const float[]){ NAN, INFINITY, 5e9f, -0.001f }[n] : value();
+    const uint8_t places = n % 7;
+    const std::string got = ftostrdp(f, places), arduino = print_float(f, places);
+    char nearest[64];
+    snprintf(nearest, sizeof(nearest), "%.*f", places, double(f));    // Ties to even
+    const double t = fabs(double(f)) * pow(10, places);                // Exact for a float and up to 6 places
+    if (got == arduino) same++;
+    if (isfinite(f) && fabsf(f) < 4294967040.0f) {
+      CHECK(places_of(got) == places, "%.9g to %u places is \"%s\"", f, places, got.c_str());
+      if (t - floor(t) == 0.5) {
+        CHECK(fabs(strtod(got.c_str(), nullptr)) > fabs(f), "%.9g to %u places is \"%s\", not away from zero", f, places, got.c_str());
+        ties++;
+      }
+      else
+        CHECK(got == nearest, "%.9g to %u places is \"%s\", not \"%s\"", f, places, got.c_str(), nearest);
+    }
+    else
+      CHECK(got == arduino, "%.9g is \"%s\", not \"%s\"", f, got.c_str(), arduino.c_str());
+  }
+  printf("  500000 values, %u ties: %u as printFloat\n", ties, same);
+}
+
+template<typename F>
+static void bench(const char * const what, F format) {
+  srand(38);
+  constexpr uint32_t N = 400000;
+  static float values[N];
+  for (float &v : values) v = (rand() % 2 ? -1 : 1) * float(rand()) / RAND_MAX * 300;
+  volatile size_t sink = 0;
+  const auto started = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < N; i++) sink = sink + format(values[i], 2 + i % 2);
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count() / N;
+  printf("  %-12s %6.0f ns per value (host)\n", what, ns);
+}
+
+int main() {
+  srand(38);
+  test_values();
+  bench("ftostrdp", [](const float f, const uint8_t p) { return strlen(ftostrdp(f, p)); });
+  bench("printFloat", [](const float f, const uint8_t p) { return print_float(f, p).size(); });
+  bench("snprintf", [](const float f, const uint8_t p) { char s[32]; return size_t(snprintf(s, sizeof(s), "%.*f", p, double(f))); });
+  printf("%s\n", failures ? "FAILED" : "passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * Host test - parser_test.cpp
+ *
+ * GCodeParser values against the C library: value_float() within 1 ulp of
+ * strtof() and value_long() equal to strtol(), for random decimals, integers,
+ * signs, leading zeros and values too large for an int32_t.
+ *
+ * Then the time to parse slicer moves and read their values, once per
+ * parameter as G1 does and three times as handlers that check a value
+ * before using it do, in ns per command on the host. Compare the builds
+ * with and without PREPARSED_GCODE_VALUES.
+ *
+ * config:
+ * config: opt_enable PREPARSED_GCODE_VALUES
+ * sources: gcode/parser.cpp
+ */
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "gcode/parser.h"
+
+static int failures;
+#define CHECK(C, V...) do{ if (!(C)) { failures++; printf("FAIL %s:%d %s ", __FILE__, __LINE__, #C); printf(V); printf("\n"); } }while(0)
+
+// Floats apart, in ulps
+static uint32_t ulps(const float a, const float b) {
+  int32_t ia, ib;
+  memcpy(&ia, &a, 4); memcpy(&ib, &b, 4);
+  if (ia < 0) ia = INT32_MIN - ia;
+  if (ib < 0) ib = INT32_MIN - ib;
+  return ia > ib ? uint32_t(ia - ib) : uint32_t(ib - ia);
+}
+
+// A random number as a slicer or a host might write it
+static std::string number() {
+  char s[40];
+  const char * const sign = rand() % 4 ? (rand() % 3 ? "" : "-") : "+";
+  switch (rand() % 6) {
+    case 0:  sprintf(s, "%s%d", sign, rand() % 1000); break;
+    case 1:  sprintf(s, "%s%d", sign, rand());  break;                                  // Up to INT32_MAX
+    case 2:  sprintf(s, "%s%d%09d", sign, rand() % 100 + 1, rand() % 1000000000); break; // Too large for an int32_t
+    case 3:  sprintf(s, "%s%d.%0*d", sign, rand() % 300, rand() % 7 + 1, rand() % 10000000); break;
+    case 4:  sprintf(s, "%s.%d", sign, rand() % 100000); break;
+    default: sprintf(s, "%s00%d.%03d00", sign, rand() % 50, rand() % 1000); break;
+  }
+  return s;
+}
+
+static void test_values() {
+  uint32_t worst = 0;
+  for (uint32_t n = 0; n < 200000; n++) {
+    const std::string x = number(), y = number();
+    std::string line = "G1 X" + x + " Y" + y + " Z";
+    parser.parse(&line[0]);
+    const char letter[] = { 'X', 'Y' };
+    const std::string *text[] = { &x, &y };
+    for (uint8_t i = 0; i < 2; i++) {
+      CHECK(parser.seenval(letter[i]), "%c not seen in \"%s\"", letter[i], line.c_str());
+      const float want = strtof(text[i]->c_str(), nullptr), got = parser.value_float();
+      const uint32_t u = ulps(got, want);
+      NOLESS(worst, u);
+      CHECK(u <= 1, "%s read as %.9g, not %.9g", text[i]->c_str(), got, want);
+      const long wl = strtol(text[i]->c_str(), nullptr, 10), gl = parser.value_long();
+      CHECK(gl == wl || wl != int32_t(wl), "%s read as %ld, not %ld", text[i]->c_str(), gl, wl);
+    }
+    CHECK(parser.seen('Z') && !parser.has_value(), "Z with no value in \"%s\"", line.c_str());
+  }
+  printf("  200000 lines, values within %u ulp of strtof\n", worst);
+}
+
+// Moves as a slicer writes them
+static std::vector<std::string> moves() {
+  std::vector<std::string> v;
+  for (uint32_t n = 0; n < 20000; n++) {
+    char s[80];
+    if (n % 10)
+      sprintf(s, "G1 X%d.%03d Y%d.%03d E%d.%05d", rand() % 220, rand() % 1000, rand() % 220, rand() % 1000, rand() % 3, rand() % 100000);
+    else
+      sprintf(s, "G1 Z%d.%02d F%d", rand() % 200, rand() % 100, 600 + rand() % 9000);
+    v.push_back(s);
+  }
+  return v;
+}
+
+static void bench(const char * const what, const uint8_t reads) {
+  std::vector<std::string> lines = moves();
+  volatile float sink = 0;
+  constexpr uint8_t PASSES = 10;
+  auto started = std::chrono::steady_clock::now();
+  for (uint8_t p = 0; p <= PASSES; p++) {
+    if (p == 1) started = std::chrono::steady_clock::now();   // After a pass to warm up
+    for (std::string &l : lines) {
+      std::string line = l;
+      parser.parse(&line[0]);
+      float sum = 0;
+      for (const char c : { 'X', 'Y', 'Z', 'E', 'F' })
+        if (parser.seenval(c)) for (uint8_t r = 0; r < reads; r++) sum += parser.value_float();
+      sink = sink + sum;
+    }
+  }
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count() / (PASSES * lines.size());
+  printf("  %-22s %6.0f ns per command (host)\n", what, ns);
+}
+
+int main() {
+  srand(31);
+  test_values();
+  bench("parse", 0);
+  bench("parse, read once", 1);
+  bench("parse, read 3 times", 3);
+  printf("%s\n", failures ? "FAILED" : "passed");
+  return failures ? 1 : 0;
+}
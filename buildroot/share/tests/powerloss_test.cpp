@@ -0,0 +1,244 @@
+/**
+ * Host test - powerloss_test.cpp
+ *
+ * The power-loss ring on a RAM copy of the SPI flash or the I2C EEPROM. The
+ * flash only programs bits from 1 to 0 and needs an erase to set them again.
+ * Power can be cut after any byte, or part way through an erase.
+ *
+ *  - Every save loads back after a restart, through changes to the info
+ *    that need a new snapshot and through the ring wrapping many times.
+ *  - A save cut short loads the save before it, or itself, and the job goes
+ *    on saving from there.
+ *  - No byte is programmed without an erase, and saves wear the sectors
+ *    evenly.
+ *  - A purged ring has nothing to load, and the next job follows on.
+ *
+ * The device traffic of a save is printed for each ring.
+ *
+ * config: opt_add HAS_SPI_FLASH 1; opt_add SPI_FLASH_SIZE 0x200000; opt_enable POWER_LOSS_RING_W25QXX
+ * config: opt_add IIC_BL24CXX_EEPROM; opt_add MARLIN_EEPROM_SIZE 0x400; opt_add POWER_LOSS_RING_ADDR 0x400; opt_enable POWER_LOSS_RING_BL24CXX
+ * sources: feature/powerloss.cpp libs/crc16.cpp
+ */
+#define private public
+#include "feature/powerloss.h"
+#include "sd/cardreader.h"
+#undef private
+
+#include <vector>
+#include <tuple>
+
+#if ENABLED(POWER_LOSS_RING_W25QXX)
+  #include "libs/W25Qxx.h"
+  #define MEM_SIZE      (SPI_FLASH_SIZE)
+  #define SECTOR_SIZE   SPI_FLASH_SectorSize
+  #define NEEDS_ERASE   true
+#else
+  #include "libs/BL24CXX.h"
+  #define MEM_SIZE      ((EE_TYPE) + 1)
+  #define SECTOR_SIZE   512
+  #define NEEDS_ERASE   false
+#endif
+
+#ifndef POWER_LOSS_RING_SECTORS
+  #define POWER_LOSS_RING_SECTORS (NEEDS_ERASE ? 16 : 2)
+#endif
+#ifndef POWER_LOSS_RING_ADDR
+  #define POWER_LOSS_RING_ADDR (MEM_SIZE - (POWER_LOSS_RING_SECTORS) * uint32_t(SECTOR_SIZE))
+#endif
+
+static int failures;
+#define CHECK(C, V...) do{ if (!(C)) { failures++; printf("FAIL %s:%d %s ", __FILE__, __LINE__, #C); printf(V); printf("\n"); } }while(0)
+
+// The device, with its traffic and the power left in bytes (-1 for no cut)
+static std::vector<uint8_t> mem(MEM_SIZE, NEEDS_ERASE ? 0xFF : 0x00);
+static struct { uint32_t programmed, read, erases, unerased, sector_erases[POWER_LOSS_RING_SECTORS], snapshots[POWER_LOSS_RING_SECTORS]; } stats;
+static int32_t power = -1;
+
+static int ring_sector_of(const uint32_t addr) {
+  return addr >= (POWER_LOSS_RING_ADDR) && addr < (POWER_LOSS_RING_ADDR) + (POWER_LOSS_RING_SECTORS) * uint32_t(SECTOR_SIZE)
+    ? (addr - (POWER_LOSS_RING_ADDR)) / (SECTOR_SIZE) : -1;
+}
+
+static void mem_read(const uint32_t addr, uint8_t * const buf, const uint16_t len) {
+  CHECK(addr + len <= MEM_SIZE, "read past the end at %u", addr);
+  memcpy(buf, &mem[addr], len);
+  stats.read += len;
+}
+
+static void mem_program(const uint32_t addr, const uint8_t * const buf, const uint16_t len) {
+  CHECK(ring_sector_of(addr) >= 0 && ring_sector_of(addr + len - 1) == ring_sector_of(addr), "program outside a ring sector at %u", addr);
+  const int s = ring_sector_of(addr);
+  if (s >= 0 && addr % (SECTOR_SIZE) == 0) stats.snapshots[s]++;
+  for (uint16_t i = 0; i < len; i++) {
+    if (power == 0) return;
+    if (power > 0) power--;
+    uint8_t &b = mem[addr + i];
+    if (NEEDS_ERASE) {
+      if (buf[i] & ~b) stats.unerased++;
+      b &= buf[i];
+    }
+    else
+      b = buf[i];
+    stats.programmed++;
+  }
+}
+
+#if ENABLED(POWER_LOSS_RING_W25QXX)
+
+  W25QXXFlash W25QXX;
+  void W25QXXFlash::init(uint8_t) {}
+  void W25QXXFlash::SPI_FLASH_BufferRead(uint8_t *buf, uint32_t addr, uint16_t len) { mem_read(addr, buf, len); }
+  void W25QXXFlash::SPI_FLASH_BufferWrite(uint8_t *buf, uint32_t addr, uint16_t len) { mem_program(addr, buf, len); }
+  void W25QXXFlash::SPI_FLASH_SectorErase(uint32_t addr, const bool) {
+    CHECK(addr % (SECTOR_SIZE) == 0 && ring_sector_of(addr) >= 0, "erase outside the ring at %u", addr);
+    if (power == 0) return;
+    // Cut short, an erase leaves the sector partly erased
+    const uint32_t n = power > 0 && uint32_t(power) < SECTOR_SIZE ? power : SECTOR_SIZE;
+    if (power > 0) power -= n;
+    memset(&mem[addr], 0xFF, n);
+    stats.erases++;
+    stats.sector_erases[ring_sector_of(addr)]++;
+  }
+
+#else
+
+  void BL24CXX::read(uint16_t addr, uint8_t *buf, uint16_t len) { mem_read(addr, buf, len); }
+  void BL24CXX::write(uint16_t addr, uint8_t *buf, uint16_t len) { mem_program(addr, buf, len); }
+
+#endif
+
+// What powerloss.cpp needs from the rest of Marlin
+bool SdBaseFile::close() { return true; }
+void CardReader::getAbsFilename(char *dst) { strcpy(dst, "/JOB.GCO"); }
+
+// A restart: the state kept in RAM is lost
+static void restart() {
+  memset(&recovery.info, 0, sizeof(recovery.info));
+  recovery.ring_gen = recovery.ring_sector = recovery.ring_base = 0;
+  recovery.ring_count = 0xFFFF;
+}
+
+// The info the print has got to at save n. A new snapshot is needed every 40 saves.
+static job_recovery_info_t info_at(const uint32_t job, const uint32_t n) {
+  job_recovery_info_t i;
+  memset(&i, 0, sizeof(i));
+  strcpy(i.sd_filename, "/JOB.GCO");
+  i.valid_head = i.valid_foot = n % 255 + 1;
+  i.axis_relative = (job * 7 + n / 40) & 0x0F;
+  i.current_position.set(n * 0.5f, n * 0.25f, job + n * 0.2f, n * 3.0f);
+  i.zraise = n & 1;
+  i.sdpos = n * 1000;
+  i.feedrate = 1200 + n % 3000;
+  i.print_job_elapsed = n * 1500;
+  TERN_(HAS_HOTEND, i.target_temperature[0] = 200 + n % 10);
+  TERN_(HAS_HEATED_BED, i.target_temperature_bed = 60);
+  TERN_(HAS_FAN, i.fan_speed[0] = n * 5);
+  return i;
+}
+
+// What a restart should load. The valid fields stay as the snapshot had them.
+static bool loaded_is(const job_recovery_info_t &want) {
+  if (!recovery.info.valid()) return false;
+  job_recovery_info_t got = recovery.info;
+  got.valid_head = got.valid_foot = want.valid_head;
+  return !memcmp(&got, &want, sizeof(got));
+}
+
+static void save(const job_recovery_info_t &i) {
+  recovery.info = i;
+  recovery.write();
+}
+
+int main() {
+  recovery.enabled = true;
+
+  // Nothing to load from a blank device
+  CHECK(!recovery.exists(), "exists on a blank device");
+  restart();
+  recovery.load();
+  CHECK(!recovery.info.valid(), "loaded from a blank device");
+
+  // Save a long job, restarting to load every save
+  constexpr uint32_t SAVES = 3000;
+  recovery.prepare();
+  for (uint32_t n = 0; n < SAVES; n++) {
+    const job_recovery_info_t i = info_at(1, n);
+    save(i);
+    if (n % 7 == 0 || n < 100) {
+      const auto ring = std::make_tuple(recovery.ring_gen, recovery.ring_sector, recovery.ring_count, recovery.ring_base);
+      restart();
+      recovery.load();
+      CHECK(loaded_is(i), "save %u didn't load", n);
+      std::tie(recovery.ring_gen, recovery.ring_sector, recovery.ring_count, recovery.ring_base) = ring;
+    }
+  }
+  CHECK(!stats.unerased, "%u bytes programmed without an erase", stats.unerased);
+
+  uint32_t lo = UINT32_MAX, hi = 0, elo = UINT32_MAX, ehi = 0;
+  for (uint8_t s = 0; s < POWER_LOSS_RING_SECTORS; s++) {
+    NOMORE(lo, stats.snapshots[s]); NOLESS(hi, stats.snapshots[s]);
+    NOMORE(elo, stats.sector_erases[s]); NOLESS(ehi, stats.sector_erases[s]);
+  }
+  CHECK(hi - lo <= 1, "snapshots per sector from %u to %u", lo, hi);
+  CHECK(ehi - elo <= 1, "erases per sector from %u to %u", elo, ehi);
+  printf("  %u sectors: %u saves program %.1f bytes and erase %.3f sectors each, with %u snapshots per sector\n",
+         POWER_LOSS_RING_SECTORS, SAVES, double(stats.programmed) / SAVES, double(stats.erases) / SAVES, hi);
+
+  // Cut the power part way through saves, including snapshots and erases
+  srand(49);
+  constexpr uint32_t before_size = (POWER_LOSS_RING_SECTORS) * uint32_t(SECTOR_SIZE);
+  job_recovery_info_t last = info_at(1, SAVES - 1);
+  for (uint32_t n = SAVES; n < SAVES + 2000; n++) {
+    const job_recovery_info_t i = info_at(1, n);
+    const std::vector<uint8_t> before(&mem[POWER_LOSS_RING_ADDR], &mem[POWER_LOSS_RING_ADDR] + before_size);
+    const auto ring = std::make_tuple(recovery.ring_gen, recovery.ring_sector, recovery.ring_count, recovery.ring_base);
+    power = rand() % (n % 40 ? 80 : 1200);
+    save(i);
+    const bool done = power > 0;
+    power = -1;
+    restart();
+    recovery.load();
+    CHECK(loaded_is(i) || (!done && loaded_is(last)), "cut save %u loaded neither it nor the last", n);
+
+    if (n % 3 == 0) {
+      // Restart the job from what was loaded, as a resumed print does
+      const job_recovery_info_t r = recovery.info;
+      recovery.prepare();
+      save(r);
+      restart();
+      recovery.load();
+      CHECK(loaded_is(r), "resumed save %u didn't load", n);
+      save(i);
+      restart();
+      recovery.load();
+      CHECK(loaded_is(i), "save %u after resuming didn't load", n);
+      last = i;
+    }
+    else {
+      // Undo the cut and go on
+      std::copy(before.begin(), before.end(), &mem[POWER_LOSS_RING_ADDR]);
+      std::tie(recovery.ring_gen, recovery.ring_sector, recovery.ring_count, recovery.ring_base) = ring;
+      save(i);
+      last = i;
+    }
+  }
+  CHECK(!stats.unerased, "%u bytes programmed without an erase", stats.unerased);
+
+  // A purge leaves nothing to load, and the next job follows on
+  const uint32_t gen = recovery.ring_gen;
+  recovery.purge();
+  CHECK(!recovery.exists(), "exists after a purge");
+  restart();
+  recovery.load();
+  CHECK(!recovery.info.valid(), "loaded after a purge");
+  recovery.prepare();
+  CHECK(recovery.ring_gen >= gen, "generation went back from %u to %u", gen, recovery.ring_gen);
+  for (uint32_t n = 0; n < 100; n++) save(info_at(2, n));
+  restart();
+  recovery.load();
+  CHECK(loaded_is(info_at(2, 99)), "the next job didn't load");
+  CHECK(!stats.unerased, "%u bytes programmed without an erase", stats.unerased);
+
+  printf("%s\n", failures ? "FAILED" : "passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+/**
+ * Host test - queue_test.cpp
+ *
+ * The packed command ring: commands come back intact as the ring wraps,
+ * free_slots() (the B value of ADVANCED_OK) is never more than will fit,
+ * and a drained queue offers the whole ring again.
+ *
+ * Status queries answered on arrival: the reply goes out at once, but its
+ * "ok" follows those of earlier commands, and none is sent with credit flow.
+ *
+ * config: opt_enable PACKED_COMMAND_QUEUE ADVANCED_OK; opt_set BUFSIZE 16
+ * config: opt_enable STATUS_QUERY_ASAP ADVANCED_OK CREDIT_FLOW_CONTROL
+ * sources: gcode/queue.cpp core/serial.cpp
+ */
+#define private public
+#include "gcode/queue.h"
+#include "gcode/gcode.h"
+#include "module/planner.h"
+#include "sd/cardreader.h"
+#include "feature/powerloss.h"
+#include "feature/babystep.h"
+#include "module/temperature.h"
+#include "lcd/ultralcd.h"
+#undef private
+
+#include <string>
+#include <deque>
+
+static int failures;
+#define CHECK(C, V...) do{ if (!(C)) { failures++; printf("FAIL %s:%d %s ", __FILE__, __LINE__, #C); printf(V); printf("\n"); } }while(0)
+
+// What queue.cpp needs from the rest of Marlin
+volatile uint8_t Planner::block_buffer_head, Planner::block_buffer_tail;
+card_flags_t CardReader::flag;
+SdFile CardReader::file;
+uint32_t CardReader::filesize, CardReader::sdpos;
+void CardReader::closefile(const bool) {}
+void CardReader::write_command(char * const) {}
+void CardReader::fileHasFinished() {}
+bool SdBaseFile::close() { return true; }
+int16_t SdBaseFile::read() { return -1; }
+void Temperature::manage_heater() {}
+void MarlinUI::set_status_P(PGM_P const, const int8_t) {}
+void Babystep::add_mm(const AxisEnum, const float&) {}
+uint32_t PrintJobRecovery::cmd_sdpos, PrintJobRecovery::sdpos[BUFSIZE];
+void GCodeParser::parse(char*) {}
+void GcodeSuite::process_parsed_command(const bool) {}
+
+// Commands run by advance() are checked against what was queued, then say "ok"
+static std::deque<std::string> expected;
+void GcodeSuite::process_next_command() {
+  const std::string got = queue.command(queue.index_r);
+  CHECK(!expected.empty() && got == expected.front(), "got '%s'", got.c_str());
+  if (!expected.empty()) expected.pop_front();
+  queue.ok_to_send();
+}
+
+// The "ok" with the ADVANCED_OK fields, as of now
+static std::string ok_now() {
+  return "ok P" + std::to_string(planner.moves_free()) + " B" + std::to_string(queue.free_slots()) + "\n";
+}
+
+static std::string make_command(const int n, const size_t len) {
+  std::string s = "G1 X" + std::to_string(n) + " ;";
+  s.resize(len, 'a' + n % 26);
+  return s;
+}
+
+static bool enqueue(const int n, const size_t len) {
+  const std::string cmd = make_command(n, len);
+  if (!queue._enqueue(cmd.c_str(), true, 0)) return false;
+  expected.push_back(cmd);
+  return true;
+}
+
+// Every queued command is still the one put there
+static void check_intact() {
+  uint8_t i = queue.index_r;
+  for (const std::string &cmd : expected) {
+    CHECK(cmd == queue.command(i), "slot %d '%s'", i, queue.command(i));
+    if (++i >= BUFSIZE) i = 0;
+  }
+}
+
+#if ENABLED(PACKED_COMMAND_QUEUE)
+
+static int test_packed_ring() {
+  constexpr uint8_t ring_slots = _MIN(BUFSIZE, (COMMAND_QUEUE_BYTES) / (MAX_CMD_SIZE));
+
+  CHECK(queue.free_slots() == ring_slots, "empty queue has %d", queue.free_slots());
+
+  // Mixed short and long commands, taking one out for every one put in
+  // once the queue is half full, so the ring wraps many times over
+  int n = 0;
+  for (int round = 0; round < 20000; round++) {
+    const uint8_t slots = queue.free_slots();
+
+    // Whatever free_slots() promises must fit at full length
+    if (round % 97 == 0 && slots) {
+      for (uint8_t s = 0; s < slots; s++)
+        CHECK(enqueue(n++, MAX_CMD_SIZE - 1), "only %d of %d free slots fit", s, slots);
+      check_intact();
+    }
+    else if (queue.has_room() && (queue.length < BUFSIZE / 2 || rand() & 1)) {
+      const size_t len = rand() % 3 ? 4 + rand() % 24 : MAX_CMD_SIZE - 1;
+      CHECK(enqueue(n++, len), "has_room() but the command didn't fit");
+    }
+    else
+      queue.advance();
+
+    check_intact();
+    CHECK(queue.length == expected.size(), "length %d", queue.length);
+  }
+
+  // Drained after the ring wrapped, the whole ring is free again
+  while (queue.length) queue.advance();
+  CHECK(queue.free_slots() == ring_slots, "drained queue has %d", queue.free_slots());
+  for (uint8_t s = 0; s < ring_slots; s++)
+    CHECK(enqueue(n++, MAX_CMD_SIZE - 1), "only %d full-length commands fit", s);
+
+  // With ADVANCED_OK the host is told how many more it can send
+  while (queue.length > 1) queue.advance();
+  MYSERIAL0.take();
+  queue.ok_to_send();
+  const std::string want = ok_now(), ok = MYSERIAL0.take();
+  CHECK(ok == want, "'%s'", ok.c_str());
+
+  while (queue.length) queue.advance();
+  expected.clear();
+  return n;
+}
+
+#endif
+
+#if ENABLED(STATUS_QUERY_ASAP)
+
+// M105 as answered on arrival, sending "ok" only if it's due
+bool GcodeSuite::process_status_query(char * const cmd) {
+  if (strcmp(cmd, "M105")) return false;
+  if (queue.ok_due()) SERIAL_ECHOPGM(STR_OK);
+  SERIAL_ECHOLNPGM(" T:20.00 /0.00");
+  return true;
+}
+
+static int test_status_query() {
+  // The reply comes before the move runs, but its "ok" comes after the move's
+  expected.push_back("G1 X1");
+  MYSERIAL0.send("G1 X1\nM105\n");
+  queue.get_available_commands();
+  std::string out = MYSERIAL0.take();
+  CHECK(out == " T:20.00 /0.00\n", "'%s'", out.c_str());
+  CHECK(queue.length == 2, "length %d", queue.length);
+
+  std::string want = ok_now();
+  queue.advance();
+  out = MYSERIAL0.take();
+  CHECK(out == want, "move '%s'", out.c_str());
+  want = ok_now();
+  queue.advance();
+  out = MYSERIAL0.take();
+  CHECK(out == want, "query '%s'", out.c_str());
+  CHECK(expected.empty(), "%d commands didn't run", int(expected.size()));
+
+  // With credit flow there's no "ok" at all, and the bytes are credited
+  queue.credit_flow[0] = true;
+  expected.push_back("G1 X2");
+  MYSERIAL0.send("M105\nG1 X2\n");
+  queue.get_available_commands();
+  while (queue.length) queue.advance();
+  out = MYSERIAL0.take();
+  CHECK(out == " T:20.00 /0.00\ncredit:11\n", "'%s'", out.c_str());
+  queue.credit_flow[0] = false;
+
+  // An answered slot that's reused by a plain command runs it
+  for (int n = 0; n < 2 * BUFSIZE; n++) {
+    const std::string cmd = n % 3 ? "G1 X" + std::to_string(n) : "M105";
+    if (n % 3) expected.push_back(cmd);
+    MYSERIAL0.send((cmd + "\n").c_str());
+    queue.get_available_commands();
+    queue.advance();
+  }
+  CHECK(expected.empty(), "%d commands didn't run", int(expected.size()));
+  return 2 * BUFSIZE + 4;
+}
+
+#endif
+
+int main() {
+  srand(1);
+  int n = 0;
+  TERN_(PACKED_COMMAND_QUEUE, n += test_packed_ring());
+  TERN_(STATUS_QUERY_ASAP, n += test_status_query());
+  printf("%d commands, %s\n", n, failures ? "FAILED" : "passed");
+  return failures ? 1 : 0;
+}
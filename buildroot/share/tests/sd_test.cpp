@@ -0,0 +1,378 @@
+/**
+ * Host test - sd_test.cpp
+ *
+ * The SD layer over a FAT16 image in RAM, on a card that checks and counts
+ * its commands. Blocks pre-erased (ACMD23) but left unwritten by a multi-block
+ * write are scrambled when it stops, as a real card may leave them.
+ *
+ *  - Uploads (M28 lines and whole blocks, as binary transfer writes them),
+ *    saved alongside power-loss records, read back byte-exact, and leave the
+ *    FAT and every other file intact.
+ *  - Blocks rewritten in place (as the G-code index updates its file) only
+ *    change what was written, even right after an upload.
+ *  - A printed file read through CardReader::get() matches the image, with
+ *    the card reads it takes.
+ *  - Card reads for the file menu (one folder scan per item) and for seeks
+ *    in a fragmented file.
+ *
+ * Command counts and host throughput are printed for each workload, to
+ * compare the configurations.
+ *
+ * config:
+ * config: opt_enable SD_READ_AHEAD SD_CACHE_BLOCKS SD_WRITE_STREAM
+ * sources: sd/SdVolume.cpp sd/SdBaseFile.cpp sd/SdFile.cpp sd/cardreader.cpp
+ */
+#define private public
+#include "sd/cardreader.h"
+#undef private
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+static int failures;
+#define CHECK(C, V...) do{ if (!(C)) { failures++; printf("FAIL %s:%d %s ", __FILE__, __LINE__, #C); printf(V); printf("\n"); } }while(0)
+
+//
+// The card image. FAT16 with 2K clusters, no partition table.
+//
+constexpr uint32_t BLOCKS = 65536, CLUSTER_BLOCKS = 4, FAT_BLOCKS = 64, ROOT_ENTRIES = 512,
+                   FAT1 = 1, FAT2 = FAT1 + FAT_BLOCKS, ROOT = FAT2 + FAT_BLOCKS,
+                   DATA = ROOT + ROOT_ENTRIES * 32 / 512,
+                   CLUSTERS = (BLOCKS - DATA) / CLUSTER_BLOCKS,
+                   CLUSTER_BYTES = CLUSTER_BLOCKS * 512;
+
+static std::vector<uint8_t> img(BLOCKS * 512UL);
+
+static inline uint8_t* block_data(const uint32_t b) { return &img[b * 512UL]; }
+static inline uint8_t* cluster_data(const uint32_t c) { return block_data(DATA + (c - 2) * CLUSTER_BLOCKS); }
+static inline uint16_t fat_get(const uint32_t c, const uint32_t fat=FAT1) { return ((uint16_t*)block_data(fat))[c]; }
+static inline void fat_set(const uint32_t c, const uint16_t v) { ((uint16_t*)block_data(FAT1))[c] = ((uint16_t*)block_data(FAT2))[c] = v; }
+static inline dir_t* root_entry(const uint16_t i) { return (dir_t*)block_data(ROOT) + i; }
+
+static void format() {
+  std::fill(img.begin(), img.end(), 0);
+  fat_boot_t &b = *(fat_boot_t*)block_data(0);
+  memcpy(b.jump, "\xEB\x3C\x90", 3);
+  memcpy(b.oemId, "MARLIN  ", 8);
+  b.bytesPerSector = 512;
+  b.sectorsPerCluster = CLUSTER_BLOCKS;
+  b.reservedSectorCount = FAT1;
+  b.fatCount = 2;
+  b.rootDirEntryCount = ROOT_ENTRIES;
+  b.mediaType = 0xF8;
+  b.sectorsPerFat16 = FAT_BLOCKS;
+  b.totalSectors32 = BLOCKS;
+  b.bootSignature = 0x29;
+  b.bootSectorSig0 = 0x55;
+  b.bootSectorSig1 = 0xAA;
+  fat_set(0, 0xFFF8);
+  fat_set(1, 0xFFFF);
+}
+
+// "NAME.EXT" as it's stored in a directory entry
+static std::string dos_name(const char * const name) {
+  std::string n(11, ' ');
+  const char * const dot = strchr(name, '.');
+  for (int i = 0; name + i < (dot ?: name + strlen(name)); i++) n[i] = name[i];
+  if (dot) for (int i = 0; dot[i + 1]; i++) n[8 + i] = dot[i + 1];
+  return n;
+}
+
+// Put a file on the card in the given clusters
+static void add_file(const char * const name, const std::string &data, const std::vector<uint32_t> &clusters) {
+  for (size_t i = 0; i < clusters.size(); i++) {
+    const size_t at = i * CLUSTER_BYTES;
+    if (at < data.size()) memcpy(cluster_data(clusters[i]), &data[at], _MIN(CLUSTER_BYTES, data.size() - at));
+    fat_set(clusters[i], i + 1 < clusters.size() ? clusters[i + 1] : 0xFFFF);
+  }
+  uint16_t i = 0;
+  while (root_entry(i)->name[0]) i++;
+  dir_t &d = *root_entry(i);
+  memcpy(d.name, dos_name(name).c_str(), 11);
+  d.attributes = DIR_ATT_ARCHIVE;
+  d.firstClusterLow = clusters.empty() ? 0 : clusters[0];
+  d.fileSize = data.size();
+}
+
+// A file as found by following its FAT chain, or "?" if it isn't there
+static std::string image_file(const char * const name, std::vector<uint32_t> *clusters=nullptr) {
+  const std::string n = dos_name(name);
+  for (uint16_t i = 0; i < ROOT_ENTRIES && root_entry(i)->name[0]; i++) {
+    const dir_t &d = *root_entry(i);
+    if (d.name[0] == DIR_NAME_DELETED || memcmp(d.name, n.c_str(), 11)) continue;
+    std::string data;
+    uint32_t c = d.firstClusterLow;
+    while (data.size() < d.fileSize) {
+      if (c < 2 || c >= CLUSTERS + 2) return "? bad cluster";
+      if (clusters) clusters->push_back(c);
+      data.append((const char*)cluster_data(c), _MIN(CLUSTER_BYTES, d.fileSize - data.size()));
+      c = fat_get(c);
+    }
+    if (d.fileSize && c < 0xFFF8) return "? chain runs past the end of the file";
+    return data;
+  }
+  return "? missing";
+}
+
+// The FATs agree, and every cluster in use belongs to exactly one file
+static void check_fat() {
+  CHECK(!memcmp(block_data(FAT1), block_data(FAT2), FAT_BLOCKS * 512), "FAT mirrors differ");
+  std::vector<uint8_t> owner(CLUSTERS + 2);
+  uint32_t owned = 0;
+  for (uint16_t i = 0; i < ROOT_ENTRIES && root_entry(i)->name[0]; i++) {
+    const dir_t &d = *root_entry(i);
+    if (d.name[0] == DIR_NAME_DELETED) continue;
+    std::vector<uint32_t> clusters;
+    char name[13];
+    sprintf(name, "%.8s.%.3s", (const char*)d.name, (const char*)d.name + 8);
+    image_file(name, &clusters);
+    for (const uint32_t c : clusters) {
+      CHECK(!owner[c]++, "cluster %u is in two files", c);
+      owned++;
+    }
+  }
+  uint32_t used = 0;
+  for (uint32_t c = 2; c < CLUSTERS + 2; c++) if (fat_get(c)) used++;
+  CHECK(used == owned, "%u clusters in use, %u in files", used, owned);
+}
+
+//
+// The card. Checks the command sequence, counts commands, and scrambles
+// pre-erased blocks that a multi-block write didn't reach.
+//
+static struct {
+  uint32_t cmd17, cmd18, cmd24, cmd25, read_blocks, write_blocks, erased;
+} stats;
+
+static enum { CARD_IDLE, CARD_READING, CARD_WRITING } card_state;
+static uint32_t card_next, card_erase_end;
+
+bool Sd2Card::readBlock(uint32_t block, uint8_t* dst) {
+  CHECK(card_state == CARD_IDLE && block < BLOCKS, "CMD17 %u in state %d", block, card_state);
+  stats.cmd17++;
+  stats.read_blocks++;
+  memcpy(dst, block_data(block), 512);
+  return true;
+}
+
+bool Sd2Card::readStart(uint32_t block) {
+  CHECK(card_state == CARD_IDLE, "CMD18 %u in state %d", block, card_state);
+  stats.cmd18++;
+  card_state = CARD_READING;
+  card_next = block;
+  return true;
+}
+
+bool Sd2Card::readData(uint8_t* dst) {
+  CHECK(card_state == CARD_READING && card_next < BLOCKS, "read data %u in state %d", card_next, card_state);
+  stats.read_blocks++;
+  memcpy(dst, block_data(card_next++), 512);
+  return true;
+}
+
+bool Sd2Card::readStop() {
+  CHECK(card_state == CARD_READING, "CMD12 in state %d", card_state);
+  card_state = CARD_IDLE;
+  return true;
+}
+
+bool Sd2Card::writeBlock(uint32_t block, const uint8_t* src) {
+  CHECK(card_state == CARD_IDLE && block < BLOCKS, "CMD24 %u in state %d", block, card_state);
+  stats.cmd24++;
+  stats.write_blocks++;
+  memcpy(block_data(block), src, 512);
+  return true;
+}
+
+bool Sd2Card::writeStart(uint32_t block, const uint32_t eraseCount) {
+  CHECK(card_state == CARD_IDLE && eraseCount, "CMD25 %u, ACMD23 %u in state %d", block, eraseCount, card_state);
+  stats.cmd25++;
+  stats.erased += eraseCount;
+  card_state = CARD_WRITING;
+  card_next = block;
+  card_erase_end = block + eraseCount;
+  return true;
+}
+
+bool Sd2Card::writeData(const uint8_t* src) {
+  CHECK(card_state == CARD_WRITING && card_next < BLOCKS, "write data %u in state %d", card_next, card_state);
+  stats.write_blocks++;
+  memcpy(block_data(card_next++), src, 512);
+  return true;
+}
+
+bool Sd2Card::writeStop() {
+  CHECK(card_state == CARD_WRITING, "stop tran in state %d", card_state);
+  card_state = CARD_IDLE;
+  for (uint32_t b = card_next; b < _MIN(card_erase_end, BLOCKS); b++) memset(block_data(b), 0xE5, 512);
+  return true;
+}
+
+//
+// Workloads
+//
+static std::string gcode_text(const uint32_t bytes, const uint32_t seed) {
+  std::string s;
+  char line[64];
+  srand(seed);
+  while (s.size() < bytes) {
+    sprintf(line, "G1 X%d.%03d Y%d.%03d E%d.%05d\n", rand() % 220, rand() % 1000, rand() % 220, rand() % 1000, rand() % 3, rand() % 100000);
+    s += line;
+  }
+  s.resize(bytes);
+  return s;
+}
+
+static std::chrono::steady_clock::time_point started;
+
+static void start(const bool cold=true) {
+  stats = {};
+  if (cold) {                         // Mount again, with an empty cache
+    card.volume.init(&card.sd2card);
+    card.root.openRoot(&card.volume);
+  }
+  started = std::chrono::steady_clock::now();
+}
+
+static void report(const char * const what, const uint32_t bytes=0) {
+  const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+  printf("  %-7s reads: %5u CMD17 %4u CMD18 %6u blocks   writes: %5u CMD24 %4u CMD25 %6u blocks %6u pre-erased",
+         what, stats.cmd17, stats.cmd18, stats.read_blocks, stats.cmd24, stats.cmd25, stats.write_blocks, stats.erased);
+  if (bytes) printf("   %.1f MB/s (host)", bytes / s / 1e6);
+  printf("\n");
+}
+
+// The file menu reads the folder from the start for each item it shows
+static constexpr int MENU_FILES = 60;
+static void test_menu() {
+  start();
+  for (int item = 0; item < MENU_FILES; item++) {
+    card.root.rewind();
+    dir_t d;
+    char name[13];
+    sprintf(name, "MENU%02d  GCO", item);
+    for (;;) {
+      const int8_t r = card.root.readDir(&d, nullptr);
+      if (r <= 0) { CHECK(false, "%s not found", name); break; }
+      if (!memcmp(d.name, name, 11)) break;
+    }
+  }
+  report("menu");
+}
+
+static void test_seek(const std::string &frag) {
+  start();
+  SdFile f;
+  CHECK(f.open(&card.root, "FRAG.GCO", O_READ), "open FRAG.GCO");
+  srand(5);
+  char buf[32];
+  for (int i = 0; i < 500; i++) {
+    const uint32_t pos = rand() % (frag.size() - sizeof(buf));
+    CHECK(f.seekSet(pos) && f.read(buf, sizeof(buf)) == sizeof(buf) && !memcmp(buf, &frag[pos], sizeof(buf)), "seek to %u", pos);
+  }
+  f.close();
+  report("seek");
+}
+
+static void test_print(const std::string &print) {
+  start();
+  CHECK(card.file.open(&card.root, "PRINT.GCO", O_READ), "open PRINT.GCO");
+  card.filesize = card.file.fileSize();
+  card.setIndex(0);
+  std::string got;
+  got.reserve(print.size());
+  for (int16_t c; (c = card.get()) >= 0;) got += char(c);
+  CHECK(got == print, "printed %u of %u bytes, differing at %u", uint32_t(got.size()), uint32_t(print.size()),
+        uint32_t(std::mismatch(got.begin(), got.end(), print.begin()).first - got.begin()));
+  card.file.close();
+  report("print", print.size());
+}
+
+// An upload, saving a power-loss record now and then as a print would
+static void test_upload(const char * const name, const std::string &data, const uint16_t chunk, const uint32_t plr_every) {
+  start();
+  SdFile f, plr;
+  CHECK(f.open(&card.root, name, O_CREAT | O_WRITE | O_TRUNC), "create %s", name);
+  std::string record;
+  uint32_t next_plr = plr_every;
+  for (uint32_t at = 0; at < data.size();) {
+    // M28 writes a line at a time, binary transfer whole packets
+    uint16_t n = chunk;
+    if (!n) n = strchr(&data[at], '\n') - &data[at] + 1;
+    n = _MIN(n, data.size() - at);
+    CHECK(f.write(&data[at], n) == n, "write at %u", at);
+    at += n;
+    if (at >= next_plr) {
+      next_plr += plr_every;
+      record = gcode_text(600, at);
+      CHECK(plr.open(&card.root, "PLR.BIN", O_CREAT | O_WRITE | O_TRUNC | O_SYNC), "open PLR.BIN");
+      plr.seekSet(0);
+      CHECK(plr.write(record.data(), record.size()) == int16_t(record.size()), "write PLR.BIN");
+      CHECK(plr.close(), "close PLR.BIN");
+    }
+  }
+  CHECK(f.close(), "close %s", name);
+  report(chunk ? "binary" : "M28", data.size());
+
+  const std::string got = image_file(name);
+  CHECK(got == data, "%s read back %s", name, got[0] == '?' ? got.c_str() : "different");
+  CHECK(image_file("PLR.BIN") == record, "PLR.BIN differs");
+}
+
+// Rewrite part of a file in place, block by block
+static void test_rewrite(std::string &index) {
+  start(false);                       // Still mounted since the upload
+  SdFile f;
+  CHECK(f.open(&card.root, "INDEX.BIN", O_WRITE), "open INDEX.BIN");
+  const std::string part = gcode_text(3 * 512, 300);
+  CHECK(f.seekSet(4096) && f.write(part.data(), part.size()) == int16_t(part.size()), "rewrite INDEX.BIN");
+  CHECK(f.close(), "close INDEX.BIN");
+  index.replace(4096, part.size(), part);
+  report("rewrite");
+  CHECK(image_file("INDEX.BIN") == index, "INDEX.BIN differs");
+}
+
+int main() {
+  // Files for the menu, one fragmented by another, and one contiguous
+  format();
+  uint32_t c = 2;
+  for (int i = 0; i < MENU_FILES; i++) {
+    char name[13];
+    sprintf(name, "MENU%02d.GCO", i);
+    add_file(name, gcode_text(1000, i), { c++ });
+  }
+  const std::string frag = gcode_text(512 * 1024, 100), fill = gcode_text(512 * 1024, 101),
+                    print = gcode_text(2 * 1024 * 1024, 102);
+  std::string index = gcode_text(64 * 1024, 103);
+  std::vector<uint32_t> frag_clusters, fill_clusters, print_clusters, index_clusters;
+  for (uint32_t i = 0; i < 512 * 1024 / CLUSTER_BYTES; i++) { frag_clusters.push_back(c++); fill_clusters.push_back(c++); }
+  for (uint32_t i = 0; i < 2 * 1024 * 1024 / CLUSTER_BYTES; i++) print_clusters.push_back(c++);
+  for (uint32_t i = 0; i < 64 * 1024 / CLUSTER_BYTES; i++) index_clusters.push_back(c++);
+  add_file("FRAG.GCO", frag, frag_clusters);
+  add_file("FILL.BIN", fill, fill_clusters);
+  add_file("PRINT.GCO", print, print_clusters);
+  add_file("INDEX.BIN", index, index_clusters);
+  check_fat();
+
+  test_menu();
+  test_seek(frag);
+  test_print(print);
+  test_upload("UPLOAD.GCO", gcode_text(1024 * 1024, 200), 0, 64 * 1024);
+  test_upload("BINARY.GCO", gcode_text(1024 * 1024, 201), 512, 64 * 1024);
+  test_rewrite(index);
+
+  // Nothing else was touched
+  CHECK(image_file("FRAG.GCO") == frag, "FRAG.GCO changed");
+  CHECK(image_file("FILL.BIN") == fill, "FILL.BIN changed");
+  CHECK(image_file("PRINT.GCO") == print, "PRINT.GCO changed");
+  for (int i = 0; i < MENU_FILES; i++) {
+    char name[13];
+    sprintf(name, "MENU%02d.GCO", i);
+    CHECK(image_file(name) == gcode_text(1000, i), "%s changed", name);
+  }
+  check_fat();
+
+  printf("%s\n", failures ? "FAILED" : "passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * Host test stubs - Arduino.h
+ *
+ * Just enough of the Arduino STM32F1 (libmaple) core for Marlin to build
+ * on the host. Functions are declared here and defined in stubs.cpp.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef int8_t int8;
+typedef int16_t int16;
+typedef int32_t int32;
+typedef bool boolean;
+typedef unsigned int word;
+typedef void (*voidFuncPtr)(void);
+
+// No separate program memory
+#define PROGMEM
+#define PSTR(s) (s)
+#define PGM_P const char*
+#define pgm_read_byte(p)  (*(const uint8_t*)(p))
+#define pgm_read_word(p)  (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define pgm_read_float(p) (*(const float*)(p))
+#define pgm_read_ptr(p)   (*(void* const*)(p))
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcasecmp_P strcasecmp
+#define strcat_P strcat
+#define strstr_P strstr
+#define strrchr_P strrchr
+#define memcpy_P memcpy
+#define sprintf_P sprintf
+
+// The ZONESTAR ZM3E4 MCU
+#define MCU_STM32F103VC 1
+#define STM32_HIGH_DENSITY 1
+#define BOARD_NR_GPIO_PINS 80
+#define BOARD_USB_DISC_DEV 0
+#define F_CPU 72000000
+#define CYCLES_PER_MICROSECOND 72
+#define SERIAL_USB
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define INPUT_ANALOG 4
+#define OUTPUT_OPEN_DRAIN 5
+#define PWM 6
+#define PWM_OPEN_DRAIN 7
+#define INPUT_FLOATING INPUT
+#define SERIAL_8N1 0
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+#define PI 3.1415926535897932384626433832795
+
+#define BIT(x) (1u << (x))
+#define lowByte(w) ((uint8_t)((w) & 0xFF))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+#define noInterrupts()
+#define interrupts()
+#define __disable_irq()
+#define __enable_irq()
+#define nvic_globalirq_disable()
+#define nvic_globalirq_enable()
+#define CLEAR_REG(x)
+#define bb_peri_set_bit(a,b,c)
+#define ISR(x) void x()
+inline uint32 __get_primask() { return 0; }
+inline uint32 __iCliRetVal() { return 0; }
+inline uint32 __iSeiRetVal() { return 0; }
+
+#include "libmaple/libmaple_types.h"
+#include "libmaple/gpio.h"
+#include "libmaple/timer.h"
+#include "libmaple/usart.h"
+#include "HardwareSerial.h"
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, int mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+uint16_t analogRead(uint8_t pin);
+void pwmWrite(uint8_t pin, uint16_t duty);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+inline long map(long x, long a, long b, long c, long d) { return (x - a) * (d - c) / (b - a) + c; }
+
+char* dtostrf(double val, signed char width, unsigned char prec, char *sout);
+char* ltoa(long val, char *s, int radix);
+char* ultoa(unsigned long val, char *s, int radix);
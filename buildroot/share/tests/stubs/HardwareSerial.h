@@ -0,0 +1,70 @@
+/**
+ * Host test stubs - HardwareSerial.h
+ *
+ * A serial port is a pair of strings. The test puts what the host sends
+ * in 'rx' and finds what Marlin sent in 'tx'. A test with a live host sets
+ * 'on_empty' to pass the lines on and fetch more when Marlin runs out.
+ */
+#pragma once
+
+#include <string>
+
+class Print {
+public:
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n) { size_t r = 0; while (n--) r += write(*buf++); return r; }
+  size_t write(const char *s) { return write((const uint8_t*)s, strlen(s)); }
+  virtual void flush() {}
+
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write(uint8_t(c)); }
+  size_t print(unsigned char n, int base=DEC) { return print((unsigned long long)n, base); }
+  size_t print(int n, int base=DEC) { return print((long long)n, base); }
+  size_t print(unsigned int n, int base=DEC) { return print((unsigned long long)n, base); }
+  size_t print(long n, int base=DEC) { return print((long long)n, base); }
+  size_t print(unsigned long n, int base=DEC) { return print((unsigned long long)n, base); }
+  size_t print(long long n, int base=DEC);
+  size_t print(unsigned long long n, int base=DEC);
+  size_t print(double n, int digits=2);
+
+  template<typename T> size_t println(const T v) { const size_t r = print(v); return r + println(); }
+  template<typename T> size_t println(const T v, int b) { const size_t r = print(v, b); return r + println(); }
+  size_t println() { return write("\r\n"); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+class HardwareSerial : public Stream {
+public:
+  std::string rx, tx;
+  size_t rx_pos = 0;
+  void (*on_empty)() = nullptr;
+
+  HardwareSerial(usart_dev *dev=nullptr, uint8 tx_pin=0, uint8 rx_pin=0) : dev(dev) { (void)tx_pin; (void)rx_pin; }
+  void begin(uint32 baud, uint8 config=SERIAL_8N1) { (void)baud; (void)config; }
+  void end() {}
+  int available() override { if (rx_pos == rx.size() && on_empty) on_empty(); return rx.size() - rx_pos; }
+  int peek() override { return rx_pos < rx.size() ? uint8_t(rx[rx_pos]) : -1; }
+  int read() override { return rx_pos < rx.size() ? uint8_t(rx[rx_pos++]) : -1; }
+  size_t write(uint8_t c) override { tx += char(c); return 1; }
+  using Print::write;
+  int availableForWrite() { return 64; }
+  usart_dev* c_dev() { return dev; }
+  operator bool() { return true; }
+
+  // Host side helpers
+  void send(const char *s) { rx.erase(0, rx_pos); rx_pos = 0; rx += s; }
+  std::string take() { std::string s; s.swap(tx); return s; }
+
+private:
+  usart_dev *dev;
+};
+
+class USBSerial : public HardwareSerial {};
+
+extern USBSerial Serial;
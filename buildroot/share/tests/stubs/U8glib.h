@@ -0,0 +1,53 @@
+/**
+ * Host test stubs - U8glib.h
+ *
+ * Declarations only. Tests don't draw, so nothing here is ever linked.
+ */
+#pragma once
+
+typedef uint8_t u8g_uint_t;
+typedef int8_t u8g_int_t;
+typedef uint8_t u8g_fntpgm_uint8_t;
+typedef uint8_t u8g_pgm_uint8_t;
+struct u8g_t { uint8_t mode; };
+struct u8g_dev_t { uint8_t dummy; };
+
+#define U8G_PROGMEM
+#define U8G_MODE_BW 1
+#define U8G_PIN_NONE 255
+#define u8g_SetFont(u8g, font)
+
+class U8GLIB {
+public:
+  u8g_t u8g;
+  u8g_t* getU8g() { return &u8g; }
+  void begin();
+  void initDevice();
+  void firstPage();
+  uint8_t nextPage();
+  uint8_t getMode();
+  void setContrast(uint8_t);
+  void sleepOn();
+  void sleepOff();
+  void setRot90();
+  void setRot180();
+  void setRot270();
+  void setScale2x2();
+  void undoScale();
+  void setColorIndex(uint8_t);
+  void setFont(const void*);
+  void setPrintPos(int, int);
+  void drawStr(int, int, const char*);
+  void drawPixel(int, int);
+  void drawHLine(int, int, int);
+  void drawVLine(int, int, int);
+  void drawLine(int, int, int, int);
+  void drawBox(int, int, int, int);
+  void drawFrame(int, int, int, int);
+  void drawRBox(int, int, int, int, int);
+  void drawRFrame(int, int, int, int, int);
+  void drawDisc(int, int, int);
+  void drawCircle(int, int, int);
+  void drawTriangle(int, int, int, int, int, int);
+  void drawBitmapP(int, int, int, int, const void*);
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+// Registers of a port, in RAM so pin writes go nowhere
+struct gpio_reg_map { volatile uint32 CRL, CRH, IDR, ODR, BSRR, BRR, LCKR; };
+struct gpio_dev { gpio_reg_map *regs; };
+extern gpio_dev gpioa, gpiob, gpioc, gpiod, gpioe;
+
+typedef enum gpio_pin_mode {
+  GPIO_OUTPUT_PP, GPIO_OUTPUT_OD, GPIO_AF_OUTPUT_PP, GPIO_AF_OUTPUT_OD,
+  GPIO_INPUT_ANALOG, GPIO_INPUT_FLOATING, GPIO_INPUT_PD, GPIO_INPUT_PU
+} gpio_pin_mode;
+
+struct timer_dev;
+struct adc_dev;
+struct stm32_pin_info {
+  gpio_dev *gpio_device;
+  timer_dev *timer_device;
+  const adc_dev *adc_device;
+  uint8 gpio_bit, timer_channel, adc_channel;
+};
+extern const stm32_pin_info PIN_MAP[];
+
+void gpio_set_mode(gpio_dev *dev, uint8 bit, gpio_pin_mode mode);
+gpio_pin_mode gpio_get_mode(gpio_dev *dev, uint8 bit);
+void gpio_write_bit(gpio_dev *dev, uint8 bit, uint8 val);
+uint32 gpio_read_bit(gpio_dev *dev, uint8 bit);
+void gpio_toggle_bit(gpio_dev *dev, uint8 bit);
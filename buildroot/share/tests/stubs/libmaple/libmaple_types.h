@@ -0,0 +1,2 @@
+#pragma once
+#define __always_inline inline __attribute__((always_inline))
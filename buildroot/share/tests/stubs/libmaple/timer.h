@@ -0,0 +1,30 @@
+#pragma once
+
+struct timer_reg_map { volatile uint32 CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR, CCR1, CCR2, CCR3, CCR4; };
+struct timer_dev { struct { timer_reg_map *adv, *gen, *bas; } regs; };
+
+enum timer_channel { TIMER_CH1 = 1, TIMER_CH2, TIMER_CH3, TIMER_CH4 };
+enum timer_mode { TIMER_DISABLED, TIMER_PWM, TIMER_OUTPUT_COMPARE };
+#define TIMER_CR1_ARPE_BIT 7
+#define TIMER_DIER_CC1IE_BIT 1
+#define TIMER_SR_CC1IF_BIT 1
+#define TIMER_CC1_INTERRUPT 1
+#define TIMER_UPDATE_INTERRUPT 0
+
+timer_dev* get_timer_dev(int number);
+uint16 timer_get_count(timer_dev *dev);
+void timer_set_count(timer_dev *dev, uint16 value);
+void timer_set_reload(timer_dev *dev, uint16 arr);
+void timer_set_compare(timer_dev *dev, uint8 channel, uint16 value);
+uint16 timer_get_compare(timer_dev *dev, uint8 channel);
+void timer_set_prescaler(timer_dev *dev, uint16 psc);
+void timer_generate_update(timer_dev *dev);
+void timer_pause(timer_dev *dev);
+void timer_resume(timer_dev *dev);
+void timer_set_mode(timer_dev *dev, uint8 channel, timer_mode mode);
+void timer_enable_irq(timer_dev *dev, uint8 interrupt);
+void timer_disable_irq(timer_dev *dev, uint8 interrupt);
+void timer_attach_interrupt(timer_dev *dev, uint8 interrupt, voidFuncPtr handler);
+
+typedef int nvic_irq_num;
+void nvic_irq_set_priority(nvic_irq_num irqn, uint8 priority);
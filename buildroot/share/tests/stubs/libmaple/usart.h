@@ -0,0 +1,17 @@
+#pragma once
+
+struct ring_buffer { volatile uint8 *buf; uint16 head, tail, size; };
+struct usart_reg_map { volatile uint32 SR, DR, BRR, CR1, CR2, CR3, GTPR; };
+struct usart_dev { usart_reg_map *regs; ring_buffer *rb, *wb; uint32 max_baud; int irq_num; };
+extern usart_dev *USART1, *USART2, *USART3, *UART4, *UART5;
+
+#define BOARD_USART1_TX_PIN 0
+#define BOARD_USART1_RX_PIN 0
+#define BOARD_USART2_TX_PIN 0
+#define BOARD_USART2_RX_PIN 0
+#define BOARD_USART3_TX_PIN 0
+#define BOARD_USART3_RX_PIN 0
+#define BOARD_UART4_TX_PIN 0
+#define BOARD_UART4_RX_PIN 0
+#define BOARD_UART5_TX_PIN 0
+#define BOARD_UART5_RX_PIN 0
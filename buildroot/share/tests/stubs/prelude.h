@@ -0,0 +1,9 @@
+/**
+ * Host test stubs - prelude.h
+ *
+ * Included ahead of every file in a host test build, since Marlin code
+ * assumes the Arduino core is always there.
+ */
+#pragma once
+
+#include "Arduino.h"
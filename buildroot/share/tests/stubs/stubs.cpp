@@ -0,0 +1,118 @@
+/**
+ * Host test stubs - stubs.cpp
+ *
+ * Bodies for the core functions declared in the stub headers, and the
+ * serial ports of the board. Time only moves when a test calls delay().
+ */
+#include "inc/MarlinConfig.h"   // of the tree under test
+#include "MarlinCore.h"
+#include "HAL/STM32F1/MarlinSerial.h"
+
+USBSerial Serial;
+
+static usart_dev usart_devs[5];
+usart_dev *USART1 = &usart_devs[0], *USART2 = &usart_devs[1], *USART3 = &usart_devs[2],
+          *UART4 = &usart_devs[3], *UART5 = &usart_devs[4];
+
+static gpio_reg_map gpio_regs[5];
+gpio_dev gpioa = { &gpio_regs[0] }, gpiob = { &gpio_regs[1] }, gpioc = { &gpio_regs[2] },
+         gpiod = { &gpio_regs[3] }, gpioe = { &gpio_regs[4] };
+
+static timer_reg_map timer_regs[8];
+static timer_dev timers[8];
+timer_dev* get_timer_dev(int number) {
+  timer_dev &t = timers[(number - 1) & 7];
+  t.regs.adv = t.regs.gen = t.regs.bas = &timer_regs[(number - 1) & 7];
+  return &t;
+}
+
+static uint32_t host_ms;
+uint32_t millis() { return host_ms; }
+uint32_t micros() { return host_ms * 1000UL; }
+void delay(uint32_t ms) { host_ms += ms; }
+void delayMicroseconds(uint32_t) {}
+
+void pinMode(uint8_t, int) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return LOW; }
+void analogWrite(uint8_t, int) {}
+uint16_t analogRead(uint8_t) { return 0; }
+void pwmWrite(uint8_t, uint16_t) {}
+
+long random(long howbig) { return howbig ? rand() % howbig : 0; }
+long random(long howsmall, long howbig) { return howsmall + random(howbig - howsmall); }
+void randomSeed(unsigned long seed) { srand(seed); }
+
+char* dtostrf(double val, signed char width, unsigned char prec, char *sout) {
+  sprintf(sout, "%*.*f", width, prec, val);
+  return sout;
+}
+char* ltoa(long val, char *s, int radix) {
+  if (radix == 10) sprintf(s, "%ld", val); else ultoa((unsigned long)val, s, radix);
+  return s;
+}
+char* ultoa(unsigned long val, char *s, int radix) {
+  char buf[8 * sizeof(long) + 1], *p = buf + sizeof(buf) - 1;
+  *p = '\0';
+  do { *--p = "0123456789abcdef"[val % radix]; val /= radix; } while (val);
+  return strcpy(s, p);
+}
+
+size_t Print::print(long long n, int base) {
+  if (base == 10 && n < 0) return print('-') + print((unsigned long long)-n, base);
+  return print((unsigned long long)n, base);
+}
+size_t Print::print(unsigned long long n, int base) {
+  if (base == 0) return write(uint8_t(n));
+  char buf[8 * sizeof(n) + 1], *p = buf + sizeof(buf) - 1;
+  *p = '\0';
+  do { *--p = "0123456789ABCDEF"[n % base]; n /= base; } while (n);
+  return write(p);
+}
+size_t Print::print(double n, int digits) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return write(buf);
+}
+
+// The UARTs of the board, as in HAL/STM32F1/MarlinSerial.cpp
+#if ENABLED(SERIAL_DMA)
+  #define UART_SERIAL(n, DEV) MarlinSerial MSerial##n(DEV, 0, 0, true, nullptr);
+#else
+  #define UART_SERIAL(n, DEV) MarlinSerial MSerial##n(DEV, 0, 0, true);
+#endif
+
+UART_SERIAL(1, USART1)
+UART_SERIAL(2, USART2)
+UART_SERIAL(3, USART3)
+#if EITHER(STM32_HIGH_DENSITY, STM32_XL_DENSITY)
+  UART_SERIAL(4, UART4)
+  UART_SERIAL(5, UART5)
+#endif
+
+// The common strings of MarlinCore.cpp
+PGMSTR(NUL_STR, "");
+PGMSTR(M112_KILL_STR, "M112 Shutdown");
+PGMSTR(G28_STR, "G28");
+PGMSTR(M21_STR, "M21");
+PGMSTR(M23_STR, "M23 %s");
+PGMSTR(M24_STR, "M24");
+PGMSTR(SP_P_STR, " P");  PGMSTR(SP_T_STR, " T");
+PGMSTR(X_STR,     "X");  PGMSTR(Y_STR,     "Y");  PGMSTR(Z_STR,     "Z");  PGMSTR(E_STR,     "E");
+PGMSTR(X_LBL,     "X:"); PGMSTR(Y_LBL,     "Y:"); PGMSTR(Z_LBL,     "Z:"); PGMSTR(E_LBL,     "E:");
+PGMSTR(SP_A_STR, " A");  PGMSTR(SP_B_STR, " B");  PGMSTR(SP_C_STR, " C");
+PGMSTR(SP_X_STR, " X");  PGMSTR(SP_Y_STR, " Y");  PGMSTR(SP_Z_STR, " Z");  PGMSTR(SP_E_STR, " E");
+PGMSTR(SP_X_LBL, " X:"); PGMSTR(SP_Y_LBL, " Y:"); PGMSTR(SP_Z_LBL, " Z:"); PGMSTR(SP_E_LBL, " E:");
+
+// The state of MarlinCore.cpp. A kill ends the test.
+MarlinState marlin_state = MF_RUNNING;
+bool wait_for_heatup = true;
+#if HAS_RESUME_CONTINUE
+  bool wait_for_user; // = false;
+#endif
+
+void kill(PGM_P const lcd_error/*=nullptr*/, PGM_P const lcd_component/*=nullptr*/, const bool/*=false*/) {
+  printf("kill: %s %s\n", lcd_error ?: "", lcd_component ?: "");
+  exit(2);
+}
+void quickstop_stepper() {}